@@ -0,0 +1,219 @@
+#include "ArbolCliques.h"
+#include "OrdenEliminacion.h"
+#include <algorithm>
+#include <numeric>
+
+/**
+ * Compila el árbol de cliques
+ * 1. Moraliza: conecta cada nodo con sus padres y a los padres entre sí
+ * 2. Triangula eliminando variables por mínimo relleno; cada eliminación
+ *    genera el clique {variable} ∪ vecinos
+ * 3. Conserva los cliques maximales y los une por separadores máximos
+ * 4. Asigna cada tabla a un clique que contenga todas sus variables
+ */
+ArbolCliques::ArbolCliques(const std::vector<Factor>& factores, const std::vector<int>& cards)
+    : cardinalidades(cards) {
+    size_t n = cardinalidades.size();
+
+    // Triangulación por mínimo relleno sobre el grafo moral (desempate por
+    // tamaño del clique); cada eliminación genera el clique {variable} ∪ vecinos
+    std::vector<std::vector<int>> alcances;
+    for (const auto& factor : factores) {
+        alcances.emplace_back(factor.getVariables().begin(), factor.getVariables().end());
+    }
+    std::vector<int> variables(n);
+    std::iota(variables.begin(), variables.end(), 0);
+    OrdenEliminacion triangulacion(alcances, variables, cardinalidades, HeuristicaOrden::RELLENO_MINIMO);
+    const std::vector<std::vector<int>>& candidatos = triangulacion.getCliques();
+
+    // Conservar solo los cliques maximales
+    for (size_t i = 0; i < candidatos.size(); i++) {
+        bool maximal = true;
+        for (size_t j = 0; j < candidatos.size() && maximal; j++) {
+            if (i == j || candidatos[j].size() < candidatos[i].size()) continue;
+            bool contenido = std::includes(candidatos[j].begin(), candidatos[j].end(),
+                                           candidatos[i].begin(), candidatos[i].end());
+            // Entre cliques idénticos se conserva el primero
+            if (contenido && (candidatos[j].size() > candidatos[i].size() || j < i)) {
+                maximal = false;
+            }
+        }
+        if (maximal) cliques.push_back(candidatos[i]);
+    }
+
+    // Árbol de expansión máxima sobre el tamaño de los separadores (Kruskal)
+    size_t k = cliques.size();
+    struct Arista { size_t peso; int a; int b; };
+    std::vector<Arista> aristas;
+    for (size_t a = 0; a < k; a++) {
+        for (size_t b = a + 1; b < k; b++) {
+            std::vector<int> comun;
+            std::set_intersection(cliques[a].begin(), cliques[a].end(),
+                                  cliques[b].begin(), cliques[b].end(),
+                                  std::back_inserter(comun));
+            if (!comun.empty()) {
+                aristas.push_back({comun.size(), static_cast<int>(a), static_cast<int>(b)});
+            }
+        }
+    }
+    std::stable_sort(aristas.begin(), aristas.end(),
+                     [](const Arista& x, const Arista& y) { return x.peso > y.peso; });
+
+    std::vector<int> grupo(k);
+    std::iota(grupo.begin(), grupo.end(), 0);
+    auto raiz = [&](int c) {
+        while (grupo[c] != c) c = grupo[c] = grupo[grupo[c]];
+        return c;
+    };
+    std::vector<std::vector<int>> adyacentes(k);
+    for (const auto& arista : aristas) {
+        int ra = raiz(arista.a), rb = raiz(arista.b);
+        if (ra == rb) continue;
+        grupo[ra] = rb;
+        adyacentes[arista.a].push_back(arista.b);
+        adyacentes[arista.b].push_back(arista.a);
+    }
+
+    // Orientar cada componente desde una raíz (recorrido en profundidad)
+    padre.assign(k, -1);
+    hijos.assign(k, std::vector<int>());
+    separadores.assign(k, std::vector<int>());
+    std::vector<bool> visitado(k, false);
+    for (size_t r = 0; r < k; r++) {
+        if (visitado[r]) continue;
+        std::vector<int> pila(1, static_cast<int>(r));
+        visitado[r] = true;
+        while (!pila.empty()) {
+            int c = pila.back();
+            pila.pop_back();
+            ordenRecorrido.push_back(c);
+            for (int h : adyacentes[c]) {
+                if (visitado[h]) continue;
+                visitado[h] = true;
+                padre[h] = c;
+                hijos[c].push_back(h);
+                std::set_intersection(cliques[c].begin(), cliques[c].end(),
+                                      cliques[h].begin(), cliques[h].end(),
+                                      std::back_inserter(separadores[h]));
+                pila.push_back(h);
+            }
+        }
+    }
+
+    // Potenciales: producto de las tablas asignadas a cada clique
+    for (size_t c = 0; c < k; c++) {
+        std::vector<int> cardsClique;
+        for (int v : cliques[c]) cardsClique.push_back(cardinalidades[v]);
+        Factor potencial(cliques[c], cardsClique);
+        for (size_t i = 0; i < potencial.tamano(); i++) potencial[i] = 1.0;
+        potenciales.push_back(potencial);
+    }
+    for (const auto& factor : factores) {
+        const auto& vars = factor.getVariables();
+        int elegido = -1;
+        for (size_t c = 0; c < k; c++) {
+            if (std::includes(cliques[c].begin(), cliques[c].end(), vars.begin(), vars.end()) &&
+                (elegido < 0 || cliques[c].size() < cliques[elegido].size())) {
+                elegido = static_cast<int>(c);
+            }
+        }
+        potenciales[elegido] = potenciales[elegido].producto(factor);
+    }
+
+    // Clique más pequeño que contiene cada variable
+    cliqueDeVariable.assign(n, -1);
+    for (size_t c = 0; c < k; c++) {
+        for (int v : cliques[c]) {
+            int actual = cliqueDeVariable[v];
+            if (actual < 0 || cliques[c].size() < cliques[actual].size()) {
+                cliqueDeVariable[v] = static_cast<int>(c);
+            }
+        }
+    }
+}
+
+/**
+ * Propagación en dos pasadas
+ * Recolección: cada clique envía a su padre la marginal sobre el
+ * separador de su potencial por los mensajes de sus hijos
+ * Distribución: cada clique arma una sola vez su creencia (potencial por el
+ * mensaje del padre y los de todos sus hijos) y envía a cada hijo la
+ * marginal de la creencia sobre el separador dividida por el mensaje que
+ * ese hijo le envió; así el costo es lineal en el número de hijos
+ * Los mensajes y los productos parciales se normalizan para evitar
+ * desbordamiento por abajo (un clique con cientos de hijos multiplica
+ * cientos de mensajes menores que 1)
+ */
+std::vector<std::vector<double>> ArbolCliques::propagar(const std::map<int, int>& evidencia) const {
+    size_t k = cliques.size();
+
+    // Potenciales con la evidencia aplicada (las compiladas no cambian)
+    std::vector<Factor> base(potenciales);
+    for (const auto& obs : evidencia) {
+        base[cliqueDeVariable[obs.first]].fijarEvidencia(obs.first, obs.second);
+    }
+
+    // Recolección: de las hojas hacia la raíz
+    std::vector<Factor> haciaPadre(k);
+    for (size_t i = ordenRecorrido.size(); i-- > 0; ) {
+        int c = ordenRecorrido[i];
+        if (padre[c] < 0) continue;
+        Factor f = base[c];
+        for (int h : hijos[c]) {
+            f = f.producto(haciaPadre[h]);
+            f.normalizar();
+        }
+        haciaPadre[c] = f.marginal(separadores[c]);
+        haciaPadre[c].normalizar();
+    }
+
+    // Distribución: de la raíz hacia las hojas
+    std::vector<Factor> desdePadre(k);
+    std::vector<Factor> creencias(k);
+    for (int c : ordenRecorrido) {
+        Factor f = base[c];
+        if (padre[c] >= 0) f = f.producto(desdePadre[c]);
+        for (int h : hijos[c]) {
+            f = f.producto(haciaPadre[h]);
+            f.normalizar();
+        }
+        for (int h : hijos[c]) {
+            desdePadre[h] = f.marginal(separadores[h]);
+            desdePadre[h].dividir(haciaPadre[h]);
+            desdePadre[h].normalizar();
+        }
+        creencias[c] = std::move(f);
+    }
+
+    // Marginal de cada variable desde su clique más pequeño
+    std::vector<std::vector<double>> marginales(cardinalidades.size());
+    for (size_t v = 0; v < cardinalidades.size(); v++) {
+        int c = cliqueDeVariable[v];
+        if (c < 0) continue;
+        Factor m = creencias[c].marginal(std::vector<int>(1, static_cast<int>(v)));
+        m.normalizar();
+        for (size_t i = 0; i < m.tamano(); i++) {
+            marginales[v].push_back(m[i]);
+        }
+    }
+
+    return marginales;
+}
+
+/**
+ * Retorna el número de cliques
+ */
+size_t ArbolCliques::getNumeroCliques() const {
+    return cliques.size();
+}
+
+/**
+ * Retorna el tamaño del clique más grande
+ */
+size_t ArbolCliques::getTamanoMaximoClique() const {
+    size_t maximo = 0;
+    for (const auto& clique : cliques) {
+        maximo = std::max(maximo, clique.size());
+    }
+    return maximo;
+}
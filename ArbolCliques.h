@@ -0,0 +1,59 @@
+#ifndef ARBOL_CLIQUES_H
+#define ARBOL_CLIQUES_H
+
+#include "Factor.h"
+#include <vector>
+#include <map>
+
+/**
+ * Árbol de cliques (árbol de uniones) compilado a partir de los factores
+ * de una red bayesiana
+ *
+ * La compilación moraliza el grafo, lo triangula eliminando variables con
+ * la heurística de mínimo relleno, y une los cliques maximales con un árbol
+ * de expansión máxima sobre el tamaño de los separadores. Cada tabla de
+ * probabilidad se asigna a un clique que contiene todas sus variables.
+ *
+ * La propagación (recolección hacia la raíz y distribución hacia las hojas)
+ * calibra el árbol y entrega la marginal de todas las variables a la vez.
+ * Las potenciales compiladas no se modifican al propagar, por lo que una
+ * nueva evidencia solo requiere volver a propagar.
+ */
+class ArbolCliques {
+private:
+    std::vector<int> cardinalidades;             // Tamaño del dominio de cada variable
+    std::vector<std::vector<int>> cliques;       // Variables de cada clique (ordenadas)
+    std::vector<Factor> potenciales;             // Producto de las tablas asignadas
+    std::vector<int> padre;                      // Clique padre en el árbol (-1 en raíces)
+    std::vector<std::vector<int>> separadores;   // Variables compartidas con el padre
+    std::vector<int> ordenRecorrido;             // Orden en profundidad (padres antes que hijos)
+    std::vector<std::vector<int>> hijos;         // Cliques hijos de cada clique
+    std::vector<int> cliqueDeVariable;           // Clique más pequeño que contiene cada variable
+
+public:
+    /**
+     * Compila el árbol de cliques
+     * @param factores Un factor P(nodo | padres) por cada nodo de la red
+     * @param cards Cardinalidad de cada variable (por índice de variable)
+     */
+    ArbolCliques(const std::vector<Factor>& factores, const std::vector<int>& cards);
+
+    /**
+     * Propaga la evidencia y calcula todas las marginales
+     * @param evidencia Índice de variable -> índice de valor observado
+     * @return Para cada variable, su distribución P(variable | evidencia)
+     */
+    std::vector<std::vector<double>> propagar(const std::map<int, int>& evidencia) const;
+
+    /**
+     * Número de cliques del árbol
+     */
+    size_t getNumeroCliques() const;
+
+    /**
+     * Número de variables del clique más grande
+     */
+    size_t getTamanoMaximoClique() const;
+};
+
+#endif
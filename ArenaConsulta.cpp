@@ -0,0 +1,181 @@
+#include "ArenaConsulta.h"
+#include "EstadisticasInferencia.h"
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+/**
+ * Cabecera delante de cada reserva; ocupa una alineación completa para
+ * que los datos queden alineados
+ */
+struct alignas(alignof(std::max_align_t)) Cabecera {
+    bool deArena;
+};
+
+const size_t ALINEACION = alignof(std::max_align_t);
+
+size_t redondear(size_t bytes) {
+    return (bytes + ALINEACION - 1) / ALINEACION * ALINEACION;
+}
+
+// Arena activa en este hilo (nula fuera de una consulta)
+thread_local ArenaConsulta* activa = nullptr;
+
+}
+
+/**
+ * Constructor: sin bloques hasta la primera reserva
+ */
+ArenaConsulta::ArenaConsulta() : bloqueActual(0), usado(0), bytesConsulta(0), estadisticas() {}
+
+/**
+ * Destructor: devuelve los bloques al sistema
+ */
+ArenaConsulta::~ArenaConsulta() {
+    for (const Bloque& bloque : bloques) {
+        ::operator delete(bloque.datos);
+    }
+}
+
+/**
+ * Retorna la arena del hilo (se crea en el primer uso)
+ */
+ArenaConsulta& ArenaConsulta::delHilo() {
+    static thread_local ArenaConsulta arena;
+    return arena;
+}
+
+/**
+ * Avanza en el bloque actual; si no alcanza, pasa al siguiente bloque
+ * retenido o reserva uno nuevo del doble de tamaño (o del pedido)
+ */
+void* ArenaConsulta::tomar(size_t bytes) {
+    while (bloqueActual < bloques.size() && usado + bytes > bloques[bloqueActual].capacidad) {
+        bloqueActual++;
+        usado = 0;
+    }
+    if (bloqueActual == bloques.size()) {
+        size_t capacidad = bloques.empty() ? BLOQUE_INICIAL : 2 * bloques.back().capacidad;
+        capacidad = std::max(capacidad, bytes);
+        bloques.push_back({static_cast<char*>(::operator new(capacidad)), capacidad});
+        estadisticas.reservasSistema++;
+        estadisticas.capacidad += capacidad;
+        RB_CONTAR_RESERVAS(0, 1);
+        usado = 0;
+    }
+    void* puntero = bloques[bloqueActual].datos + usado;
+    usado += bytes;
+    bytesConsulta += bytes;
+    estadisticas.reservas++;
+    RB_CONTAR_RESERVAS(1, 0);
+    return puntero;
+}
+
+/**
+ * Reserva con cabecera: de la arena activa o del sistema
+ * Es el único punto por el que pasan las tablas de los factores y los
+ * vectores de trabajo, así que aquí se cuentan las reservas de la medición
+ */
+void* ArenaConsulta::reservar(size_t bytes) {
+    if (bytes > SIZE_MAX - 2 * ALINEACION) {
+        throw std::bad_alloc();
+    }
+    size_t total = redondear(bytes) + sizeof(Cabecera);
+    Cabecera* cabecera;
+    if (activa != nullptr && total <= RESERVA_MAXIMA) {
+        cabecera = static_cast<Cabecera*>(activa->tomar(total));
+        cabecera->deArena = true;
+    } else {
+        cabecera = static_cast<Cabecera*>(::operator new(total));
+        cabecera->deArena = false;
+        if (activa != nullptr) activa->estadisticas.reservasSistema++;
+        RB_CONTAR_RESERVAS(0, 1);
+    }
+    return cabecera + 1;
+}
+
+/**
+ * Solo la memoria del sistema se devuelve; la de la arena se recupera
+ * entera al cerrar el ámbito
+ */
+void ArenaConsulta::devolver(void* puntero) noexcept {
+    if (puntero == nullptr) return;
+    Cabecera* cabecera = static_cast<Cabecera*>(puntero) - 1;
+    if (!cabecera->deArena) {
+        ::operator delete(cabecera);
+    }
+}
+
+/**
+ * Registra la consulta y vuelve al inicio. Si se usó más de un bloque,
+ * se cambian todos por uno con la capacidad total (hasta CAPACIDAD_RETENIDA)
+ */
+void ArenaConsulta::liberar() {
+    estadisticas.consultas++;
+    estadisticas.bytesUltimaConsulta = bytesConsulta;
+    estadisticas.bytesMaximos = std::max(estadisticas.bytesMaximos, bytesConsulta);
+
+    if (bloques.size() > 1 || estadisticas.capacidad > CAPACIDAD_RETENIDA) {
+        size_t capacidad = std::min(estadisticas.capacidad, CAPACIDAD_RETENIDA);
+        for (const Bloque& bloque : bloques) {
+            ::operator delete(bloque.datos);
+        }
+        bloques.clear();
+        bloques.push_back({static_cast<char*>(::operator new(capacidad)), capacidad});
+        estadisticas.capacidad = capacidad;
+    }
+    bloqueActual = 0;
+    usado = 0;
+    bytesConsulta = 0;
+}
+
+/**
+ * Retorna la posición actual
+ */
+ArenaConsulta::Marca ArenaConsulta::marcar() const {
+    return Marca{bloqueActual, usado, bytesConsulta};
+}
+
+/**
+ * Vuelve a una posición anterior; los bloques posteriores se conservan
+ * para las reservas siguientes
+ */
+void ArenaConsulta::restaurar(const Marca& marca) {
+    bloqueActual = marca.bloque;
+    usado = marca.usado;
+    bytesConsulta = marca.bytesConsulta;
+}
+
+/**
+ * Retorna los contadores
+ */
+EstadisticasArena ArenaConsulta::getEstadisticas() const {
+    return estadisticas;
+}
+
+/**
+ * Pone los contadores en cero, conservando la capacidad
+ */
+void ArenaConsulta::reiniciarEstadisticas() {
+    size_t capacidad = estadisticas.capacidad;
+    estadisticas = EstadisticasArena();
+    estadisticas.capacidad = capacidad;
+}
+
+/**
+ * Activa la arena del hilo si no hay otra consulta en curso
+ */
+ArenaConsulta::Ambito::Ambito() : externo(activa == nullptr) {
+    if (externo) activa = &delHilo();
+}
+
+/**
+ * Libera la arena al cerrar el ámbito externo
+ */
+ArenaConsulta::Ambito::~Ambito() {
+    if (!externo) return;
+    activa->liberar();
+    activa = nullptr;
+}
@@ -0,0 +1,171 @@
+#ifndef ARENA_CONSULTA_H
+#define ARENA_CONSULTA_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Contadores de la arena de un hilo
+ */
+struct EstadisticasArena {
+    unsigned long long consultas;          // Ámbitos terminados (consultas que usaron la arena)
+    unsigned long long reservas;           // Pedidos servidos desde los bloques de la arena
+    unsigned long long reservasSistema;    // Pedidos al sistema durante una consulta (bloques
+                                           // nuevos y reservas grandes); 0 en régimen estable
+    size_t bytesUltimaConsulta;            // Bytes que usó la consulta más reciente
+    size_t bytesMaximos;                   // Máximo de bytes usados por una consulta
+    size_t capacidad;                      // Bytes de bloques retenidos entre consultas
+};
+
+/**
+ * Arena por hilo para la memoria de trabajo de una consulta
+ *
+ * Mientras hay un Ambito abierto en el hilo, todo lo que se reserva con
+ * AsignadorArena (tablas de factores, vectores de estado y de trabajo) se
+ * toma avanzando un puntero dentro de bloques ya reservados; devolver esa
+ * memoria no hace nada, y al cerrar el ámbito más externo la arena vuelve
+ * a empezar desde cero. Si una consulta necesitó más de un bloque, los
+ * bloques se reemplazan por uno solo con la capacidad total, así que las
+ * consultas siguientes del mismo tamaño no piden memoria al sistema.
+ *
+ * Cada reserva lleva una cabecera con su origen, de modo que un objeto
+ * creado fuera de un ámbito (memoria del sistema) puede destruirse dentro
+ * de uno, y viceversa en otro hilo. Lo reservado dentro de un ámbito no
+ * debe usarse después de cerrarlo. Las reservas mayores que RESERVA_MAXIMA
+ * van directo al sistema, para que una consulta con factores enormes no
+ * deje retenida esa memoria.
+ */
+class ArenaConsulta {
+public:
+    static constexpr size_t BLOQUE_INICIAL = 64 << 10;     // Primer bloque de cada hilo
+    static constexpr size_t RESERVA_MAXIMA = 4 << 20;      // Reservas más grandes van al sistema
+    static constexpr size_t CAPACIDAD_RETENIDA = 64 << 20; // Máximo retenido entre consultas
+
+private:
+    struct Bloque {
+        char* datos;
+        size_t capacidad;
+    };
+
+    std::vector<Bloque> bloques;
+    size_t bloqueActual;        // Bloque del que se está reservando
+    size_t usado;               // Bytes usados del bloque actual
+    size_t bytesConsulta;       // Bytes servidos en la consulta en curso
+    EstadisticasArena estadisticas;
+
+    ArenaConsulta();
+
+    /**
+     * Toma bytes (múltiplo de la alineación) de los bloques, agregando uno
+     * nuevo si no caben
+     */
+    void* tomar(size_t bytes);
+
+    /**
+     * Vuelve al inicio y deja un solo bloque con la capacidad usada
+     */
+    void liberar();
+
+public:
+    ~ArenaConsulta();
+
+    ArenaConsulta(const ArenaConsulta&) = delete;
+    ArenaConsulta& operator=(const ArenaConsulta&) = delete;
+
+    /**
+     * Arena del hilo actual
+     */
+    static ArenaConsulta& delHilo();
+
+    /**
+     * Reserva memoria: de la arena del hilo si hay un ámbito abierto, o
+     * del sistema si no. Alineada para cualquier tipo fundamental
+     */
+    static void* reservar(size_t bytes);
+
+    /**
+     * Devuelve memoria obtenida con reservar (no hace nada si es de la arena)
+     */
+    static void devolver(void* puntero) noexcept;
+
+    /**
+     * Posición actual de la arena (para volver a ella con restaurar)
+     */
+    struct Marca {
+        size_t bloque;
+        size_t usado;
+        size_t bytesConsulta;
+    };
+    Marca marcar() const;
+
+    /**
+     * Descarta lo reservado después de la marca; los objetos creados
+     * desde entonces ya deben estar destruidos
+     */
+    void restaurar(const Marca& marca);
+
+    /**
+     * Contadores de la arena de este hilo
+     */
+    EstadisticasArena getEstadisticas() const;
+
+    /**
+     * Pone los contadores en cero (la capacidad se conserva)
+     */
+    void reiniciarEstadisticas();
+
+    /**
+     * Ámbito de una consulta: activa la arena del hilo y al cerrarse la
+     * libera. Un ámbito abierto dentro de otro no hace nada, así que las
+     * llamadas anidadas comparten la arena de la consulta externa
+     */
+    class Ambito {
+    private:
+        bool externo;
+
+    public:
+        Ambito();
+        ~Ambito();
+
+        Ambito(const Ambito&) = delete;
+        Ambito& operator=(const Ambito&) = delete;
+    };
+};
+
+/**
+ * Asignador para contenedores estándar que toma la memoria de la arena de
+ * la consulta en curso (o del sistema fuera de una consulta)
+ * No tiene estado: dos asignadores siempre son intercambiables
+ */
+template <typename T>
+class AsignadorArena {
+public:
+    typedef T value_type;
+
+    AsignadorArena() noexcept {}
+
+    template <typename U>
+    AsignadorArena(const AsignadorArena<U>&) noexcept {}
+
+    T* allocate(size_t cantidad) {
+        return static_cast<T*>(ArenaConsulta::reservar(cantidad * sizeof(T)));
+    }
+
+    void deallocate(T* puntero, size_t) noexcept {
+        ArenaConsulta::devolver(puntero);
+    }
+
+    template <typename U>
+    bool operator==(const AsignadorArena<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AsignadorArena<U>&) const noexcept { return false; }
+};
+
+/**
+ * Vector cuya memoria viene de la arena de la consulta
+ */
+template <typename T>
+using VectorArena = std::vector<T, AsignadorArena<T>>;
+
+#endif
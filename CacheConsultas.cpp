@@ -0,0 +1,124 @@
+#include "CacheConsultas.h"
+
+/**
+ * Constructor
+ */
+CacheConsultas::CacheConsultas(size_t capacidadBytes)
+    : capacidad(capacidadBytes), bytes(0), aciertos(0), fallos(0), desalojos(0) {}
+
+/**
+ * Constructor de copia: caché vacía con la misma capacidad
+ */
+CacheConsultas::CacheConsultas(const CacheConsultas& otra)
+    : capacidad(otra.getEstadisticas().capacidad), bytes(0), aciertos(0), fallos(0), desalojos(0) {}
+
+/**
+ * Asignación: descarta el contenido y adopta la capacidad de la otra
+ */
+CacheConsultas& CacheConsultas::operator=(const CacheConsultas& otra) {
+    if (this != &otra) {
+        size_t nuevaCapacidad = otra.getEstadisticas().capacidad;
+        std::lock_guard<std::mutex> bloqueo(mutex);
+        usos.clear();
+        entradas.clear();
+        capacidad = nuevaCapacidad;
+        bytes = 0;
+        aciertos = 0;
+        fallos = 0;
+        desalojos = 0;
+    }
+    return *this;
+}
+
+/**
+ * Dos copias de la clave, el valor y los nodos de la lista y del índice
+ */
+size_t CacheConsultas::bytesEntrada(const std::string& clave) {
+    return 2 * (sizeof(std::string) + clave.size()) + sizeof(double) + 4 * sizeof(void*);
+}
+
+/**
+ * Descarta desde el final de la lista (uso más antiguo)
+ */
+void CacheConsultas::ajustarCapacidad() {
+    while (bytes > capacidad && !usos.empty()) {
+        const std::string& clave = usos.back().first;
+        bytes -= bytesEntrada(clave);
+        entradas.erase(clave);
+        usos.pop_back();
+        desalojos++;
+    }
+}
+
+/**
+ * Busca una consulta
+ */
+bool CacheConsultas::buscar(const std::string& clave, double& valor) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    if (capacidad == 0) return false;
+
+    auto it = entradas.find(clave);
+    if (it == entradas.end()) {
+        fallos++;
+        return false;
+    }
+    usos.splice(usos.begin(), usos, it->second);
+    valor = it->second->second;
+    aciertos++;
+    return true;
+}
+
+/**
+ * Guarda un resultado como el más reciente
+ */
+void CacheConsultas::guardar(const std::string& clave, double valor) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    if (capacidad == 0) return;
+
+    auto it = entradas.find(clave);
+    if (it != entradas.end()) {
+        it->second->second = valor;
+        usos.splice(usos.begin(), usos, it->second);
+        return;
+    }
+    if (bytesEntrada(clave) > capacidad) return;
+
+    usos.push_front(std::make_pair(clave, valor));
+    entradas[clave] = usos.begin();
+    bytes += bytesEntrada(clave);
+    ajustarCapacidad();
+}
+
+/**
+ * Descarta todas las entradas
+ */
+void CacheConsultas::limpiar() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    usos.clear();
+    entradas.clear();
+    bytes = 0;
+}
+
+/**
+ * Cambia el límite de memoria
+ */
+void CacheConsultas::setCapacidad(size_t capacidadBytes) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    capacidad = capacidadBytes;
+    ajustarCapacidad();
+}
+
+/**
+ * Contadores y ocupación actuales
+ */
+EstadisticasCache CacheConsultas::getEstadisticas() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    EstadisticasCache estadisticas;
+    estadisticas.aciertos = aciertos;
+    estadisticas.fallos = fallos;
+    estadisticas.desalojos = desalojos;
+    estadisticas.entradas = entradas.size();
+    estadisticas.bytes = bytes;
+    estadisticas.capacidad = capacidad;
+    return estadisticas;
+}
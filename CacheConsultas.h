@@ -0,0 +1,96 @@
+#ifndef CACHE_CONSULTAS_H
+#define CACHE_CONSULTAS_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstddef>
+
+/**
+ * Contadores y ocupación de la caché de consultas
+ */
+struct EstadisticasCache {
+    unsigned long long aciertos;    // Consultas respondidas desde la caché
+    unsigned long long fallos;      // Consultas que hubo que calcular
+    unsigned long long desalojos;   // Entradas descartadas por falta de espacio
+    size_t entradas;                // Entradas almacenadas
+    size_t bytes;                   // Memoria estimada en uso
+    size_t capacidad;               // Límite de memoria (0 = desactivada)
+};
+
+/**
+ * Caché LRU de resultados de inferencia
+ *
+ * Cada entrada asocia una clave canónica de la consulta con su probabilidad.
+ * Al superar el límite de memoria se descartan las entradas usadas hace más
+ * tiempo. Todas las operaciones están protegidas por un mutex, por lo que
+ * la caché puede usarse desde métodos const llamados en paralelo.
+ *
+ * Copiar una caché produce una caché vacía con la misma capacidad: los
+ * resultados pertenecen a la red que los calculó.
+ */
+class CacheConsultas {
+private:
+    typedef std::list<std::pair<std::string, double>> ListaUso;
+
+    ListaUso usos;                                                  // Más reciente al frente
+    std::unordered_map<std::string, ListaUso::iterator> entradas;
+    size_t capacidad;
+    size_t bytes;
+    unsigned long long aciertos;
+    unsigned long long fallos;
+    unsigned long long desalojos;
+    mutable std::mutex mutex;
+
+    /**
+     * Memoria estimada de una entrada (la clave se guarda en la lista y en el índice)
+     */
+    static size_t bytesEntrada(const std::string& clave);
+
+    /**
+     * Descarta entradas antiguas hasta respetar la capacidad
+     */
+    void ajustarCapacidad();
+
+public:
+    /**
+     * Constructor
+     * @param capacidadBytes Límite de memoria en bytes (0 = desactivada)
+     */
+    explicit CacheConsultas(size_t capacidadBytes);
+
+    CacheConsultas(const CacheConsultas& otra);
+    CacheConsultas& operator=(const CacheConsultas& otra);
+
+    /**
+     * Busca una consulta y la marca como la más reciente
+     * @param clave Clave canónica de la consulta
+     * @param valor Recibe el resultado si está almacenado
+     * @return true si hubo acierto
+     */
+    bool buscar(const std::string& clave, double& valor);
+
+    /**
+     * Guarda un resultado (reemplaza el anterior si la clave ya existe)
+     */
+    void guardar(const std::string& clave, double valor);
+
+    /**
+     * Descarta todas las entradas (los contadores se conservan)
+     */
+    void limpiar();
+
+    /**
+     * Cambia el límite de memoria y descarta lo que sobre
+     * @param capacidadBytes Nuevo límite en bytes (0 = desactivada)
+     */
+    void setCapacidad(size_t capacidadBytes);
+
+    /**
+     * Contadores y ocupación actuales
+     */
+    EstadisticasCache getEstadisticas() const;
+};
+
+#endif
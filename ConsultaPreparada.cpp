@@ -0,0 +1,44 @@
+#include "ConsultaPreparada.h"
+
+/**
+ * Constructor: consulta inválida
+ */
+ConsultaPreparada::ConsultaPreparada() : red(nullptr), metodo(), costo() {
+    plan.casillas = 0;
+}
+
+/**
+ * Constructor usado por RedBayesiana::preparar
+ */
+ConsultaPreparada::ConsultaPreparada(const RedBayesiana* redOrigen, MetodoInferencia metodoElegido)
+    : red(redOrigen), metodo(metodoElegido), costo() {
+    plan.casillas = 0;
+}
+
+/**
+ * Retorna si la preparación tuvo éxito
+ */
+bool ConsultaPreparada::esValida() const {
+    return red != nullptr;
+}
+
+/**
+ * Retorna el número de variables observadas
+ */
+size_t ConsultaPreparada::getNumeroEvidencia() const {
+    return evidencia.size();
+}
+
+/**
+ * Retorna el tamaño del dominio conjunto de la consulta
+ */
+size_t ConsultaPreparada::getNumeroCasillas() const {
+    return plan.casillas;
+}
+
+/**
+ * Retorna el costo estimado de la eliminación
+ */
+const CostoEliminacion& ConsultaPreparada::getCosto() const {
+    return costo;
+}
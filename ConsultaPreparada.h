@@ -0,0 +1,88 @@
+#ifndef CONSULTA_PREPARADA_H
+#define CONSULTA_PREPARADA_H
+
+#include "Factor.h"
+#include "OrdenEliminacion.h"
+#include <vector>
+#include <map>
+#include <cstddef>
+
+class RedBayesiana;
+enum class MetodoInferencia;
+
+/**
+ * Orden de las variables para recorrer ocultas y consulta en la enumeración
+ */
+struct PlanEnumeracion {
+    std::vector<int> estado;             // Estado inicial (evidencia fijada)
+    std::vector<int> variables;          // Ocultas y al final la consulta
+    std::vector<int> factores;           // Nodos cuya tabla entra en el producto
+    std::vector<int> cardinalidades;     // Tamaño del dominio de cada una
+    std::vector<size_t> pasosConsulta;   // Paso de cada variable de consulta en el resultado
+    size_t casillas;                     // Tamaño del dominio conjunto de la consulta
+};
+
+/**
+ * Consulta preparada: una forma de consulta (qué variables se consultan y
+ * cuáles se observan, sin sus valores) resuelta una sola vez
+ *
+ * La subred relevante solo depende de qué nodos tienen evidencia, no de sus
+ * valores, así que los nombres se traducen a índices, la poda se calcula y
+ * el plan del método elegido se arma al preparar:
+ *   - Enumeración: orden de ocultas y consulta, y pasos del resultado
+ *   - Recursiva: orden topológico de los nodos con tabla
+ *   - Eliminación de variables: factores de la subred y orden de eliminación
+ * Cada ejecución solo fija los valores observados y recorre el plan.
+ *
+ * Se crea con RedBayesiana::preparar y solo sirve para la red que la
+ * preparó, mientras esa red no se vuelva a cargar (las versiones de un
+ * ContenedorRed no cambian, así que con ellas siempre es válida).
+ */
+class ConsultaPreparada {
+private:
+    friend class RedBayesiana;
+
+    const RedBayesiana* red;                // Red que la preparó (nula si hubo un error)
+    MetodoInferencia metodo;
+    std::vector<int> consulta;              // Índices de las variables de consulta
+    std::vector<int> evidencia;             // Índices de las variables observadas
+    std::vector<int> cardinalidadesEvidencia;
+
+    PlanEnumeracion plan;                   // Enumeración y enumeración paralela
+    std::vector<int> ordenRecursivo;        // Enumeración recursiva
+    std::vector<bool> fijos;                // Consulta y evidencia en la recursiva
+    std::vector<Factor> factores;           // Eliminación: factores sin reducir
+    std::vector<int> ordenEliminacion;      // Eliminación: ocultas en orden
+    CostoEliminacion costo;                 // Costo de la eliminación (con cualquier método)
+
+    ConsultaPreparada(const RedBayesiana* red, MetodoInferencia metodo);
+
+public:
+    /**
+     * Consulta inválida (resultado de una preparación con errores)
+     */
+    ConsultaPreparada();
+
+    /**
+     * Indica si la preparación tuvo éxito
+     */
+    bool esValida() const;
+
+    /**
+     * Número de variables observadas (valores que pide cada ejecución)
+     */
+    size_t getNumeroEvidencia() const;
+
+    /**
+     * Número de combinaciones de la consulta (tamaño de cada resultado)
+     */
+    size_t getNumeroCasillas() const;
+
+    /**
+     * Ancho inducido y factor intermedio más grande de la eliminación de
+     * variables con la heurística de la red al preparar
+     */
+    const CostoEliminacion& getCosto() const;
+};
+
+#endif
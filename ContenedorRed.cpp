@@ -0,0 +1,84 @@
+#include "ContenedorRed.h"
+
+/**
+ * Constructor
+ */
+ContenedorRed::ContenedorRed(std::shared_ptr<const RedBayesiana> inicial)
+    : red(std::move(inicial)), version(0), recargando(false) {}
+
+/**
+ * Destructor
+ */
+ContenedorRed::~ContenedorRed() {
+    esperarRecarga();
+}
+
+/**
+ * Lectura atómica del puntero
+ */
+std::shared_ptr<const RedBayesiana> ContenedorRed::actual() const {
+    return std::atomic_load(&red);
+}
+
+/**
+ * Escritura atómica del puntero; la versión anterior vive mientras
+ * alguna consulta la use
+ */
+void ContenedorRed::publicar(std::shared_ptr<const RedBayesiana> nueva) {
+    std::atomic_store(&red, std::move(nueva));
+    version++;
+}
+
+/**
+ * Comparar e intercambiar sobre el puntero
+ */
+bool ContenedorRed::reemplazar(std::shared_ptr<const RedBayesiana> esperada,
+                               std::shared_ptr<const RedBayesiana> nueva) {
+    if (!std::atomic_compare_exchange_strong(&red, &esperada, std::move(nueva))) {
+        return false;
+    }
+    version++;
+    return true;
+}
+
+/**
+ * Solo una recarga a la vez; el hilo de la anterior ya terminó si
+ * recargando es false, así que unirlo no bloquea
+ */
+bool ContenedorRed::recargarEnSegundoPlano(Constructor construir,
+                                           std::function<void(bool)> alTerminar) {
+    std::lock_guard<std::mutex> bloqueo(mutexRecarga);
+    if (recargando.load()) return false;
+    if (recarga.joinable()) recarga.join();
+
+    recargando.store(true);
+    recarga = std::thread([this, construir, alTerminar]() {
+        std::shared_ptr<RedBayesiana> nueva = construir();
+        if (nueva) publicar(nueva);
+        recargando.store(false);
+        if (alTerminar) alTerminar(nueva != nullptr);
+    });
+    return true;
+}
+
+/**
+ * Une el hilo de la recarga
+ */
+void ContenedorRed::esperarRecarga() {
+    std::lock_guard<std::mutex> bloqueo(mutexRecarga);
+    if (recarga.joinable()) recarga.join();
+}
+
+/**
+ * Estado de la recarga
+ */
+bool ContenedorRed::estaRecargando() const {
+    return recargando.load();
+}
+
+/**
+ * Versiones publicadas
+ */
+unsigned long long ContenedorRed::getVersion() const {
+    return version.load();
+}
@@ -0,0 +1,97 @@
+#ifndef CONTENEDOR_RED_H
+#define CONTENEDOR_RED_H
+
+#include "RedBayesiana.h"
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+/**
+ * Versión publicada de una red bayesiana, reemplazable sin detener consultas
+ *
+ * Cada versión es una instantánea inmutable (shared_ptr<const RedBayesiana>)
+ * que se lee y se publica con atomic_load/atomic_store. Una consulta toma
+ * la versión actual al comenzar y la conserva hasta terminar, así que una
+ * recarga nunca la interrumpe: las consultas en curso terminan con la
+ * versión anterior, que se libera con la última de ellas, y las siguientes
+ * ven la nueva. Publicar no copia la red, solo el puntero.
+ *
+ * Las recargas se construyen en un hilo aparte; mientras tanto la versión
+ * actual sigue respondiendo.
+ */
+class ContenedorRed {
+public:
+    /**
+     * Construye una red nueva (nulo si hubo un error)
+     */
+    typedef std::function<std::shared_ptr<RedBayesiana>()> Constructor;
+
+private:
+    std::shared_ptr<const RedBayesiana> red;    // Solo con atomic_load/atomic_store
+    std::atomic<unsigned long long> version;
+
+    std::mutex mutexRecarga;
+    std::thread recarga;
+    std::atomic<bool> recargando;
+
+public:
+    /**
+     * Constructor
+     * @param inicial Primera versión de la red
+     */
+    explicit ContenedorRed(std::shared_ptr<const RedBayesiana> inicial);
+
+    /**
+     * Destructor: espera a que termine la recarga en curso
+     */
+    ~ContenedorRed();
+
+    ContenedorRed(const ContenedorRed&) = delete;
+    ContenedorRed& operator=(const ContenedorRed&) = delete;
+
+    /**
+     * Versión actual; quien la recibe la mantiene viva aunque se publique otra
+     */
+    std::shared_ptr<const RedBayesiana> actual() const;
+
+    /**
+     * Publica una versión nueva
+     */
+    void publicar(std::shared_ptr<const RedBayesiana> nueva);
+
+    /**
+     * Publica una versión nueva solo si la actual sigue siendo la esperada
+     * (para derivar una versión de otra sin pisar una recarga)
+     * @return false si otra versión se publicó antes
+     */
+    bool reemplazar(std::shared_ptr<const RedBayesiana> esperada,
+                    std::shared_ptr<const RedBayesiana> nueva);
+
+    /**
+     * Construye una versión nueva en un hilo aparte y la publica al terminar
+     * @param construir Función que carga la red
+     * @param alTerminar Se llama desde ese hilo con true si se publicó
+     * @return false si ya había una recarga en curso (no se inicia otra)
+     */
+    bool recargarEnSegundoPlano(Constructor construir,
+                                std::function<void(bool)> alTerminar = nullptr);
+
+    /**
+     * Espera a que termine la recarga en curso, si la hay
+     */
+    void esperarRecarga();
+
+    /**
+     * Indica si hay una recarga en curso
+     */
+    bool estaRecargando() const;
+
+    /**
+     * Número de versiones publicadas después de la inicial
+     */
+    unsigned long long getVersion() const;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "EstadisticasInferencia.h"
+
+/**
+ * Constructor: todo en cero
+ */
+EstadisticasInferencia::EstadisticasInferencia()
+    : consultas(0), asignacionesOcultas(0), consultasTabla(0), reservasArena(0), reservasSistema(0) {
+    for (size_t f = 0; f < NUM_FASES_INFERENCIA; f++) segundosFase[f] = 0.0;
+}
+
+/**
+ * Suma campo a campo
+ */
+void EstadisticasInferencia::sumar(const EstadisticasInferencia& otra) {
+    consultas += otra.consultas;
+    asignacionesOcultas += otra.asignacionesOcultas;
+    consultasTabla += otra.consultasTabla;
+    reservasArena += otra.reservasArena;
+    reservasSistema += otra.reservasSistema;
+    for (size_t f = 0; f < NUM_FASES_INFERENCIA; f++) segundosFase[f] += otra.segundosFase[f];
+}
+
+/**
+ * Suma de los tiempos de las fases
+ */
+double EstadisticasInferencia::segundosTotales() const {
+    double total = 0.0;
+    for (size_t f = 0; f < NUM_FASES_INFERENCIA; f++) total += segundosFase[f];
+    return total;
+}
+
+/**
+ * Nombres en el orden de FaseInferencia
+ */
+const char* EstadisticasInferencia::nombreFase(size_t fase) {
+    static const char* const nombres[NUM_FASES_INFERENCIA] = {
+        "Resolución", "Poda", "Preparación", "Cálculo", "Normalización"
+    };
+    return fase < NUM_FASES_INFERENCIA ? nombres[fase] : "?";
+}
+
+/**
+ * Constructor
+ */
+RegistroInferencia::RegistroInferencia() {}
+
+/**
+ * Constructor de copia: registro vacío
+ */
+RegistroInferencia::RegistroInferencia(const RegistroInferencia&) {}
+
+/**
+ * Asignación: descarta las mediciones
+ */
+RegistroInferencia& RegistroInferencia::operator=(const RegistroInferencia& otro) {
+    if (this != &otro) reiniciar();
+    return *this;
+}
+
+/**
+ * Guarda la medición como la última y la suma al acumulado
+ */
+void RegistroInferencia::registrar(const EstadisticasInferencia& medicion) {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    ultima = medicion;
+    acumulada.sumar(medicion);
+}
+
+/**
+ * Última inferencia
+ */
+EstadisticasInferencia RegistroInferencia::getUltima() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return ultima;
+}
+
+/**
+ * Acumulado
+ */
+EstadisticasInferencia RegistroInferencia::getAcumulada() const {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    return acumulada;
+}
+
+/**
+ * Vuelve a cero
+ */
+void RegistroInferencia::reiniciar() {
+    std::lock_guard<std::mutex> bloqueo(mutex);
+    ultima = EstadisticasInferencia();
+    acumulada = EstadisticasInferencia();
+}
+
+/**
+ * Depende de la opción de compilación
+ */
+bool RegistroInferencia::habilitado() {
+#ifdef RB_ESTADISTICAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+thread_local MedicionInferencia* MedicionInferencia::activa = nullptr;
+
+/**
+ * Se activa en el hilo actual salvo que ya haya una medición en curso
+ */
+MedicionInferencia::MedicionInferencia(RegistroInferencia& registro)
+    : destino(registro), pasiva(activa != nullptr),
+      faseActual(static_cast<size_t>(FaseInferencia::RESOLUCION)), inicioFase(Reloj::now()) {
+    if (!pasiva) {
+        activa = this;
+        datos.consultas = 1;
+    }
+}
+
+/**
+ * Cierra la última fase y registra la medición
+ */
+MedicionInferencia::~MedicionInferencia() {
+    if (pasiva) return;
+    cerrarFase();
+    activa = nullptr;
+    destino.registrar(datos);
+}
+
+/**
+ * Acumula el tiempo de la fase actual
+ */
+void MedicionInferencia::cerrarFase() {
+    Reloj::time_point ahora = Reloj::now();
+    datos.segundosFase[faseActual] += std::chrono::duration<double>(ahora - inicioFase).count();
+    inicioFase = ahora;
+}
+
+/**
+ * Cambia de fase en la medición activa
+ */
+void MedicionInferencia::iniciarFase(FaseInferencia fase) {
+    if (!activa) return;
+    activa->cerrarFase();
+    activa->faseActual = static_cast<size_t>(fase);
+}
+
+void MedicionInferencia::sumarAsignaciones(unsigned long long cantidad) {
+    if (activa) activa->datos.asignacionesOcultas += cantidad;
+}
+
+void MedicionInferencia::sumarConsultasTabla(unsigned long long cantidad) {
+    if (activa) activa->datos.consultasTabla += cantidad;
+}
+
+void MedicionInferencia::sumarReservas(unsigned long long arena, unsigned long long sistema) {
+    if (!activa) return;
+    activa->datos.reservasArena += arena;
+    activa->datos.reservasSistema += sistema;
+}
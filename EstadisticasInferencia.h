@@ -0,0 +1,159 @@
+#ifndef ESTADISTICAS_INFERENCIA_H
+#define ESTADISTICAS_INFERENCIA_H
+
+#include <mutex>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * Fases en que se reparte el tiempo de una inferencia
+ */
+enum class FaseInferencia {
+    RESOLUCION,      // Validar dominios y traducir nombres y valores a índices
+    PODA,            // Calcular la subred relevante
+    PREPARACION,     // Fijar la evidencia, ordenar variables y armar factores iniciales
+    CALCULO,         // Recorrer combinaciones, eliminar variables, propagar o muestrear
+    NORMALIZACION    // Dividir por P(evidencia), extraer y guardar el resultado
+};
+
+const size_t NUM_FASES_INFERENCIA = 5;
+
+/**
+ * Contadores y tiempos de una o varias inferencias
+ */
+struct EstadisticasInferencia {
+    unsigned long long consultas;             // Inferencias medidas (no cuenta aciertos de caché)
+    unsigned long long asignacionesOcultas;   // Combinaciones de ocultas recorridas o muestreadas
+    unsigned long long consultasTabla;        // Lecturas de P(nodo | padres) en las tablas
+    unsigned long long reservasArena;         // Reservas de memoria de trabajo servidas por la arena
+    unsigned long long reservasSistema;       // Reservas de memoria de trabajo pedidas al sistema
+                                              // (bloques nuevos de la arena, reservas grandes
+                                              // o fuera de una consulta)
+    double segundosFase[NUM_FASES_INFERENCIA];  // Tiempo de pared de cada fase
+
+    EstadisticasInferencia();
+
+    /**
+     * Acumula los contadores y tiempos de otra medición
+     */
+    void sumar(const EstadisticasInferencia& otra);
+
+    /**
+     * Tiempo total de todas las fases
+     */
+    double segundosTotales() const;
+
+    /**
+     * Nombre legible de una fase
+     */
+    static const char* nombreFase(size_t fase);
+};
+
+/**
+ * Registro de las mediciones de una red: la última inferencia y el
+ * acumulado desde el último reinicio
+ *
+ * Protegido por un mutex, así que puede usarse desde métodos const
+ * llamados en paralelo. Copiar un registro produce uno vacío, igual que
+ * la caché: las mediciones pertenecen a la red que las hizo.
+ */
+class RegistroInferencia {
+private:
+    EstadisticasInferencia ultima;
+    EstadisticasInferencia acumulada;
+    mutable std::mutex mutex;
+
+public:
+    RegistroInferencia();
+    RegistroInferencia(const RegistroInferencia& otro);
+    RegistroInferencia& operator=(const RegistroInferencia& otro);
+
+    /**
+     * Agrega la medición de una inferencia terminada
+     */
+    void registrar(const EstadisticasInferencia& medicion);
+
+    /**
+     * Mediciones de la inferencia más reciente
+     */
+    EstadisticasInferencia getUltima() const;
+
+    /**
+     * Suma de todas las inferencias desde el último reinicio
+     */
+    EstadisticasInferencia getAcumulada() const;
+
+    /**
+     * Descarta todas las mediciones
+     */
+    void reiniciar();
+
+    /**
+     * Indica si el programa se compiló con RB_ESTADISTICAS
+     * (sin esa opción los contadores no generan código y quedan en cero)
+     */
+    static bool habilitado();
+};
+
+/**
+ * Medición de una inferencia en curso en el hilo actual
+ *
+ * Se crea al comenzar una inferencia pública y, al destruirse, registra lo
+ * medido. Los métodos estáticos actúan sobre la medición activa del hilo y
+ * no hacen nada si no hay ninguna; una medición creada dentro de otra es
+ * pasiva, de modo que las llamadas anidadas cuentan como una sola consulta.
+ * Los motores paralelos suman sus contadores desde el hilo que los lanzó.
+ */
+class MedicionInferencia {
+private:
+    typedef std::chrono::steady_clock Reloj;
+
+    static thread_local MedicionInferencia* activa;
+
+    RegistroInferencia& destino;
+    EstadisticasInferencia datos;
+    bool pasiva;
+    size_t faseActual;
+    Reloj::time_point inicioFase;
+
+    /**
+     * Suma el tiempo transcurrido a la fase actual
+     */
+    void cerrarFase();
+
+public:
+    explicit MedicionInferencia(RegistroInferencia& registro);
+    ~MedicionInferencia();
+
+    MedicionInferencia(const MedicionInferencia&) = delete;
+    MedicionInferencia& operator=(const MedicionInferencia&) = delete;
+
+    /**
+     * Cierra la fase en curso y comienza otra
+     */
+    static void iniciarFase(FaseInferencia fase);
+
+    static void sumarAsignaciones(unsigned long long cantidad);
+    static void sumarConsultasTabla(unsigned long long cantidad);
+    static void sumarReservas(unsigned long long arena, unsigned long long sistema);
+};
+
+/**
+ * Puntos de medición: con RB_ESTADISTICAS llaman a MedicionInferencia;
+ * sin ella se reemplazan por nada y sus argumentos no se evalúan
+ */
+#ifdef RB_ESTADISTICAS
+#define RB_MEDIR_INFERENCIA(registro) MedicionInferencia medicionInferencia(registro)
+#define RB_FASE(fase) MedicionInferencia::iniciarFase(FaseInferencia::fase)
+#define RB_CONTAR_ASIGNACIONES(cantidad) MedicionInferencia::sumarAsignaciones(cantidad)
+#define RB_CONTAR_TABLA(cantidad) MedicionInferencia::sumarConsultasTabla(cantidad)
+#define RB_CONTAR_RESERVAS(arena, sistema) MedicionInferencia::sumarReservas(arena, sistema)
+#else
+#define RB_MEDIR_INFERENCIA(registro) ((void)0)
+#define RB_FASE(fase) ((void)0)
+#define RB_CONTAR_ASIGNACIONES(cantidad) ((void)0)
+#define RB_CONTAR_TABLA(cantidad) ((void)0)
+#define RB_CONTAR_RESERVAS(arena, sistema) ((void)0)
+#endif
+
+#endif
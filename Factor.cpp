@@ -0,0 +1,341 @@
+#include "Factor.h"
+#include "NucleosFactor.h"
+#include <algorithm>
+
+/**
+ * Constructor: factor constante sin variables con valor 1
+ */
+Factor::Factor() : valores(1, 1.0) {}
+
+/**
+ * Constructor: factor con las variables dadas y valores en cero
+ */
+Factor::Factor(const std::vector<int>& vars, const std::vector<int>& cards)
+    : variables(vars.begin(), vars.end()), cardinalidades(cards.begin(), cards.end()) {
+    calcularPasos();
+}
+
+Factor::Factor(VectorArena<int>&& vars, VectorArena<int>&& cards)
+    : variables(std::move(vars)), cardinalidades(std::move(cards)) {
+    calcularPasos();
+}
+
+/**
+ * Calcula el paso de cada variable (la última variable tiene paso 1)
+ * y reserva espacio para todos los valores
+ */
+void Factor::calcularPasos() {
+    pasos.assign(variables.size(), 1);
+    size_t total = 1;
+    for (size_t i = variables.size(); i-- > 0; ) {
+        pasos[i] = total;
+        total *= cardinalidades[i];
+    }
+    valores.assign(total, 0.0);
+}
+
+/**
+ * Retorna los índices de las variables
+ */
+const VectorArena<int>& Factor::getVariables() const {
+    return variables;
+}
+
+/**
+ * Retorna las cardinalidades de las variables
+ */
+const VectorArena<int>& Factor::getCardinalidades() const {
+    return cardinalidades;
+}
+
+/**
+ * Retorna el número de valores del factor
+ */
+size_t Factor::tamano() const {
+    return valores.size();
+}
+
+/**
+ * Acceso a un valor por posición lineal
+ */
+double& Factor::operator[](size_t posicion) {
+    return valores[posicion];
+}
+
+double Factor::operator[](size_t posicion) const {
+    return valores[posicion];
+}
+
+/**
+ * Busca la posición de una variable dentro del factor
+ */
+int Factor::posicionVariable(int variable) const {
+    auto it = std::lower_bound(variables.begin(), variables.end(), variable);
+    if (it != variables.end() && *it == variable) {
+        return static_cast<int>(it - variables.begin());
+    }
+    return -1;
+}
+
+/**
+ * Verifica si el factor depende de la variable
+ */
+bool Factor::contiene(int variable) const {
+    return posicionVariable(variable) >= 0;
+}
+
+/**
+ * Producto de dos factores
+ * Recorre el factor resultado como un odómetro y avanza en paralelo
+ * las posiciones de ambos operandos usando sus pasos. El odómetro solo
+ * recorre las variables externas: el tramo interno es el sufijo más largo
+ * de variables que cada operando contiene completo (contiguo, paso 1) o no
+ * contiene (su valor se repite), y se multiplica con un solo núcleo
+ */
+Factor Factor::producto(const Factor& otro) const {
+    // Unión ordenada de las variables
+    VectorArena<int> vars;
+    VectorArena<int> cards;
+    VectorArena<size_t> pasoA, pasoB;
+    size_t total = variables.size() + otro.variables.size();
+    vars.reserve(total);
+    cards.reserve(total);
+    pasoA.reserve(total);
+    pasoB.reserve(total);
+    size_t i = 0, j = 0;
+    while (i < variables.size() || j < otro.variables.size()) {
+        if (j >= otro.variables.size() ||
+            (i < variables.size() && variables[i] < otro.variables[j])) {
+            vars.push_back(variables[i]);
+            cards.push_back(cardinalidades[i]);
+            pasoA.push_back(pasos[i]);
+            pasoB.push_back(0);
+            i++;
+        } else if (i >= variables.size() || otro.variables[j] < variables[i]) {
+            vars.push_back(otro.variables[j]);
+            cards.push_back(otro.cardinalidades[j]);
+            pasoA.push_back(0);
+            pasoB.push_back(otro.pasos[j]);
+            j++;
+        } else {
+            vars.push_back(variables[i]);
+            cards.push_back(cardinalidades[i]);
+            pasoA.push_back(pasos[i]);
+            pasoB.push_back(otro.pasos[j]);
+            i++;
+            j++;
+        }
+    }
+
+    Factor resultado(std::move(vars), std::move(cards));
+    const VectorArena<int>& cardsUnion = resultado.cardinalidades;
+    size_t numVariables = resultado.variables.size();
+
+    // Tramo interno: la última variable es la mayor de la unión, así que si
+    // un operando la contiene es también su última variable (paso 1)
+    bool tramoEnA = numVariables == 0 || pasoA.back() != 0;
+    bool tramoEnB = numVariables == 0 || pasoB.back() != 0;
+    size_t externas = numVariables;
+    size_t largo = 1;
+    while (externas > 0 && (pasoA[externas - 1] != 0) == tramoEnA &&
+           (pasoB[externas - 1] != 0) == tramoEnB) {
+        externas--;
+        largo *= cardsUnion[externas];
+    }
+
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+    VectorArena<int> asignacion(externas, 0);
+    size_t posA = 0, posB = 0;
+
+    for (size_t k = 0; k < resultado.valores.size(); k += largo) {
+        double* destino = &resultado.valores[k];
+        if (tramoEnA && tramoEnB) {
+            nucleos.multiplicar(destino, &valores[posA], &otro.valores[posB], largo);
+        } else if (tramoEnA) {
+            nucleos.multiplicarEscalar(destino, &valores[posA], otro.valores[posB], largo);
+        } else {
+            nucleos.multiplicarEscalar(destino, &otro.valores[posB], valores[posA], largo);
+        }
+
+        // Avanzar el odómetro desde la última variable externa
+        for (size_t l = externas; l-- > 0; ) {
+            if (++asignacion[l] < cardsUnion[l]) {
+                posA += pasoA[l];
+                posB += pasoB[l];
+                break;
+            }
+            posA -= (cardsUnion[l] - 1) * pasoA[l];
+            posB -= (cardsUnion[l] - 1) * pasoB[l];
+            asignacion[l] = 0;
+        }
+    }
+
+    return resultado;
+}
+
+/**
+ * Suma una variable del factor
+ * Con orden por filas, el arreglo se ve como [externo][eje][interno]:
+ * se acumulan tramos contiguos de largo interno, o si la variable es la
+ * última (interno = 1) se suma cada grupo contiguo de largo eje
+ */
+Factor Factor::sumarVariable(int variable) const {
+    int p = posicionVariable(variable);
+    if (p < 0) return *this;
+
+    VectorArena<int> vars(variables);
+    VectorArena<int> cards(cardinalidades);
+    vars.erase(vars.begin() + p);
+    cards.erase(cards.begin() + p);
+    Factor resultado(std::move(vars), std::move(cards));
+
+    size_t interno = pasos[p];
+    size_t eje = cardinalidades[p];
+    size_t externo = valores.size() / (eje * interno);
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+
+    if (interno == 1) {
+        for (size_t o = 0; o < externo; o++) {
+            const double* origen = &valores[o * eje];
+            if (eje < NucleosFactor::CARRILES_SUMA) {
+                // Grupos cortos: la suma del núcleo sería la secuencial
+                double suma = 0.0;
+                for (size_t a = 0; a < eje; a++) suma += origen[a];
+                resultado.valores[o] = suma;
+            } else {
+                resultado.valores[o] = nucleos.sumar(origen, eje);
+            }
+        }
+        return resultado;
+    }
+    for (size_t o = 0; o < externo; o++) {
+        double* destino = &resultado.valores[o * interno];
+        for (size_t a = 0; a < eje; a++) {
+            nucleos.acumular(destino, &valores[(o * eje + a) * interno], interno);
+        }
+    }
+
+    return resultado;
+}
+
+/**
+ * Marginaliza sobre todas las variables que no se conservan
+ */
+Factor Factor::marginal(const std::vector<int>& conservar) const {
+    Factor resultado(*this);
+    for (int v : variables) {
+        if (std::find(conservar.begin(), conservar.end(), v) == conservar.end()) {
+            resultado = resultado.sumarVariable(v);
+        }
+    }
+    return resultado;
+}
+
+/**
+ * Pone en cero las entradas donde la variable no toma el valor observado
+ */
+void Factor::fijarEvidencia(int variable, int valor) {
+    int p = posicionVariable(variable);
+    if (p < 0) return;
+
+    size_t interno = pasos[p];
+    size_t eje = cardinalidades[p];
+    size_t externo = valores.size() / (eje * interno);
+
+    for (size_t o = 0; o < externo; o++) {
+        for (size_t a = 0; a < eje; a++) {
+            if (static_cast<int>(a) == valor) continue;
+            double* destino = &valores[(o * eje + a) * interno];
+            std::fill(destino, destino + interno, 0.0);
+        }
+    }
+}
+
+/**
+ * Fija una variable a un valor y la elimina del factor
+ */
+Factor Factor::reducir(int variable, int valor) const {
+    int p = posicionVariable(variable);
+    if (p < 0) return *this;
+
+    VectorArena<int> vars(variables);
+    VectorArena<int> cards(cardinalidades);
+    vars.erase(vars.begin() + p);
+    cards.erase(cards.begin() + p);
+    Factor resultado(std::move(vars), std::move(cards));
+
+    size_t interno = pasos[p];
+    size_t eje = cardinalidades[p];
+    size_t externo = valores.size() / (eje * interno);
+
+    for (size_t o = 0; o < externo; o++) {
+        const double* origen = &valores[(o * eje + valor) * interno];
+        std::copy(origen, origen + interno, &resultado.valores[o * interno]);
+    }
+
+    return resultado;
+}
+
+/**
+ * Copia los valores en un vector nuevo
+ */
+std::vector<double> Factor::valoresEnOrden(const std::vector<int>& orden) const {
+    std::vector<double> resultado;
+    valoresEnOrden(orden, resultado);
+    return resultado;
+}
+
+/**
+ * Recorre las variables en el orden pedido y toma cada valor del factor
+ * usando los pasos originales
+ */
+void Factor::valoresEnOrden(const std::vector<int>& orden, std::vector<double>& resultado) const {
+    VectorArena<int> cards;
+    VectorArena<size_t> pasoOrigen;
+    cards.reserve(orden.size());
+    pasoOrigen.reserve(orden.size());
+    for (int v : orden) {
+        int p = posicionVariable(v);
+        cards.push_back(cardinalidades[p]);
+        pasoOrigen.push_back(pasos[p]);
+    }
+
+    resultado.resize(valores.size());
+    VectorArena<int> asignacion(orden.size(), 0);
+    size_t origen = 0;
+
+    for (size_t k = 0; k < resultado.size(); k++) {
+        resultado[k] = valores[origen];
+        for (size_t l = orden.size(); l-- > 0; ) {
+            if (++asignacion[l] < cards[l]) {
+                origen += pasoOrigen[l];
+                break;
+            }
+            origen -= (cards[l] - 1) * pasoOrigen[l];
+            asignacion[l] = 0;
+        }
+    }
+}
+
+/**
+ * Divide con el núcleo y luego anula las posiciones con divisor 0
+ */
+void Factor::dividir(const Factor& divisor) {
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+    nucleos.dividirElementos(valores.data(), divisor.valores.data(), valores.size());
+    for (size_t i = 0; i < valores.size(); i++) {
+        if (divisor.valores[i] == 0.0) valores[i] = 0.0;
+    }
+}
+
+/**
+ * Normaliza el factor para que sume 1
+ */
+double Factor::normalizar() {
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+    double suma = nucleos.sumar(valores.data(), valores.size());
+    if (suma > 0.0) {
+        nucleos.dividir(valores.data(), suma, valores.size());
+    }
+    return suma;
+}
@@ -0,0 +1,142 @@
+#ifndef FACTOR_H
+#define FACTOR_H
+
+#include "ArenaConsulta.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * Clase que representa un factor (tabla de valores no negativos)
+ * sobre un conjunto de variables discretas de la red
+ *
+ * Las variables se identifican por su índice entero y se mantienen
+ * ordenadas de forma ascendente. Los valores se guardan en un único
+ * arreglo contiguo en orden de filas: la última variable es la que
+ * cambia más rápido (paso 1).
+ *
+ * Toda su memoria viene de AsignadorArena: los factores intermedios de una
+ * consulta se toman de la arena del hilo y se liberan juntos al terminarla.
+ */
+class Factor {
+private:
+    VectorArena<int> variables;        // Índices de variables (ordenados)
+    VectorArena<int> cardinalidades;   // Tamaño del dominio de cada variable
+    VectorArena<size_t> pasos;         // Paso (stride) de cada variable
+    VectorArena<double> valores;       // Valores del factor
+
+    /**
+     * Constructor con variables ya armadas en la arena (valores en cero)
+     */
+    Factor(VectorArena<int>&& vars, VectorArena<int>&& cards);
+
+    /**
+     * Recalcula los pasos y redimensiona el arreglo de valores
+     */
+    void calcularPasos();
+
+public:
+    /**
+     * Constructor de un factor constante (sin variables) con valor 1
+     */
+    Factor();
+
+    /**
+     * Constructor de un factor con todos sus valores en cero
+     * @param vars Índices de las variables (deben estar ordenados)
+     * @param cards Cardinalidad de cada variable
+     */
+    Factor(const std::vector<int>& vars, const std::vector<int>& cards);
+
+    /**
+     * Obtiene los índices de las variables del factor
+     */
+    const VectorArena<int>& getVariables() const;
+
+    /**
+     * Obtiene las cardinalidades de las variables del factor
+     */
+    const VectorArena<int>& getCardinalidades() const;
+
+    /**
+     * Número de valores almacenados en el factor
+     */
+    size_t tamano() const;
+
+    /**
+     * Acceso directo al valor en una posición lineal
+     */
+    double& operator[](size_t posicion);
+    double operator[](size_t posicion) const;
+
+    /**
+     * Posición de una variable dentro del factor (-1 si no está)
+     */
+    int posicionVariable(int variable) const;
+
+    /**
+     * Verifica si el factor depende de una variable
+     */
+    bool contiene(int variable) const;
+
+    /**
+     * Producto de factores: el resultado está definido sobre la unión
+     * de las variables de ambos factores
+     */
+    Factor producto(const Factor& otro) const;
+
+    /**
+     * Marginaliza (suma) una variable del factor
+     * @param variable Índice de la variable a eliminar
+     */
+    Factor sumarVariable(int variable) const;
+
+    /**
+     * Suma todas las variables que no están en la lista dada
+     * @param conservar Variables que permanecen en el resultado
+     */
+    Factor marginal(const std::vector<int>& conservar) const;
+
+    /**
+     * Anula las entradas incompatibles con una observación, sin
+     * eliminar la variable del factor
+     * @param variable Índice de la variable observada
+     * @param valor Índice del valor observado dentro de su dominio
+     */
+    void fijarEvidencia(int variable, int valor);
+
+    /**
+     * Reduce el factor fijando una variable a un valor observado
+     * @param variable Índice de la variable observada
+     * @param valor Índice del valor observado dentro de su dominio
+     */
+    Factor reducir(int variable, int valor) const;
+
+    /**
+     * Copia los valores del factor con las variables en otro orden
+     * @param orden Permutación de las variables del factor
+     * @return Valores en orden por filas según el orden dado
+     */
+    std::vector<double> valoresEnOrden(const std::vector<int>& orden) const;
+
+    /**
+     * Igual que valoresEnOrden, pero escribe en un vector existente
+     * (reutiliza su capacidad)
+     */
+    void valoresEnOrden(const std::vector<int>& orden, std::vector<double>& destino) const;
+
+    /**
+     * Divide elemento a elemento por un factor con las mismas variables
+     * Donde el divisor es 0 el resultado es 0 (0/0 = 0, como en la
+     * propagación de Hugin)
+     * @param divisor Factor sobre exactamente las mismas variables
+     */
+    void dividir(const Factor& divisor);
+
+    /**
+     * Normaliza el factor para que sus valores sumen 1
+     * @return Suma de los valores antes de normalizar
+     */
+    double normalizar();
+};
+
+#endif
@@ -0,0 +1,281 @@
+#include "FactorLote.h"
+#include "NucleosFactor.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * Suma columnas caso por caso en el mismo orden que el núcleo sumar de
+ * NucleosFactor (acumuladores intercalados combinados en árbol, y el resto
+ * en orden), para que cada caso dé exactamente lo mismo que el Factor
+ * equivalente
+ * @param destino Resultado, en cero al llamar
+ * @param columnas Primera columna; la k-ésima empieza en columnas + k * separacion
+ */
+void sumarColumnas(const NucleosFactor::Tabla& nucleos, double* destino, const double* columnas,
+                   size_t separacion, size_t numColumnas, size_t largo) {
+    const size_t carriles = NucleosFactor::CARRILES_SUMA;
+    size_t k = 0;
+    if (numColumnas >= carriles) {
+        VectorArena<double> otros((carriles - 1) * largo, 0.0);
+        double* acumuladores[carriles];
+        acumuladores[0] = destino;
+        for (size_t j = 0; j + 1 < carriles; j++) acumuladores[j + 1] = &otros[j * largo];
+        for (; k + carriles <= numColumnas; k += carriles) {
+            for (size_t j = 0; j < carriles; j++) {
+                nucleos.acumular(acumuladores[j], columnas + (k + j) * separacion, largo);
+            }
+        }
+        for (size_t j = 0; j < 4; j++) {
+            nucleos.acumular(acumuladores[j], acumuladores[4 + j], largo);
+            nucleos.acumular(acumuladores[8 + j], acumuladores[12 + j], largo);
+            nucleos.acumular(acumuladores[j], acumuladores[8 + j], largo);
+        }
+        nucleos.acumular(acumuladores[0], acumuladores[1], largo);
+        nucleos.acumular(acumuladores[2], acumuladores[3], largo);
+        nucleos.acumular(acumuladores[0], acumuladores[2], largo);
+    }
+    for (; k < numColumnas; k++) {
+        nucleos.acumular(destino, columnas + k * separacion, largo);
+    }
+}
+
+}
+
+/**
+ * Constructor: factor constante sin variables con valor 1
+ */
+FactorLote::FactorLote(size_t numCasos) : casos(numCasos) {
+    calcularPasos(1.0);
+}
+
+/**
+ * Constructor: factor con las variables dadas y valores en cero
+ */
+FactorLote::FactorLote(const VectorArena<int>& vars, const VectorArena<int>& cards, size_t numCasos)
+    : variables(vars), cardinalidades(cards), casos(numCasos) {
+    calcularPasos(0.0);
+}
+
+/**
+ * Reducción por caso
+ * 1. El desplazamiento de cada caso en la tabla base es la suma de
+ *    valor observado * paso de cada variable observada
+ * 2. Cada posición del resultado corresponde a una posición base sin las
+ *    observadas; su columna se lee en base + desplazamiento del caso
+ */
+FactorLote::FactorLote(const Factor& base, const std::vector<int>& observadas,
+                       const std::vector<const int*>& columnas, size_t numCasos)
+    : casos(numCasos) {
+    const auto& varsBase = base.getVariables();
+    const auto& cardsBase = base.getCardinalidades();
+    VectorArena<size_t> pasosBase(varsBase.size(), 1);
+    size_t total = 1;
+    for (size_t i = varsBase.size(); i-- > 0; ) {
+        pasosBase[i] = total;
+        total *= cardsBase[i];
+    }
+
+    VectorArena<size_t> desplazamiento(casos, 0);
+    VectorArena<char> observada(varsBase.size(), false);
+    for (size_t k = 0; k < observadas.size(); k++) {
+        int p = base.posicionVariable(observadas[k]);
+        if (p < 0) continue;
+        observada[p] = true;
+        const int* valores = columnas[k];
+        for (size_t n = 0; n < casos; n++) {
+            desplazamiento[n] += valores[n] * pasosBase[p];
+        }
+    }
+
+    VectorArena<size_t> pasoOrigen;
+    for (size_t i = 0; i < varsBase.size(); i++) {
+        if (observada[i]) continue;
+        variables.push_back(varsBase[i]);
+        cardinalidades.push_back(cardsBase[i]);
+        pasoOrigen.push_back(pasosBase[i]);
+    }
+    calcularPasos(0.0);
+
+    VectorArena<int> asignacion(variables.size(), 0);
+    size_t origen = 0;
+    for (size_t r = 0; r < posiciones(); r++) {
+        double* destino = &valores[r * casos];
+        for (size_t n = 0; n < casos; n++) {
+            destino[n] = base[origen + desplazamiento[n]];
+        }
+        for (size_t l = variables.size(); l-- > 0; ) {
+            if (++asignacion[l] < cardinalidades[l]) {
+                origen += pasoOrigen[l];
+                break;
+            }
+            origen -= (cardinalidades[l] - 1) * pasoOrigen[l];
+            asignacion[l] = 0;
+        }
+    }
+}
+
+/**
+ * Calcula el paso de cada variable (la última variable tiene paso 1)
+ * y reserva una columna por posición
+ */
+void FactorLote::calcularPasos(double inicial) {
+    pasos.assign(variables.size(), 1);
+    size_t total = 1;
+    for (size_t i = variables.size(); i-- > 0; ) {
+        pasos[i] = total;
+        total *= cardinalidades[i];
+    }
+    valores.assign(total * casos, inicial);
+}
+
+/**
+ * Retorna los índices de las variables
+ */
+const VectorArena<int>& FactorLote::getVariables() const {
+    return variables;
+}
+
+/**
+ * Retorna las cardinalidades de las variables
+ */
+const VectorArena<int>& FactorLote::getCardinalidades() const {
+    return cardinalidades;
+}
+
+/**
+ * Retorna el número de casos del lote
+ */
+size_t FactorLote::getCasos() const {
+    return casos;
+}
+
+/**
+ * Retorna el número de posiciones del factor
+ */
+size_t FactorLote::posiciones() const {
+    return casos > 0 ? valores.size() / casos : 0;
+}
+
+/**
+ * Retorna la columna de una posición
+ */
+const double* FactorLote::columna(size_t posicion) const {
+    return &valores[posicion * casos];
+}
+
+/**
+ * Verifica si el factor depende de la variable
+ */
+bool FactorLote::contiene(int variable) const {
+    return std::binary_search(variables.begin(), variables.end(), variable);
+}
+
+/**
+ * Producto de dos factores
+ * Mismo odómetro que Factor::producto; en cada posición se multiplican
+ * las columnas completas de ambos operandos
+ */
+FactorLote FactorLote::producto(const FactorLote& otro) const {
+    VectorArena<int> vars;
+    VectorArena<int> cards;
+    VectorArena<size_t> pasoA, pasoB;
+    size_t i = 0, j = 0;
+    while (i < variables.size() || j < otro.variables.size()) {
+        if (j >= otro.variables.size() ||
+            (i < variables.size() && variables[i] < otro.variables[j])) {
+            vars.push_back(variables[i]);
+            cards.push_back(cardinalidades[i]);
+            pasoA.push_back(pasos[i]);
+            pasoB.push_back(0);
+            i++;
+        } else if (i >= variables.size() || otro.variables[j] < variables[i]) {
+            vars.push_back(otro.variables[j]);
+            cards.push_back(otro.cardinalidades[j]);
+            pasoA.push_back(0);
+            pasoB.push_back(otro.pasos[j]);
+            j++;
+        } else {
+            vars.push_back(variables[i]);
+            cards.push_back(cardinalidades[i]);
+            pasoA.push_back(pasos[i]);
+            pasoB.push_back(otro.pasos[j]);
+            i++;
+            j++;
+        }
+    }
+
+    FactorLote resultado(vars, cards, casos);
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+    VectorArena<int> asignacion(vars.size(), 0);
+    size_t posA = 0, posB = 0;
+
+    for (size_t k = 0; k < resultado.posiciones(); k++) {
+        nucleos.multiplicar(&resultado.valores[k * casos], &valores[posA * casos],
+                            &otro.valores[posB * casos], casos);
+
+        for (size_t l = vars.size(); l-- > 0; ) {
+            if (++asignacion[l] < cards[l]) {
+                posA += pasoA[l];
+                posB += pasoB[l];
+                break;
+            }
+            posA -= (cards[l] - 1) * pasoA[l];
+            posB -= (cards[l] - 1) * pasoB[l];
+            asignacion[l] = 0;
+        }
+    }
+
+    return resultado;
+}
+
+/**
+ * Suma una variable del factor
+ * Con orden por filas el arreglo se ve como [externo][eje][interno x casos];
+ * si la variable es la última, cada grupo se suma como en Factor
+ */
+FactorLote FactorLote::sumarVariable(int variable) const {
+    auto it = std::lower_bound(variables.begin(), variables.end(), variable);
+    if (it == variables.end() || *it != variable) return *this;
+    size_t p = it - variables.begin();
+
+    VectorArena<int> vars(variables);
+    VectorArena<int> cards(cardinalidades);
+    vars.erase(vars.begin() + p);
+    cards.erase(cards.begin() + p);
+    FactorLote resultado(vars, cards, casos);
+
+    size_t interno = pasos[p] * casos;
+    size_t eje = cardinalidades[p];
+    size_t externo = valores.size() / (eje * interno);
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+
+    for (size_t o = 0; o < externo; o++) {
+        double* destino = &resultado.valores[o * interno];
+        if (pasos[p] == 1) {
+            sumarColumnas(nucleos, destino, &valores[o * eje * interno], interno, eje, interno);
+            continue;
+        }
+        for (size_t a = 0; a < eje; a++) {
+            nucleos.acumular(destino, &valores[(o * eje + a) * interno], interno);
+        }
+    }
+
+    return resultado;
+}
+
+/**
+ * Normaliza cada caso: acumula las columnas y divide cada una por la
+ * suma de su caso
+ */
+void FactorLote::normalizar() {
+    const NucleosFactor::Tabla& nucleos = NucleosFactor::activos();
+    VectorArena<double> suma(casos, 0.0);
+    sumarColumnas(nucleos, suma.data(), valores.data(), casos, posiciones(), casos);
+    for (double& s : suma) {
+        if (!(s > 0.0)) s = 1.0;
+    }
+    for (size_t k = 0; k < posiciones(); k++) {
+        nucleos.dividirElementos(&valores[k * casos], suma.data(), casos);
+    }
+}
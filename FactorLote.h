@@ -0,0 +1,110 @@
+#ifndef FACTOR_LOTE_H
+#define FACTOR_LOTE_H
+
+#include "Factor.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * Factor evaluado a la vez para un lote de casos (uno por fila de evidencia)
+ *
+ * Igual que Factor, las variables están ordenadas y la última cambia más
+ * rápido, pero cada posición guarda una columna con un valor por caso:
+ *   valores[posicion * casos + caso]
+ * Así el producto, la suma de una variable y la normalización recorren los
+ * casos en tramos contiguos con los núcleos de NucleosFactor. El número de
+ * casos debe ser múltiplo de ANCHO (el llamador rellena con casos de
+ * descarte), de modo que los tramos no dejan restos fuera de los bloques.
+ * Como en Factor, la memoria viene de la arena de la consulta.
+ */
+class FactorLote {
+public:
+    static constexpr size_t ANCHO = 8; // Los casos se agrupan en múltiplos de este ancho
+
+private:
+    VectorArena<int> variables;        // Índices de variables (ordenados)
+    VectorArena<int> cardinalidades;   // Tamaño del dominio de cada variable
+    VectorArena<size_t> pasos;         // Paso (en posiciones) de cada variable
+    size_t casos;                      // Casos por posición (múltiplo de ANCHO)
+    VectorArena<double> valores;       // Columnas de valores, posición por posición
+
+    /**
+     * Recalcula los pasos y redimensiona el arreglo de valores
+     */
+    void calcularPasos(double inicial);
+
+public:
+    /**
+     * Constructor de un factor constante (sin variables) con valor 1
+     * @param numCasos Casos del lote (múltiplo de ANCHO)
+     */
+    explicit FactorLote(size_t numCasos);
+
+    /**
+     * Constructor de un factor con todos sus valores en cero
+     * @param vars Índices de las variables (deben estar ordenados)
+     * @param cards Cardinalidad de cada variable
+     * @param numCasos Casos del lote (múltiplo de ANCHO)
+     */
+    FactorLote(const VectorArena<int>& vars, const VectorArena<int>& cards, size_t numCasos);
+
+    /**
+     * Reduce un factor con la evidencia de cada caso: las variables
+     * observadas desaparecen y cada columna toma los valores de su caso
+     * @param base Factor sin reducir
+     * @param observadas Variables observadas (pueden no estar en el factor)
+     * @param columnas Valor observado de cada variable, un arreglo por
+     *        variable con numCasos entradas
+     * @param numCasos Casos del lote (múltiplo de ANCHO)
+     */
+    FactorLote(const Factor& base, const std::vector<int>& observadas,
+               const std::vector<const int*>& columnas, size_t numCasos);
+
+    /**
+     * Obtiene los índices de las variables del factor
+     */
+    const VectorArena<int>& getVariables() const;
+
+    /**
+     * Obtiene las cardinalidades de las variables del factor
+     */
+    const VectorArena<int>& getCardinalidades() const;
+
+    /**
+     * Número de casos del lote
+     */
+    size_t getCasos() const;
+
+    /**
+     * Número de posiciones (combinaciones de las variables)
+     */
+    size_t posiciones() const;
+
+    /**
+     * Columna de valores de una posición (un valor por caso)
+     */
+    const double* columna(size_t posicion) const;
+
+    /**
+     * Verifica si el factor depende de una variable
+     */
+    bool contiene(int variable) const;
+
+    /**
+     * Producto de factores, caso por caso
+     */
+    FactorLote producto(const FactorLote& otro) const;
+
+    /**
+     * Marginaliza (suma) una variable del factor en todos los casos
+     */
+    FactorLote sumarVariable(int variable) const;
+
+    /**
+     * Normaliza cada caso para que sus valores sumen 1 (los casos con
+     * suma cero quedan en cero)
+     */
+    void normalizar();
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "GeneradorRed.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+/**
+ * Genera nodos, padres, dominios y tablas en orden topológico
+ */
+GeneradorRed::GeneradorRed(const ConfiguracionGenerador& configuracion) : config(configuracion) {
+    config.gradoMaximo = std::max<size_t>(config.gradoMaximo, 1);
+    config.dominioMinimo = std::max<size_t>(config.dominioMinimo, 2);
+    config.dominioMaximo = std::max(config.dominioMaximo, config.dominioMinimo);
+
+    std::seed_seq semillas{static_cast<unsigned>(config.semilla), static_cast<unsigned>(config.semilla >> 32)};
+    std::mt19937_64 generador(semillas);
+    std::uniform_real_distribution<double> uniforme(0.05, 1.0);
+
+    size_t n = config.numNodos;
+    nombres.resize(n);
+    dominios.resize(n);
+    padres.assign(n, std::vector<int>());
+    tablas.resize(n);
+    std::vector<char> tieneHijos(n, 0);
+
+    for (size_t i = 0; i < n; i++) {
+        nombres[i] = "N" + std::to_string(i);
+        size_t cardinalidad = std::uniform_int_distribution<size_t>(config.dominioMinimo, config.dominioMaximo)(generador);
+        for (size_t v = 0; v < cardinalidad; v++) {
+            dominios[i].push_back("v" + std::to_string(v));
+        }
+
+        // Padres dentro de la ventana; el nodo anterior, si quedó aislado,
+        // se toma siempre como padre (y el último nodo tiene al menos uno)
+        size_t inicio = (config.ventana == 0 || i < config.ventana) ? 0 : i - config.ventana;
+        std::vector<int> candidatos;
+        for (size_t j = inicio; j < i; j++) candidatos.push_back(static_cast<int>(j));
+        size_t numPadres = std::uniform_int_distribution<size_t>(0, std::min(config.gradoMaximo, candidatos.size()))(generador);
+
+        bool anteriorAislado = i > 0 && padres[i - 1].empty() && !tieneHijos[i - 1];
+        if (anteriorAislado) {
+            padres[i].push_back(static_cast<int>(i - 1));
+            candidatos.pop_back();
+            numPadres = std::max<size_t>(numPadres, 1) - 1;
+        } else if (i + 1 == n && i > 0 && numPadres == 0) {
+            numPadres = 1;
+        }
+        for (size_t k = 0; k < numPadres && k < candidatos.size(); k++) {
+            size_t elegido = std::uniform_int_distribution<size_t>(k, candidatos.size() - 1)(generador);
+            std::swap(candidatos[k], candidatos[elegido]);
+            padres[i].push_back(candidatos[k]);
+        }
+        std::sort(padres[i].begin(), padres[i].end());
+        for (int p : padres[i]) tieneHijos[p] = 1;
+
+        // Filas positivas normalizadas
+        size_t numFilas = 1;
+        for (int p : padres[i]) numFilas *= dominios[p].size();
+        tablas[i].resize(numFilas * cardinalidad);
+        for (size_t fila = 0; fila < numFilas; fila++) {
+            double* valores = tablas[i].data() + fila * cardinalidad;
+            double suma = 0.0;
+            for (size_t v = 0; v < cardinalidad; v++) {
+                valores[v] = uniforme(generador);
+                suma += valores[v];
+            }
+            for (size_t v = 0; v < cardinalidad; v++) valores[v] /= suma;
+        }
+    }
+}
+
+/**
+ * Escribe los arcos (padres de cada nodo en orden de tabla) y las tablas
+ */
+bool GeneradorRed::escribir(const std::string& archivoEstructura,
+                            const std::string& archivoProbabilidades) const {
+    std::ofstream estructura(archivoEstructura);
+    if (!estructura.is_open()) {
+        std::cerr << "Error: No se puede escribir " << archivoEstructura << "\n";
+        return false;
+    }
+    estructura << "# Red sintética: " << nombres.size() << " nodos, semilla " << config.semilla << "\n";
+    for (size_t i = 0; i < nombres.size(); i++) {
+        for (int p : padres[i]) {
+            estructura << nombres[p] << " " << nombres[i] << "\n";
+        }
+    }
+    if (!estructura) {
+        std::cerr << "Error: No se puede escribir " << archivoEstructura << "\n";
+        return false;
+    }
+
+    std::ofstream probabilidades(archivoProbabilidades);
+    if (!probabilidades.is_open()) {
+        std::cerr << "Error: No se puede escribir " << archivoProbabilidades << "\n";
+        return false;
+    }
+    std::string linea;
+    char numero[32];
+    for (size_t i = 0; i < nombres.size(); i++) {
+        probabilidades << "NODO " << nombres[i] << "\nDOMINIO";
+        for (const auto& valor : dominios[i]) probabilidades << " " << valor;
+        probabilidades << "\n";
+
+        // Recorre las filas como un odómetro sobre los padres (el último cambia más rápido)
+        size_t cardinalidad = dominios[i].size();
+        std::vector<size_t> indices(padres[i].size(), 0);
+        size_t numFilas = tablas[i].size() / cardinalidad;
+        for (size_t fila = 0; fila < numFilas; fila++) {
+            std::string prefijo;
+            for (size_t k = 0; k < indices.size(); k++) {
+                prefijo += dominios[padres[i][k]][indices[k]];
+                prefijo += ' ';
+            }
+            if (!indices.empty()) prefijo += "| ";
+            // %.17g reproduce el double exacto al leerlo: con menos dígitos
+            // las filas dejan de sumar 1 y los motores exactos difieren
+            // apenas la poda quita nodos
+            for (size_t v = 0; v < cardinalidad; v++) {
+                std::snprintf(numero, sizeof(numero), "%.17g", tablas[i][fila * cardinalidad + v]);
+                linea = prefijo;
+                linea += dominios[i][v];
+                linea += ' ';
+                linea += numero;
+                linea += '\n';
+                probabilidades.write(linea.data(), linea.size());
+            }
+            for (size_t k = indices.size(); k-- > 0; ) {
+                if (++indices[k] < dominios[padres[i][k]].size()) break;
+                indices[k] = 0;
+            }
+        }
+    }
+    if (!probabilidades) {
+        std::cerr << "Error: No se puede escribir " << archivoProbabilidades << "\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Elige la variable de consulta y los nodos observados sin repetir
+ */
+std::vector<ConsultaGenerada> GeneradorRed::generarConsultas(size_t cantidad,
+                                                             double proporcionEvidencia,
+                                                             unsigned long long semilla) const {
+    std::vector<ConsultaGenerada> consultas;
+    if (nombres.empty()) return consultas;
+
+    std::seed_seq semillas{static_cast<unsigned>(semilla), static_cast<unsigned>(semilla >> 32)};
+    std::mt19937_64 generador(semillas);
+    size_t n = nombres.size();
+    size_t numEvidencia = static_cast<size_t>(std::lround(std::max(0.0, proporcionEvidencia) * n));
+    numEvidencia = std::min(numEvidencia, n - 1);
+
+    std::vector<size_t> indices(n);
+    for (size_t c = 0; c < cantidad; c++) {
+        for (size_t i = 0; i < n; i++) indices[i] = i;
+        // Barajado parcial: el primero es la consulta, los siguientes la evidencia
+        for (size_t k = 0; k <= numEvidencia; k++) {
+            size_t elegido = std::uniform_int_distribution<size_t>(k, n - 1)(generador);
+            std::swap(indices[k], indices[elegido]);
+        }
+        ConsultaGenerada generada;
+        for (size_t k = 0; k <= numEvidencia; k++) {
+            size_t nodo = indices[k];
+            size_t valor = std::uniform_int_distribution<size_t>(0, dominios[nodo].size() - 1)(generador);
+            if (k == 0) {
+                generada.consulta[nombres[nodo]] = dominios[nodo][valor];
+            } else {
+                generada.evidencia[nombres[nodo]] = dominios[nodo][valor];
+            }
+        }
+        consultas.push_back(generada);
+    }
+    return consultas;
+}
+
+/**
+ * Suma de los tamaños de las tablas
+ */
+size_t GeneradorRed::getNumeroProbabilidades() const {
+    size_t total = 0;
+    for (const auto& tabla : tablas) total += tabla.size();
+    return total;
+}
+
+/**
+ * Suma de los padres de todos los nodos
+ */
+size_t GeneradorRed::getNumeroArcos() const {
+    size_t total = 0;
+    for (const auto& p : padres) total += p.size();
+    return total;
+}
@@ -0,0 +1,84 @@
+#ifndef GENERADOR_RED_H
+#define GENERADOR_RED_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+/**
+ * Parámetros de una red sintética
+ */
+struct ConfiguracionGenerador {
+    size_t numNodos;
+    size_t gradoMaximo;         // Máximo de padres por nodo
+    size_t ventana;             // Los padres se eligen entre los ventana nodos anteriores (0 = todos)
+    size_t dominioMinimo;       // Valores por nodo, elegidos en [mínimo, máximo]
+    size_t dominioMaximo;
+    unsigned long long semilla;
+
+    ConfiguracionGenerador()
+        : numNodos(50), gradoMaximo(3), ventana(8), dominioMinimo(2), dominioMaximo(3), semilla(42) {}
+};
+
+/**
+ * Consulta generada: una variable de consulta y su evidencia
+ */
+struct ConsultaGenerada {
+    std::map<std::string, std::string> consulta;
+    std::map<std::string, std::string> evidencia;
+};
+
+/**
+ * Generador de redes bayesianas aleatorias para pruebas de rendimiento
+ *
+ * Los nodos N0, N1... se crean en orden topológico; cada uno toma entre 0 y
+ * gradoMaximo padres de los nodos anteriores dentro de la ventana, que
+ * limita el ancho de árbol como en las redes reales. Ningún nodo queda
+ * aislado, porque estructura.txt solo lista arcos. Las tablas tienen
+ * valores positivos normalizados por fila, así que ninguna evidencia tiene
+ * probabilidad cero. Con la misma configuración la red es siempre la misma.
+ */
+class GeneradorRed {
+private:
+    ConfiguracionGenerador config;
+    std::vector<std::string> nombres;
+    std::vector<std::vector<std::string>> dominios;
+    std::vector<std::vector<int>> padres;
+    std::vector<std::vector<double>> tablas;    // Formato de Nodo: fila * |dominio| + valor
+
+public:
+    /**
+     * Genera la red
+     */
+    explicit GeneradorRed(const ConfiguracionGenerador& configuracion);
+
+    /**
+     * Escribe la red en los formatos de estructura.txt y probabilidades.txt
+     * @return false si no se pudo escribir algún archivo (se informa en cerr)
+     */
+    bool escribir(const std::string& archivoEstructura,
+                  const std::string& archivoProbabilidades) const;
+
+    /**
+     * Genera un conjunto fijo de consultas de una variable
+     * @param cantidad Número de consultas
+     * @param proporcionEvidencia Fracción de los nodos observados en cada consulta
+     * @param semilla Semilla del generador de consultas
+     */
+    std::vector<ConsultaGenerada> generarConsultas(size_t cantidad,
+                                                   double proporcionEvidencia,
+                                                   unsigned long long semilla) const;
+
+    /**
+     * Número total de probabilidades en las tablas
+     */
+    size_t getNumeroProbabilidades() const;
+
+    /**
+     * Número de arcos
+     */
+    size_t getNumeroArcos() const;
+};
+
+#endif
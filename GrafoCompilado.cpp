@@ -0,0 +1,62 @@
+#include "GrafoCompilado.h"
+
+/**
+ * Constructor: grafo vacío
+ */
+GrafoCompilado::GrafoCompilado() : inicioPadres(1, 0), inicioHijos(1, 0) {}
+
+/**
+ * Compila la topología
+ * 1. Padres en CSR, con los pasos calculados como en la tabla del nodo
+ *    (el último padre tiene paso 1)
+ * 2. Hijos en CSR, invirtiendo las aristas de los padres
+ * 3. Orden topológico (algoritmo de Kahn)
+ */
+GrafoCompilado::GrafoCompilado(const std::vector<std::shared_ptr<Nodo>>& nodosPorIndice,
+                               const std::map<std::string, int>& indicePorNombre) {
+    size_t n = nodosPorIndice.size();
+    nodos.reserve(n);
+    cardinalidades.reserve(n);
+    for (const auto& nodo : nodosPorIndice) {
+        nodos.push_back(nodo.get());
+        cardinalidades.push_back(static_cast<int>(nodo->getCardinalidad()));
+    }
+
+    inicioPadres.assign(n + 1, 0);
+    for (size_t v = 0; v < n; v++) {
+        const auto& padresNodo = nodosPorIndice[v]->getPadres();
+        for (const auto& padre : padresNodo) {
+            padres.push_back(indicePorNombre.at(padre->getNombre()));
+        }
+        pasosPadres.resize(padres.size());
+        size_t filas = 1;
+        for (size_t k = padres.size(); k-- > inicioPadres[v]; ) {
+            pasosPadres[k] = filas;
+            filas *= cardinalidades[padres[k]];
+        }
+        inicioPadres[v + 1] = padres.size();
+    }
+
+    // Cada arista padre -> hijo se cuenta y luego se coloca en su tramo
+    inicioHijos.assign(n + 1, 0);
+    for (int p : padres) inicioHijos[p + 1]++;
+    for (size_t v = 0; v < n; v++) inicioHijos[v + 1] += inicioHijos[v];
+    hijos.resize(padres.size());
+    std::vector<size_t> siguiente(inicioHijos.begin(), inicioHijos.end() - 1);
+    for (size_t v = 0; v < n; v++) {
+        for (size_t k = inicioPadres[v]; k < inicioPadres[v + 1]; k++) {
+            hijos[siguiente[padres[k]]++] = static_cast<int>(v);
+        }
+    }
+
+    std::vector<size_t> padresPendientes(n);
+    for (size_t v = 0; v < n; v++) {
+        padresPendientes[v] = inicioPadres[v + 1] - inicioPadres[v];
+        if (padresPendientes[v] == 0) ordenTopologico.push_back(static_cast<int>(v));
+    }
+    for (size_t k = 0; k < ordenTopologico.size(); k++) {
+        for (int h : getHijos(ordenTopologico[k])) {
+            if (--padresPendientes[h] == 0) ordenTopologico.push_back(h);
+        }
+    }
+}
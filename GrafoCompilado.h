@@ -0,0 +1,143 @@
+#ifndef GRAFO_COMPILADO_H
+#define GRAFO_COMPILADO_H
+
+#include "Nodo.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstddef>
+
+/**
+ * Topología de la red compilada en arreglos planos de enteros
+ *
+ * Cada nodo se identifica por su índice entero (su posición en el orden
+ * alfabético de la red). Padres e hijos se guardan en formato CSR
+ * (compressed sparse row): los padres de v son
+ *   padres[inicioPadres[v] .. inicioPadres[v + 1])
+ * en el orden de la tabla de v, junto con el paso de cada uno en esa
+ * tabla; los hijos se guardan igual. También guarda el orden topológico,
+ * la cardinalidad de cada nodo y su tabla, de modo que los motores de
+ * inferencia recorren la red sin contadores de referencias, búsquedas
+ * por nombre ni copias de vectores.
+ *
+ * Se construye una vez después de cargar la red. Los nodos deben vivir
+ * mientras se use el grafo.
+ */
+class GrafoCompilado {
+public:
+    /**
+     * Vista de solo lectura sobre un tramo de índices
+     */
+    class Rango {
+    private:
+        const int* inicio;
+        const int* fin;
+
+    public:
+        Rango(const int* desde, const int* hasta) : inicio(desde), fin(hasta) {}
+        const int* begin() const { return inicio; }
+        const int* end() const { return fin; }
+        size_t size() const { return static_cast<size_t>(fin - inicio); }
+        bool empty() const { return inicio == fin; }
+        int operator[](size_t k) const { return inicio[k]; }
+    };
+
+private:
+    std::vector<const Nodo*> nodos;         // Tabla de cada nodo
+    std::vector<int> cardinalidades;
+    std::vector<size_t> inicioPadres;       // numNodos + 1 posiciones
+    std::vector<int> padres;
+    std::vector<size_t> pasosPadres;        // Paralelo a padres
+    std::vector<size_t> inicioHijos;        // numNodos + 1 posiciones
+    std::vector<int> hijos;
+    std::vector<int> ordenTopologico;       // Cada padre antes que sus hijos
+
+public:
+    /**
+     * Constructor: grafo vacío
+     */
+    GrafoCompilado();
+
+    /**
+     * Compila la topología de los nodos
+     * @param nodosPorIndice Nodos de la red por índice
+     * @param indicePorNombre Nombre -> índice de cada nodo
+     */
+    GrafoCompilado(const std::vector<std::shared_ptr<Nodo>>& nodosPorIndice,
+                   const std::map<std::string, int>& indicePorNombre);
+
+    /**
+     * Número de nodos
+     */
+    size_t getNumeroNodos() const { return cardinalidades.size(); }
+
+    /**
+     * Padres de un nodo, en el orden de su tabla
+     */
+    Rango getPadres(int v) const {
+        return Rango(padres.data() + inicioPadres[v], padres.data() + inicioPadres[v + 1]);
+    }
+
+    /**
+     * Hijos de un nodo
+     */
+    Rango getHijos(int v) const {
+        return Rango(hijos.data() + inicioHijos[v], hijos.data() + inicioHijos[v + 1]);
+    }
+
+    /**
+     * Paso (en filas) de cada padre dentro de la tabla del nodo
+     */
+    const size_t* getPasosPadres(int v) const {
+        return pasosPadres.data() + inicioPadres[v];
+    }
+
+    /**
+     * Tamaño del dominio de un nodo
+     */
+    int getCardinalidad(int v) const { return cardinalidades[v]; }
+
+    /**
+     * Tamaño del dominio de cada nodo
+     */
+    const std::vector<int>& getCardinalidades() const { return cardinalidades; }
+
+    /**
+     * Índices con cada padre antes que sus hijos
+     */
+    const std::vector<int>& getOrdenTopologico() const { return ordenTopologico; }
+
+    /**
+     * Indica si el orden topológico cubre todos los nodos (no hay ciclos)
+     */
+    bool esAciclico() const { return ordenTopologico.size() == cardinalidades.size(); }
+
+    /**
+     * Fila de la tabla de v según los valores de sus padres en estado
+     * @param estado Índice del valor de cada nodo (por índice de nodo)
+     */
+    size_t fila(int v, const int* estado) const {
+        size_t resultado = 0;
+        for (size_t k = inicioPadres[v]; k < inicioPadres[v + 1]; k++) {
+            resultado += estado[padres[k]] * pasosPadres[k];
+        }
+        return resultado;
+    }
+
+    /**
+     * P(v = valor | padres) leyendo la fila de la tabla de v
+     */
+    double probabilidad(int v, int valor, size_t fila) const {
+        return nodos[v]->getProbabilidad(valor, fila);
+    }
+
+    /**
+     * P(v = estado[v] | padres = estado)
+     */
+    double probabilidad(int v, const int* estado) const {
+        return nodos[v]->getProbabilidad(estado[v], fila(v, estado));
+    }
+};
+
+#endif
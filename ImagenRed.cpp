@@ -0,0 +1,341 @@
+#include "ImagenRed.h"
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const char FIRMA[8] = {'R', 'B', 'I', 'M', 'A', 'G', 'E', 'N'};
+const uint32_t VERSION = 1;
+const uint32_t MARCA_ORDEN = 0x01020304;   // Detecta otro orden de bytes
+
+struct Cabecera {
+    char firma[8];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint64_t tamanoArchivo;
+    uint32_t numNodos;
+    uint32_t numCadenas;
+    uint64_t numReferencias;
+    uint64_t numValores;
+    uint64_t tamanoTexto;
+    uint64_t numProbabilidades;
+    uint64_t desplazamientoNodos;
+    uint64_t desplazamientoReferencias;
+    uint64_t desplazamientoValores;
+    uint64_t desplazamientoCadenas;
+    uint64_t desplazamientoTexto;
+    uint64_t desplazamientoTablas;
+};
+
+struct EntradaNodo {
+    uint32_t nombre;            // Índice de cadena
+    uint32_t cardinalidad;
+    uint32_t primerValor;       // Posición en la sección de valores de dominio
+    uint32_t numPadres;
+    uint32_t primerPadre;       // Posición en la sección de referencias
+    uint32_t numHijos;
+    uint32_t primerHijo;
+    uint32_t reservado;
+    uint64_t primeraProbabilidad;   // Posición en la sección de tablas
+    uint64_t tamanoTabla;
+};
+
+struct EntradaCadena {
+    uint32_t desplazamiento;    // Dentro de la sección de texto
+    uint32_t longitud;
+};
+
+/**
+ * Redondea hacia arriba a un múltiplo de la alineación
+ */
+uint64_t alinear(uint64_t posicion, uint64_t alineacion) {
+    return (posicion + alineacion - 1) / alineacion * alineacion;
+}
+
+/**
+ * Dueño de un archivo mapeado en memoria
+ */
+struct RegionMapeada {
+    void* base;
+    size_t tamano;
+
+    RegionMapeada(void* b, size_t t) : base(b), tamano(t) {}
+    ~RegionMapeada() { munmap(base, tamano); }
+};
+
+/**
+ * Guarda cada cadena una sola vez
+ */
+class TablaCadenas {
+public:
+    std::vector<EntradaCadena> entradas;
+    std::string texto;
+
+    uint32_t internar(const std::string& cadena) {
+        auto it = indices.find(cadena);
+        if (it != indices.end()) return it->second;
+        EntradaCadena entrada = {static_cast<uint32_t>(texto.size()),
+                                 static_cast<uint32_t>(cadena.size())};
+        texto += cadena;
+        uint32_t indice = static_cast<uint32_t>(entradas.size());
+        entradas.push_back(entrada);
+        indices[cadena] = indice;
+        return indice;
+    }
+
+private:
+    std::map<std::string, uint32_t> indices;
+};
+
+/**
+ * Escribe ceros hasta la posición indicada
+ */
+void rellenarHasta(std::ofstream& salida, uint64_t posicion) {
+    static const char ceros[64] = {0};
+    uint64_t actual = static_cast<uint64_t>(salida.tellp());
+    while (actual < posicion) {
+        uint64_t n = std::min<uint64_t>(posicion - actual, sizeof(ceros));
+        salida.write(ceros, static_cast<std::streamsize>(n));
+        actual += n;
+    }
+}
+
+/**
+ * Verifica que una sección [desplazamiento, desplazamiento + cantidad * tamano)
+ * quede dentro del archivo
+ */
+bool seccionValida(uint64_t desplazamiento, uint64_t cantidad, uint64_t tamanoElemento,
+                   uint64_t tamanoArchivo) {
+    if (desplazamiento > tamanoArchivo) return false;
+    if (tamanoElemento != 0 && cantidad > (tamanoArchivo - desplazamiento) / tamanoElemento) return false;
+    return true;
+}
+
+}
+
+/**
+ * Escribe la imagen: primero arma todas las secciones en memoria y luego
+ * las escribe con sus desplazamientos alineados
+ */
+bool ImagenRed::escribir(const std::string& archivo,
+                         const std::vector<std::shared_ptr<Nodo>>& nodos,
+                         const GrafoCompilado& grafo) {
+    TablaCadenas cadenas;
+    std::vector<EntradaNodo> entradas;
+    std::vector<uint32_t> referencias;
+    std::vector<uint32_t> valores;
+    uint64_t numProbabilidades = 0;
+
+    for (size_t i = 0; i < nodos.size(); i++) {
+        const Nodo& nodo = *nodos[i];
+        if (nodo.getTamanoTabla() == 0) {
+            std::cerr << "Error: Nodo '" << nodo.getNombre() << "' no tiene tabla de probabilidad\n";
+            return false;
+        }
+
+        EntradaNodo entrada;
+        std::memset(&entrada, 0, sizeof(entrada));
+        entrada.nombre = cadenas.internar(nodo.getNombre());
+        entrada.cardinalidad = static_cast<uint32_t>(nodo.getCardinalidad());
+        entrada.primerValor = static_cast<uint32_t>(valores.size());
+        for (const auto& valor : nodo.getDominio()) {
+            valores.push_back(cadenas.internar(valor));
+        }
+        GrafoCompilado::Rango padres = grafo.getPadres(static_cast<int>(i));
+        GrafoCompilado::Rango hijos = grafo.getHijos(static_cast<int>(i));
+        entrada.numPadres = static_cast<uint32_t>(padres.size());
+        entrada.primerPadre = static_cast<uint32_t>(referencias.size());
+        for (int p : padres) referencias.push_back(static_cast<uint32_t>(p));
+        entrada.numHijos = static_cast<uint32_t>(hijos.size());
+        entrada.primerHijo = static_cast<uint32_t>(referencias.size());
+        for (int h : hijos) referencias.push_back(static_cast<uint32_t>(h));
+        entrada.primeraProbabilidad = numProbabilidades;
+        entrada.tamanoTabla = nodo.getTamanoTabla();
+        numProbabilidades += nodo.getTamanoTabla();
+        entradas.push_back(entrada);
+    }
+
+    Cabecera cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.firma, FIRMA, sizeof(FIRMA));
+    cabecera.version = VERSION;
+    cabecera.marcaOrden = MARCA_ORDEN;
+    cabecera.numNodos = static_cast<uint32_t>(entradas.size());
+    cabecera.numCadenas = static_cast<uint32_t>(cadenas.entradas.size());
+    cabecera.numReferencias = referencias.size();
+    cabecera.numValores = valores.size();
+    cabecera.tamanoTexto = cadenas.texto.size();
+    cabecera.numProbabilidades = numProbabilidades;
+
+    uint64_t posicion = sizeof(Cabecera);
+    cabecera.desplazamientoNodos = alinear(posicion, 8);
+    posicion = cabecera.desplazamientoNodos + entradas.size() * sizeof(EntradaNodo);
+    cabecera.desplazamientoReferencias = alinear(posicion, 8);
+    posicion = cabecera.desplazamientoReferencias + referencias.size() * sizeof(uint32_t);
+    cabecera.desplazamientoValores = alinear(posicion, 8);
+    posicion = cabecera.desplazamientoValores + valores.size() * sizeof(uint32_t);
+    cabecera.desplazamientoCadenas = alinear(posicion, 8);
+    posicion = cabecera.desplazamientoCadenas + cadenas.entradas.size() * sizeof(EntradaCadena);
+    cabecera.desplazamientoTexto = posicion;
+    posicion += cadenas.texto.size();
+    cabecera.desplazamientoTablas = alinear(posicion, 64);
+    cabecera.tamanoArchivo = cabecera.desplazamientoTablas + numProbabilidades * sizeof(double);
+
+    std::ofstream salida(archivo, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        std::cerr << "Error: No se puede crear " << archivo << "\n";
+        return false;
+    }
+
+    salida.write(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera));
+    rellenarHasta(salida, cabecera.desplazamientoNodos);
+    salida.write(reinterpret_cast<const char*>(entradas.data()),
+                 static_cast<std::streamsize>(entradas.size() * sizeof(EntradaNodo)));
+    rellenarHasta(salida, cabecera.desplazamientoReferencias);
+    salida.write(reinterpret_cast<const char*>(referencias.data()),
+                 static_cast<std::streamsize>(referencias.size() * sizeof(uint32_t)));
+    rellenarHasta(salida, cabecera.desplazamientoValores);
+    salida.write(reinterpret_cast<const char*>(valores.data()),
+                 static_cast<std::streamsize>(valores.size() * sizeof(uint32_t)));
+    rellenarHasta(salida, cabecera.desplazamientoCadenas);
+    salida.write(reinterpret_cast<const char*>(cadenas.entradas.data()),
+                 static_cast<std::streamsize>(cadenas.entradas.size() * sizeof(EntradaCadena)));
+    salida.write(cadenas.texto.data(), static_cast<std::streamsize>(cadenas.texto.size()));
+    rellenarHasta(salida, cabecera.desplazamientoTablas);
+    for (const auto& nodo : nodos) {
+        salida.write(reinterpret_cast<const char*>(nodo->getTabla()),
+                     static_cast<std::streamsize>(nodo->getTamanoTabla() * sizeof(double)));
+    }
+
+    if (!salida.good()) {
+        std::cerr << "Error: No se pudo escribir " << archivo << "\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Mapea la imagen y valida cada sección e índice antes de usarla
+ */
+bool ImagenRed::mapear(const std::string& archivo,
+                       std::vector<NodoImagen>& nodos,
+                       std::shared_ptr<const void>& region) {
+    int descriptor = open(archivo.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        std::cerr << "Error: No se puede abrir " << archivo << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Cabecera))) {
+        close(descriptor);
+        std::cerr << "Error: " << archivo << " no es una imagen de red válida\n";
+        return false;
+    }
+    size_t tamano = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, tamano, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (base == MAP_FAILED) {
+        std::cerr << "Error: No se puede mapear " << archivo << "\n";
+        return false;
+    }
+    std::shared_ptr<RegionMapeada> mapeo = std::make_shared<RegionMapeada>(base, tamano);
+
+    const char* bytes = static_cast<const char*>(base);
+    Cabecera cabecera;
+    std::memcpy(&cabecera, bytes, sizeof(cabecera));
+
+    auto invalida = [&](const char* motivo) {
+        std::cerr << "Error: " << archivo << " no es una imagen de red válida (" << motivo << ")\n";
+        return false;
+    };
+    if (std::memcmp(cabecera.firma, FIRMA, sizeof(FIRMA)) != 0) return invalida("firma");
+    if (cabecera.marcaOrden != MARCA_ORDEN) return invalida("orden de bytes");
+    if (cabecera.version != VERSION) return invalida("versión");
+    if (cabecera.tamanoArchivo != tamano) return invalida("tamaño");
+    if (!seccionValida(cabecera.desplazamientoNodos, cabecera.numNodos, sizeof(EntradaNodo), tamano) ||
+        !seccionValida(cabecera.desplazamientoReferencias, cabecera.numReferencias, sizeof(uint32_t), tamano) ||
+        !seccionValida(cabecera.desplazamientoValores, cabecera.numValores, sizeof(uint32_t), tamano) ||
+        !seccionValida(cabecera.desplazamientoCadenas, cabecera.numCadenas, sizeof(EntradaCadena), tamano) ||
+        !seccionValida(cabecera.desplazamientoTexto, cabecera.tamanoTexto, 1, tamano) ||
+        !seccionValida(cabecera.desplazamientoTablas, cabecera.numProbabilidades, sizeof(double), tamano) ||
+        cabecera.desplazamientoTablas % alignof(double) != 0) {
+        return invalida("secciones");
+    }
+
+    const EntradaNodo* entradas = reinterpret_cast<const EntradaNodo*>(bytes + cabecera.desplazamientoNodos);
+    const uint32_t* referencias = reinterpret_cast<const uint32_t*>(bytes + cabecera.desplazamientoReferencias);
+    const uint32_t* valores = reinterpret_cast<const uint32_t*>(bytes + cabecera.desplazamientoValores);
+    const EntradaCadena* cadenas = reinterpret_cast<const EntradaCadena*>(bytes + cabecera.desplazamientoCadenas);
+    const char* texto = bytes + cabecera.desplazamientoTexto;
+    const double* tablas = reinterpret_cast<const double*>(bytes + cabecera.desplazamientoTablas);
+
+    auto leerCadena = [&](uint32_t indice, std::string& destino) {
+        if (indice >= cabecera.numCadenas) return false;
+        const EntradaCadena& cadena = cadenas[indice];
+        if (static_cast<uint64_t>(cadena.desplazamiento) + cadena.longitud > cabecera.tamanoTexto) return false;
+        destino.assign(texto + cadena.desplazamiento, cadena.longitud);
+        return true;
+    };
+
+    auto leerReferencias = [&](uint32_t primera, uint32_t cantidad, std::vector<int>& destino) {
+        if (static_cast<uint64_t>(primera) + cantidad > cabecera.numReferencias) return false;
+        for (uint32_t k = 0; k < cantidad; k++) {
+            if (referencias[primera + k] >= cabecera.numNodos) return false;
+            destino.push_back(static_cast<int>(referencias[primera + k]));
+        }
+        return true;
+    };
+
+    std::vector<NodoImagen> leidos(cabecera.numNodos);
+    for (uint32_t i = 0; i < cabecera.numNodos; i++) {
+        const EntradaNodo& entrada = entradas[i];
+        NodoImagen& nodo = leidos[i];
+        if (!leerCadena(entrada.nombre, nodo.nombre)) return invalida("nombres");
+        if (static_cast<uint64_t>(entrada.primerValor) + entrada.cardinalidad > cabecera.numValores) {
+            return invalida("dominios");
+        }
+        nodo.dominio.resize(entrada.cardinalidad);
+        for (uint32_t v = 0; v < entrada.cardinalidad; v++) {
+            if (!leerCadena(valores[entrada.primerValor + v], nodo.dominio[v])) return invalida("dominios");
+        }
+        if (!leerReferencias(entrada.primerPadre, entrada.numPadres, nodo.padres) ||
+            !leerReferencias(entrada.primerHijo, entrada.numHijos, nodo.hijos)) {
+            return invalida("referencias");
+        }
+        if (entrada.primeraProbabilidad > cabecera.numProbabilidades ||
+            entrada.tamanoTabla > cabecera.numProbabilidades - entrada.primeraProbabilidad) {
+            return invalida("tablas");
+        }
+        nodo.tabla = tablas + entrada.primeraProbabilidad;
+        nodo.tamanoTabla = static_cast<size_t>(entrada.tamanoTabla);
+    }
+
+    // La tabla de cada nodo debe tener |dominio| * Π |dominio de los padres| valores
+    for (const auto& nodo : leidos) {
+        uint64_t esperado = nodo.dominio.size();
+        for (int p : nodo.padres) esperado *= leidos[p].dominio.size();
+        if (esperado != nodo.tamanoTabla) return invalida("dimensiones de tabla");
+    }
+
+    nodos.swap(leidos);
+    region = mapeo;
+    return true;
+}
+
+/**
+ * Compara los primeros bytes del archivo con la firma
+ */
+bool ImagenRed::esImagen(const std::string& archivo) {
+    std::ifstream entrada(archivo, std::ios::binary);
+    char firma[sizeof(FIRMA)];
+    if (!entrada.read(firma, sizeof(firma))) return false;
+    return std::memcmp(firma, FIRMA, sizeof(FIRMA)) == 0;
+}
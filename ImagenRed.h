@@ -0,0 +1,68 @@
+#ifndef IMAGEN_RED_H
+#define IMAGEN_RED_H
+
+#include "Nodo.h"
+#include "GrafoCompilado.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * Imagen binaria compilada de una red bayesiana
+ *
+ * El archivo contiene, en secciones alineadas:
+ *   cabecera | nodos | referencias (padres e hijos) | valores de dominio |
+ *   cadenas | texto | tablas
+ * Los nombres de nodos y valores se guardan una sola vez (internados) y se
+ * referencian por índice. Las tablas son los mismos arreglos densos de Nodo,
+ * en el orden de índice de los nodos y alineadas a 64 bytes.
+ *
+ * Al cargar, el archivo se mapea en memoria de solo lectura y los nodos
+ * leen sus tablas directamente de las páginas mapeadas: no hay análisis de
+ * texto ni copias, y varios procesos comparten las mismas páginas en la
+ * caché del sistema operativo.
+ */
+class ImagenRed {
+public:
+    /**
+     * Nodo leído de una imagen
+     */
+    struct NodoImagen {
+        std::string nombre;
+        std::vector<std::string> dominio;
+        std::vector<int> padres;        // Índices, en el orden de la tabla
+        std::vector<int> hijos;         // Índices
+        const double* tabla;            // Tabla densa dentro de la región mapeada
+        size_t tamanoTabla;
+    };
+
+    /**
+     * Escribe la imagen de una red
+     * @param archivo Ruta del archivo de salida
+     * @param nodos Nodos por índice (con dominios y tablas preparados)
+     * @param grafo Padres e hijos de cada nodo por índice
+     * @return false si no se pudo escribir (se informa en cerr)
+     */
+    static bool escribir(const std::string& archivo,
+                         const std::vector<std::shared_ptr<Nodo>>& nodos,
+                         const GrafoCompilado& grafo);
+
+    /**
+     * Mapea una imagen en memoria y valida su contenido
+     * @param archivo Ruta de la imagen
+     * @param nodos Recibe los nodos en orden de índice
+     * @param region Recibe el dueño del mapeo (se libera al destruirse)
+     * @return false si el archivo no existe o no es una imagen válida
+     */
+    static bool mapear(const std::string& archivo,
+                       std::vector<NodoImagen>& nodos,
+                       std::shared_ptr<const void>& region);
+
+    /**
+     * Verifica si un archivo comienza con la firma de una imagen
+     */
+    static bool esImagen(const std::string& archivo);
+};
+
+#endif
@@ -0,0 +1,420 @@
+#include "ImportadorRed.h"
+#include "LectorTexto.h"
+#include <iostream>
+#include <unordered_map>
+#include <string_view>
+#include <limits>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace {
+
+/**
+ * Símbolos que forman un token por sí mismos en BIF
+ */
+bool esSimbolo(char c) {
+    return c == '{' || c == '}' || c == '(' || c == ')' || c == '[' || c == ']' ||
+           c == '|' || c == ',' || c == ';';
+}
+
+/**
+ * Analizador léxico de BIF sobre el contenido completo del archivo
+ * Omite comentarios // y de bloque; una cadena entre comillas es un token
+ */
+class LexicoBIF {
+private:
+    const char* p;
+    const char* fin;
+
+public:
+    LexicoBIF(std::string_view texto) : p(texto.data()), fin(texto.data() + texto.size()) {}
+
+    /**
+     * Entrega el siguiente token; al final entrega un token vacío situado
+     * al final del contenido (útil para ubicar errores)
+     */
+    bool siguiente(std::string_view& token) {
+        for (;;) {
+            while (p < fin && LectorTexto::esEspacio(*p)) p++;
+            if (p + 1 < fin && p[0] == '/' && p[1] == '/') {
+                const char* salto = static_cast<const char*>(std::memchr(p, '\n', fin - p));
+                p = salto ? salto : fin;
+            } else if (p + 1 < fin && p[0] == '/' && p[1] == '*') {
+                std::string_view resto(p + 2, fin - p - 2);
+                size_t cierre = resto.find("*/");
+                p = cierre == std::string_view::npos ? fin : p + 2 + cierre + 2;
+            } else {
+                break;
+            }
+        }
+        if (p == fin) {
+            token = std::string_view(fin, 0);
+            return false;
+        }
+
+        const char* inicio = p;
+        if (esSimbolo(*p)) {
+            p++;
+        } else if (*p == '"') {
+            p++;
+            while (p < fin && *p != '"') p++;
+            if (p < fin) p++;
+        } else {
+            while (p < fin && !LectorTexto::esEspacio(*p) && !esSimbolo(*p)) p++;
+        }
+        token = std::string_view(inicio, p - inicio);
+        return true;
+    }
+};
+
+/**
+ * Posición de un valor en un dominio, o -1
+ */
+int posicionEnDominio(const std::vector<std::string>& dominio, std::string_view valor) {
+    for (size_t i = 0; i < dominio.size(); i++) {
+        if (dominio[i] == valor) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+/**
+ * Extensión del archivo en minúsculas (sin el punto)
+ */
+std::string extension(const std::string& archivo) {
+    size_t punto = archivo.find_last_of('.');
+    size_t barra = archivo.find_last_of('/');
+    if (punto == std::string::npos || (barra != std::string::npos && punto < barra)) return "";
+    std::string ext = archivo.substr(punto + 1);
+    for (auto& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext;
+}
+
+}
+
+/**
+ * Reconoce las extensiones .bif y .uai
+ */
+bool ImportadorRed::esImportable(const std::string& archivo) {
+    std::string ext = extension(archivo);
+    return ext == "bif" || ext == "uai";
+}
+
+/**
+ * Elige el analizador según la extensión
+ */
+bool ImportadorRed::leer(const std::string& archivo, std::vector<NodoImportado>& nodos) {
+    std::string ext = extension(archivo);
+    if (ext == "bif") return leerBIF(archivo, nodos);
+    if (ext == "uai") return leerUAI(archivo, nodos);
+    std::cerr << "Error: Formato no reconocido para " << archivo << " (se espera .bif o .uai)\n";
+    return false;
+}
+
+/**
+ * Lee un archivo BIF declaración por declaración
+ */
+bool ImportadorRed::leerBIF(const std::string& archivo, std::vector<NodoImportado>& nodos) {
+    LectorTexto lector;
+    if (!lector.abrir(archivo)) {
+        std::cerr << "Error: No se puede abrir " << archivo << "\n";
+        return false;
+    }
+    LexicoBIF lexico(lector.getContenido());
+    nodos.clear();
+    std::unordered_map<std::string, int> indicePorNombre;
+    std::vector<char> conTabla;
+    std::string_view t;
+
+    auto fallar = [&](std::string_view token, const std::string& mensaje) {
+        std::cerr << "Línea " << lector.lineaDe(token.data()) << " - Error: " << mensaje;
+        if (!token.empty()) std::cerr << " (se encontró '" << token << "')";
+        std::cerr << "\n";
+        return false;
+    };
+    auto esperar = [&](std::string_view esperado) {
+        if (lexico.siguiente(t) && t == esperado) return true;
+        return fallar(t, "Se esperaba '" + std::string(esperado) + "'");
+    };
+    auto buscarVariable = [&](std::string_view nombre) {
+        auto it = indicePorNombre.find(std::string(nombre));
+        return it != indicePorNombre.end() ? it->second : -1;
+    };
+    // Salta una sentencia hasta su ';' (o un bloque { ... } completo)
+    auto saltarSentencia = [&]() {
+        int profundidad = 0;
+        while (lexico.siguiente(t)) {
+            if (t == "{") profundidad++;
+            else if (t == "}" && --profundidad <= 0) return true;
+            else if (t == ";" && profundidad == 0) return true;
+        }
+        return fallar(t, "Fin de archivo inesperado");
+    };
+    // Lee probabilidades separadas por comas hasta ';'
+    auto leerValores = [&](size_t cantidad, std::vector<double>& valores) {
+        valores.clear();
+        const char* inicio = nullptr;
+        while (lexico.siguiente(t) && t != ";") {
+            if (!inicio) inicio = t.data();
+            if (t == ",") continue;
+            double valor;
+            if (!LectorTexto::leerNumero(t, valor)) return fallar(t, "Probabilidad no válida");
+            valores.push_back(valor);
+        }
+        if (t != ";") return fallar(t, "Se esperaba ';'");
+        if (valores.size() != cantidad) {
+            return fallar(std::string_view(inicio ? inicio : t.data(), 0),
+                          "Se esperaban " + std::to_string(cantidad) + " probabilidades y hay " +
+                          std::to_string(valores.size()));
+        }
+        return true;
+    };
+
+    while (lexico.siguiente(t)) {
+        if (t == "network") {
+            // Nombre opcional y bloque de propiedades
+            while (lexico.siguiente(t) && t != "{") {}
+            if (t != "{") return fallar(t, "Se esperaba '{'");
+            int profundidad = 1;
+            while (profundidad > 0 && lexico.siguiente(t)) {
+                if (t == "{") profundidad++;
+                else if (t == "}") profundidad--;
+            }
+            if (profundidad > 0) return fallar(t, "Fin de archivo inesperado");
+        }
+        else if (t == "variable") {
+            std::string_view nombre;
+            if (!lexico.siguiente(nombre) || nombre.empty() || esSimbolo(nombre[0])) {
+                return fallar(nombre, "Se esperaba el nombre de la variable");
+            }
+            if (buscarVariable(nombre) >= 0) {
+                return fallar(nombre, "Variable declarada dos veces");
+            }
+            if (!esperar("{")) return false;
+
+            NodoImportado nodo;
+            nodo.nombre = std::string(nombre);
+            while (lexico.siguiente(t) && t != "}") {
+                if (t != "type") {
+                    if (!saltarSentencia()) return false;
+                    continue;
+                }
+                if (!esperar("discrete") || !esperar("[")) return false;
+                long long cardinalidad;
+                if (!lexico.siguiente(t) || !LectorTexto::leerEntero(t, cardinalidad) || cardinalidad < 1) {
+                    return fallar(t, "Cardinalidad no válida");
+                }
+                if (!esperar("]") || !esperar("{")) return false;
+                while (lexico.siguiente(t) && t != "}") {
+                    if (t == ",") continue;
+                    if (esSimbolo(t[0])) return fallar(t, "Valor de dominio no válido");
+                    nodo.dominio.push_back(std::string(t));
+                }
+                if (t != "}") return fallar(t, "Se esperaba '}'");
+                if (!esperar(";")) return false;
+                if (static_cast<long long>(nodo.dominio.size()) != cardinalidad) {
+                    return fallar(nombre, "La variable " + nodo.nombre + " declara " +
+                                  std::to_string(cardinalidad) + " valores y lista " +
+                                  std::to_string(nodo.dominio.size()));
+                }
+            }
+            if (t != "}") return fallar(t, "Se esperaba '}'");
+            if (nodo.dominio.empty()) {
+                return fallar(nombre, "La variable " + nodo.nombre + " no tiene tipo discreto");
+            }
+            indicePorNombre[nodo.nombre] = static_cast<int>(nodos.size());
+            nodos.push_back(std::move(nodo));
+            conTabla.push_back(0);
+        }
+        else if (t == "probability") {
+            if (!esperar("(")) return false;
+            std::string_view nombre;
+            lexico.siguiente(nombre);
+            int hijo = buscarVariable(nombre);
+            if (hijo < 0) return fallar(nombre, "Variable no declarada");
+            if (conTabla[hijo]) return fallar(nombre, "Tabla de probabilidad definida dos veces");
+
+            std::vector<int> padres;
+            while (lexico.siguiente(t) && t != ")") {
+                if (t == "|" || t == ",") continue;
+                int padre = buscarVariable(t);
+                if (padre < 0) return fallar(t, "Variable no declarada");
+                padres.push_back(padre);
+            }
+            if (t != ")") return fallar(t, "Se esperaba ')'");
+            if (!esperar("{")) return false;
+
+            size_t cardinalidad = nodos[hijo].dominio.size();
+            size_t numFilas = 1;
+            for (int padre : padres) {
+                size_t c = nodos[padre].dominio.size();
+                if (numFilas > std::numeric_limits<size_t>::max() / (c * cardinalidad)) {
+                    return fallar(nombre, "Tabla demasiado grande");
+                }
+                numFilas *= c;
+            }
+            std::vector<double> tabla(numFilas * cardinalidad, std::numeric_limits<double>::quiet_NaN());
+            std::vector<double> porDefecto;
+            std::vector<double> valores;
+
+            while (lexico.siguiente(t) && t != "}") {
+                if (t == "table") {
+                    // El primer valor del nodo varía más lento
+                    if (!leerValores(tabla.size(), valores)) return false;
+                    for (size_t v = 0; v < cardinalidad; v++) {
+                        for (size_t fila = 0; fila < numFilas; fila++) {
+                            tabla[fila * cardinalidad + v] = valores[v * numFilas + fila];
+                        }
+                    }
+                } else if (t == "default") {
+                    if (!leerValores(cardinalidad, porDefecto)) return false;
+                } else if (t == "(") {
+                    size_t fila = 0;
+                    size_t k = 0;
+                    while (lexico.siguiente(t) && t != ")") {
+                        if (t == ",") continue;
+                        if (k >= padres.size()) return fallar(t, "Sobran valores de padres");
+                        int indice = posicionEnDominio(nodos[padres[k]].dominio, t);
+                        if (indice < 0) {
+                            return fallar(t, "Valor fuera del dominio de " + nodos[padres[k]].nombre);
+                        }
+                        fila = fila * nodos[padres[k]].dominio.size() + indice;
+                        k++;
+                    }
+                    if (t != ")") return fallar(t, "Se esperaba ')'");
+                    if (k != padres.size()) return fallar(t, "Faltan valores de padres");
+                    if (!leerValores(cardinalidad, valores)) return false;
+                    std::copy(valores.begin(), valores.end(), tabla.begin() + fila * cardinalidad);
+                } else if (t == "property") {
+                    if (!saltarSentencia()) return false;
+                } else {
+                    return fallar(t, "Entrada de tabla no válida");
+                }
+            }
+            if (t != "}") return fallar(t, "Se esperaba '}'");
+
+            // Las filas sin entrada toman los valores por defecto
+            if (!porDefecto.empty()) {
+                for (size_t fila = 0; fila < numFilas; fila++) {
+                    double* inicio = tabla.data() + fila * cardinalidad;
+                    if (inicio[0] != inicio[0]) std::copy(porDefecto.begin(), porDefecto.end(), inicio);
+                }
+            }
+            nodos[hijo].padres = padres;
+            nodos[hijo].tabla = std::move(tabla);
+            conTabla[hijo] = 1;
+        }
+        else {
+            return fallar(t, "Se esperaba 'network', 'variable' o 'probability'");
+        }
+    }
+
+    for (size_t i = 0; i < nodos.size(); i++) {
+        if (!conTabla[i]) {
+            std::cerr << "Error: La variable '" << nodos[i].nombre << "' no tiene tabla de probabilidad\n";
+            return false;
+        }
+    }
+    if (nodos.empty()) {
+        std::cerr << "Error: " << archivo << " no declara variables\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Lee un archivo UAI: preámbulo, alcances y tablas como una secuencia de tokens
+ */
+bool ImportadorRed::leerUAI(const std::string& archivo, std::vector<NodoImportado>& nodos) {
+    LectorTexto lector;
+    if (!lector.abrir(archivo)) {
+        std::cerr << "Error: No se puede abrir " << archivo << "\n";
+        return false;
+    }
+    std::string_view contenido = lector.getContenido();
+    std::string_view resto = contenido;
+    std::string_view t;
+    nodos.clear();
+
+    auto siguiente = [&]() {
+        if (LectorTexto::siguienteToken(resto, t)) return true;
+        t = std::string_view(contenido.data() + contenido.size(), 0);
+        return false;
+    };
+    auto fallar = [&](const std::string& mensaje) {
+        std::cerr << "Línea " << lector.lineaDe(t.data()) << " - Error: " << mensaje;
+        if (!t.empty()) std::cerr << " (se encontró '" << t << "')";
+        std::cerr << "\n";
+        return false;
+    };
+    auto entero = [&](long long& valor, long long minimo, long long maximo, const char* que) {
+        if (!siguiente() || !LectorTexto::leerEntero(t, valor) || valor < minimo || valor > maximo) {
+            return fallar(std::string("Se esperaba ") + que);
+        }
+        return true;
+    };
+
+    siguiente();
+    if (t != "BAYES") {
+        return fallar(t == "MARKOV" ? "Solo se admiten redes BAYES" : "Se esperaba el preámbulo BAYES");
+    }
+
+    const long long LIMITE = std::numeric_limits<int>::max();
+    long long numVariables;
+    if (!entero(numVariables, 1, LIMITE, "el número de variables")) return false;
+    nodos.resize(numVariables);
+    for (long long i = 0; i < numVariables; i++) {
+        long long cardinalidad;
+        if (!entero(cardinalidad, 1, LIMITE, "una cardinalidad")) return false;
+        nodos[i].nombre = "X" + std::to_string(i);
+        for (long long v = 0; v < cardinalidad; v++) {
+            nodos[i].dominio.push_back(std::to_string(v));
+        }
+    }
+
+    // Alcances: el hijo es la última variable de cada tabla
+    long long numTablas;
+    if (!entero(numTablas, 1, LIMITE, "el número de tablas")) return false;
+    if (numTablas != numVariables) {
+        return fallar("Una red BAYES necesita una tabla por variable");
+    }
+    std::vector<int> hijoDeTabla(numTablas);
+    std::vector<char> conTabla(numVariables, 0);
+    for (long long f = 0; f < numTablas; f++) {
+        long long tamano;
+        if (!entero(tamano, 1, numVariables, "el tamaño del alcance")) return false;
+        std::vector<int> alcance(tamano);
+        for (long long k = 0; k < tamano; k++) {
+            long long variable;
+            if (!entero(variable, 0, numVariables - 1, "un índice de variable")) return false;
+            alcance[k] = static_cast<int>(variable);
+        }
+        int hijo = alcance.back();
+        if (conTabla[hijo]) return fallar("La variable X" + std::to_string(hijo) + " tiene dos tablas");
+        conTabla[hijo] = 1;
+        hijoDeTabla[f] = hijo;
+        nodos[hijo].padres.assign(alcance.begin(), alcance.end() - 1);
+    }
+
+    // Tablas: la última variable del alcance varía más rápido, igual que en Nodo
+    for (long long f = 0; f < numTablas; f++) {
+        NodoImportado& nodo = nodos[hijoDeTabla[f]];
+        size_t esperadas = nodo.dominio.size();
+        for (int padre : nodo.padres) esperadas *= nodos[padre].dominio.size();
+
+        long long cantidad;
+        if (!entero(cantidad, 0, std::numeric_limits<long long>::max(), "el número de valores de la tabla")) {
+            return false;
+        }
+        if (static_cast<size_t>(cantidad) != esperadas) {
+            return fallar("La tabla de " + nodo.nombre + " debe tener " + std::to_string(esperadas) + " valores");
+        }
+        nodo.tabla.resize(esperadas);
+        for (size_t i = 0; i < esperadas; i++) {
+            if (!siguiente() || !LectorTexto::leerNumero(t, nodo.tabla[i])) {
+                return fallar("Probabilidad no válida en la tabla de " + nodo.nombre);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef IMPORTADOR_RED_H
+#define IMPORTADOR_RED_H
+
+#include <string>
+#include <vector>
+
+/**
+ * Importa redes en formatos estándar de repositorios y otras herramientas
+ *
+ * BIF (Bayesian Interchange Format, .bif):
+ *   variable A { type discrete [ 2 ] { si, no }; }
+ *   probability ( A | B, C ) { (b1, c1) 0.2, 0.8; ... }
+ *   Se aceptan también las entradas "table" (el primer valor del nodo
+ *   varía más lento) y "default", y comentarios // y bloque.
+ *
+ * UAI (.uai, preámbulo BAYES):
+ *   número de variables, cardinalidades, alcance de cada tabla (el hijo es
+ *   la última variable) y los valores de cada tabla. Como el formato no
+ *   tiene nombres, las variables se llaman X0, X1... y sus valores 0, 1...
+ *
+ * Ambos analizadores recorren el archivo sobre el búfer de LectorTexto,
+ * sin copiar líneas, y producen la misma descripción de nodos que se usa
+ * para construir la red.
+ */
+class ImportadorRed {
+public:
+    /**
+     * Nodo leído de un archivo importado
+     */
+    struct NodoImportado {
+        std::string nombre;
+        std::vector<std::string> dominio;
+        std::vector<int> padres;        // Índices, en el orden de la tabla
+        std::vector<double> tabla;      // Formato de Nodo: fila * |dominio| + valor
+    };
+
+    /**
+     * Indica si la extensión del archivo corresponde a un formato importable
+     */
+    static bool esImportable(const std::string& archivo);
+
+    /**
+     * Lee un archivo eligiendo el formato por su extensión
+     * @param nodos Recibe los nodos en el orden del archivo
+     * @return false si hay errores (se informan en cerr con el número de línea)
+     */
+    static bool leer(const std::string& archivo, std::vector<NodoImportado>& nodos);
+
+    /**
+     * Lee un archivo BIF
+     */
+    static bool leerBIF(const std::string& archivo, std::vector<NodoImportado>& nodos);
+
+    /**
+     * Lee un archivo UAI de tipo BAYES
+     */
+    static bool leerUAI(const std::string& archivo, std::vector<NodoImportado>& nodos);
+};
+
+#endif
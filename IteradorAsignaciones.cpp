@@ -0,0 +1,70 @@
+#include "IteradorAsignaciones.h"
+
+/**
+ * Constructor: inicia en la primera combinación
+ */
+IteradorAsignaciones::IteradorAsignaciones(VectorArena<int>& est,
+                                           const std::vector<int>& vars,
+                                           const std::vector<int>& cards)
+    : estado(est), variables(vars.begin(), vars.end()), cardinalidades(cards.begin(), cards.end()),
+      terminado(false) {
+    reiniciar();
+}
+
+/**
+ * Coloca todas las variables en su primer valor
+ */
+void IteradorAsignaciones::reiniciar() {
+    terminado = false;
+    for (size_t i = 0; i < variables.size(); i++) {
+        estado[variables[i]] = 0;
+        // Una variable sin valores no tiene combinaciones
+        if (cardinalidades[i] <= 0) terminado = true;
+    }
+}
+
+/**
+ * Decodifica el índice en base mixta (la última variable es la menos
+ * significativa)
+ */
+void IteradorAsignaciones::posicionar(unsigned long long indice) {
+    terminado = indice >= total();
+    for (size_t i = variables.size(); i-- > 0 && !terminado; ) {
+        estado[variables[i]] = static_cast<int>(indice % cardinalidades[i]);
+        indice /= cardinalidades[i];
+    }
+}
+
+/**
+ * Retorna si quedan combinaciones por visitar
+ */
+bool IteradorAsignaciones::valido() const {
+    return !terminado;
+}
+
+/**
+ * Incrementa el odómetro: la última variable cambia primero y al
+ * desbordarse vuelve a 0 y acarrea a la anterior
+ */
+bool IteradorAsignaciones::avanzar() {
+    for (size_t i = variables.size(); i-- > 0; ) {
+        int& valor = estado[variables[i]];
+        if (++valor < cardinalidades[i]) {
+            return true;
+        }
+        valor = 0;
+    }
+    terminado = true;
+    return false;
+}
+
+/**
+ * Producto de las cardinalidades
+ */
+unsigned long long IteradorAsignaciones::total() const {
+    unsigned long long producto = 1;
+    for (int c : cardinalidades) {
+        producto *= static_cast<unsigned long long>(c);
+    }
+    return producto;
+}
@@ -0,0 +1,65 @@
+#ifndef ITERADOR_ASIGNACIONES_H
+#define ITERADOR_ASIGNACIONES_H
+
+#include "ArenaConsulta.h"
+#include <vector>
+#include <cstddef>
+
+/**
+ * Recorre todas las combinaciones de valores de un conjunto de variables
+ * como un odómetro, modificando en el lugar un vector de estado compartido
+ *
+ * El estado contiene el índice del valor actual de cada variable de la red;
+ * el iterador solo modifica las posiciones de sus variables. La última
+ * variable es la que cambia más rápido. No se reserva memoria por paso,
+ * por lo que el costo en memoria es O(n) sin importar cuántas
+ * combinaciones existan; esa memoria viene de la arena de la consulta.
+ */
+class IteradorAsignaciones {
+private:
+    VectorArena<int>& estado;           // Valor actual de cada variable de la red
+    VectorArena<int> variables;         // Variables que recorre el iterador
+    VectorArena<int> cardinalidades;    // Tamaño del dominio de cada variable
+    bool terminado;                     // true cuando se agotan las combinaciones
+
+public:
+    /**
+     * Constructor: coloca las variables en su primera combinación
+     * @param estado Vector de estado (un valor por variable de la red)
+     * @param variables Índices de las variables a recorrer
+     * @param cardinalidades Tamaño del dominio de cada variable
+     */
+    IteradorAsignaciones(VectorArena<int>& estado,
+                         const std::vector<int>& variables,
+                         const std::vector<int>& cardinalidades);
+
+    /**
+     * Vuelve a la primera combinación (todas las variables en 0)
+     */
+    void reiniciar();
+
+    /**
+     * Salta a la combinación con el número de orden dado, sin recorrer
+     * las anteriores (permite dividir el recorrido en bloques)
+     * @param indice Número de la combinación, entre 0 y total() - 1
+     */
+    void posicionar(unsigned long long indice);
+
+    /**
+     * Indica si el estado contiene una combinación válida
+     */
+    bool valido() const;
+
+    /**
+     * Avanza a la siguiente combinación
+     * @return false si ya se recorrieron todas las combinaciones
+     */
+    bool avanzar();
+
+    /**
+     * Número total de combinaciones que recorre el iterador
+     */
+    unsigned long long total() const;
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "LectorTexto.h"
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+/**
+ * Dueño de un archivo mapeado en memoria
+ */
+struct ArchivoMapeado {
+    void* base;
+    size_t tamano;
+
+    ArchivoMapeado(void* b, size_t t) : base(b), tamano(t) {}
+    ~ArchivoMapeado() { munmap(base, tamano); }
+};
+
+}
+
+/**
+ * Constructor: lector sin archivo
+ */
+LectorTexto::LectorTexto() : actual(nullptr), fin(nullptr), numeroLinea(0) {}
+
+/**
+ * Mapea el archivo; si no es un archivo regular (o falla el mapeo) lo lee
+ * completo en el búfer propio
+ */
+bool LectorTexto::abrir(const std::string& archivo) {
+    region.reset();
+    bufer.clear();
+    actual = fin = nullptr;
+    numeroLinea = 0;
+
+    int descriptor = open(archivo.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat info;
+    if (fstat(descriptor, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        size_t tamano = static_cast<size_t>(info.st_size);
+        void* base = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (base != MAP_FAILED) {
+            close(descriptor);
+            madvise(base, tamano, MADV_SEQUENTIAL);
+            region = std::make_shared<ArchivoMapeado>(base, tamano);
+            actual = static_cast<const char*>(base);
+            fin = actual + tamano;
+            return true;
+        }
+    }
+
+    char bloque[1 << 16];
+    ssize_t leidos;
+    while ((leidos = read(descriptor, bloque, sizeof(bloque))) > 0) {
+        bufer.insert(bufer.end(), bloque, bloque + leidos);
+    }
+    close(descriptor);
+    if (leidos < 0) return false;
+    actual = bufer.data();
+    fin = actual + bufer.size();
+    return true;
+}
+
+/**
+ * Busca el siguiente salto de línea con memchr
+ */
+bool LectorTexto::siguienteLinea(std::string_view& linea) {
+    if (actual == fin) return false;
+    const char* salto = static_cast<const char*>(std::memchr(actual, '\n', fin - actual));
+    const char* finLinea = salto ? salto : fin;
+    linea = std::string_view(actual, finLinea - actual);
+    actual = salto ? salto + 1 : fin;
+    numeroLinea++;
+    return true;
+}
+
+/**
+ * Retorna el tamaño del archivo
+ */
+size_t LectorTexto::getTamano() const {
+    if (region) return static_cast<const ArchivoMapeado*>(region.get())->tamano;
+    return bufer.size();
+}
+
+/**
+ * Retorna el contenido completo
+ */
+std::string_view LectorTexto::getContenido() const {
+    const char* inicio = region ? static_cast<const char*>(static_cast<const ArchivoMapeado*>(region.get())->base)
+                                : bufer.data();
+    return std::string_view(inicio, getTamano());
+}
+
+/**
+ * Cuenta los saltos de línea anteriores a la posición
+ */
+int LectorTexto::lineaDe(const char* posicion) const {
+    std::string_view contenido = getContenido();
+    const char* p = contenido.data();
+    int linea = 1;
+    while (p < posicion) {
+        const char* salto = static_cast<const char*>(std::memchr(p, '\n', posicion - p));
+        if (!salto) break;
+        linea++;
+        p = salto + 1;
+    }
+    return linea;
+}
+
+/**
+ * Convierte con from_chars (formato general, sin configuración regional)
+ */
+bool LectorTexto::leerNumero(std::string_view token, double& valor) {
+    const char* inicio = token.data();
+    const char* final = inicio + token.size();
+    if (inicio != final && *inicio == '+') inicio++;
+    std::from_chars_result resultado = std::from_chars(inicio, final, valor);
+    return resultado.ec == std::errc() && resultado.ptr != inicio;
+}
+
+/**
+ * Convierte con from_chars y exige que se consuma todo el token
+ */
+bool LectorTexto::leerEntero(std::string_view token, long long& valor) {
+    const char* inicio = token.data();
+    const char* final = inicio + token.size();
+    if (inicio != final && *inicio == '+') inicio++;
+    std::from_chars_result resultado = std::from_chars(inicio, final, valor);
+    return resultado.ec == std::errc() && resultado.ptr == final && inicio != final;
+}
@@ -0,0 +1,121 @@
+#ifndef LECTOR_TEXTO_H
+#define LECTOR_TEXTO_H
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+/**
+ * Lector de archivos de texto sin copias
+ *
+ * Mapea el archivo completo en memoria (o lo lee en un único búfer si no
+ * se puede mapear) y entrega líneas y tokens como vistas (string_view)
+ * sobre ese búfer. Las vistas son válidas mientras viva el lector.
+ * Los números se convierten con from_chars, sin flujos ni configuración
+ * regional.
+ */
+class LectorTexto {
+private:
+    std::shared_ptr<const void> region;   // Dueño del mapeo, si lo hay
+    std::vector<char> bufer;              // Copia cuando no se pudo mapear
+    const char* actual;
+    const char* fin;
+    int numeroLinea;
+
+public:
+    LectorTexto();
+
+    /**
+     * Abre un archivo para lectura
+     * @return false si no se puede abrir (no informa en cerr)
+     */
+    bool abrir(const std::string& archivo);
+
+    /**
+     * Entrega la siguiente línea, sin el salto de línea
+     * @return false al llegar al final del archivo
+     */
+    bool siguienteLinea(std::string_view& linea);
+
+    /**
+     * Número (desde 1) de la última línea entregada
+     */
+    int getNumeroLinea() const { return numeroLinea; }
+
+    /**
+     * Tamaño total del archivo en bytes
+     */
+    size_t getTamano() const;
+
+    /**
+     * Contenido completo del archivo, para analizadores que no van por líneas
+     */
+    std::string_view getContenido() const;
+
+    /**
+     * Número de línea (desde 1) de una posición dentro del contenido
+     * Recorre el búfer desde el inicio: pensado para mensajes de error
+     */
+    int lineaDe(const char* posicion) const;
+
+    /**
+     * Indica si un carácter es un separador (espacio, tabulación, retorno...)
+     */
+    static bool esEspacio(char c) {
+        // Todos los separadores son <= ' ': una comparación y una máscara
+        const unsigned long long SEPARADORES = (1ULL << ' ') | (1ULL << '\t') | (1ULL << '\n') |
+                                               (1ULL << '\v') | (1ULL << '\f') | (1ULL << '\r');
+        unsigned char u = static_cast<unsigned char>(c);
+        return u <= ' ' && ((SEPARADORES >> u) & 1);
+    }
+
+    /**
+     * Quita los espacios al inicio y al final
+     */
+    static std::string_view recortar(std::string_view texto) {
+        size_t inicio = 0;
+        size_t final = texto.size();
+        while (inicio < final && esEspacio(texto[inicio])) inicio++;
+        while (final > inicio && esEspacio(texto[final - 1])) final--;
+        return texto.substr(inicio, final - inicio);
+    }
+
+    /**
+     * Extrae el siguiente token separado por espacios
+     * @param resto Texto pendiente; avanza hasta después del token
+     * @param token Recibe el token
+     * @return false si no quedan tokens
+     */
+    static bool siguienteToken(std::string_view& resto, std::string_view& token) {
+        const char* p = resto.data();
+        const char* final = p + resto.size();
+        while (p < final && esEspacio(*p)) p++;
+        if (p == final) {
+            resto = std::string_view();
+            return false;
+        }
+        const char* inicio = p;
+        while (p < final && !esEspacio(*p)) p++;
+        token = std::string_view(inicio, p - inicio);
+        resto = std::string_view(p, final - p);
+        return true;
+    }
+
+    /**
+     * Convierte el inicio de un token en número real
+     * Acepta un signo '+' inicial; el resto del token se ignora, como
+     * al leer con operator>>
+     * @return false si el token no comienza con un número válido
+     */
+    static bool leerNumero(std::string_view token, double& valor);
+
+    /**
+     * Convierte un token completo en entero
+     * @return false si el token no es un entero válido
+     */
+    static bool leerEntero(std::string_view token, long long& valor);
+};
+
+#endif
@@ -0,0 +1,308 @@
+#include "MuestreoGibbs.h"
+#include <random>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace {
+
+/**
+ * Elige un valor con probabilidad proporcional a su peso
+ * Si todos los pesos son cero elige de forma uniforme
+ * @param u Número uniforme en [0, 1)
+ */
+int elegirValor(const std::vector<double>& pesos, double total, double u) {
+    int card = static_cast<int>(pesos.size());
+    if (!(total > 0.0)) {
+        return std::min(static_cast<int>(u * card), card - 1);
+    }
+    double objetivo = u * total;
+    double acumulado = 0.0;
+    for (int v = 0; v < card - 1; v++) {
+        acumulado += pesos[v];
+        if (objetivo < acumulado) return v;
+    }
+    return card - 1;
+}
+
+}
+
+/**
+ * Valor de un factor en la asignación actual (orden por filas, último paso 1)
+ */
+double MuestreoGibbs::evaluar(const Factor& factor, const std::vector<int>& estado) {
+    const auto& vars = factor.getVariables();
+    const auto& cards = factor.getCardinalidades();
+    size_t posicion = 0;
+    for (size_t k = 0; k < vars.size(); k++) {
+        posicion = posicion * cards[k] + estado[vars[k]];
+    }
+    return factor[posicion];
+}
+
+/**
+ * Constructor: arma la condicional de cada nodo libre
+ * P(X | manta) ∝ P(X | padres) · Π P(hijo | padres del hijo)
+ * con la evidencia ya reducida en todas las tablas
+ */
+MuestreoGibbs::MuestreoGibbs(const std::vector<Factor>& factores, const std::vector<int>& cards,
+                             const std::vector<int>& orden, const std::map<int, int>& evidencia)
+    : cardinalidades(cards), observado(cards.size(), -1), tablas(factores), ordenTopologico(orden) {
+    for (const auto& obs : evidencia) {
+        observado[obs.first] = obs.second;
+    }
+
+    // Hijos de cada nodo: las demás variables de una tabla son sus padres
+    std::vector<std::vector<int>> hijos(cards.size());
+    for (size_t i = 0; i < factores.size(); i++) {
+        for (int v : factores[i].getVariables()) {
+            if (v != static_cast<int>(i)) hijos[v].push_back(static_cast<int>(i));
+        }
+    }
+
+    auto reducirEvidencia = [&](Factor factor) {
+        for (const auto& obs : evidencia) {
+            if (factor.contiene(obs.first)) {
+                factor = factor.reducir(obs.first, obs.second);
+            }
+        }
+        return factor;
+    };
+
+    for (int v : ordenTopologico) {
+        if (observado[v] >= 0) continue;
+
+        Condicional cond;
+        cond.variable = v;
+        cond.cardinalidad = cardinalidades[v];
+
+        // Tabla propia y tablas de los hijos
+        std::vector<Factor> familia;
+        familia.push_back(reducirEvidencia(factores[v]));
+        for (int h : hijos[v]) {
+            familia.push_back(reducirEvidencia(factores[h]));
+        }
+
+        // Manta de Markov libre: las demás variables de esas tablas
+        for (const auto& factor : familia) {
+            for (int u : factor.getVariables()) {
+                if (u != v) cond.manta.push_back(u);
+            }
+        }
+        std::sort(cond.manta.begin(), cond.manta.end());
+        cond.manta.erase(std::unique(cond.manta.begin(), cond.manta.end()), cond.manta.end());
+
+        size_t filas = 1;
+        bool cabe = true;
+        for (int u : cond.manta) {
+            filas *= cardinalidades[u];
+            if (filas * cond.cardinalidad > LIMITE_TABLA) {
+                cabe = false;
+                break;
+            }
+        }
+
+        if (!cabe) {
+            cond.familia = familia;
+            condicionales.push_back(cond);
+            continue;
+        }
+
+        // Producto de la familia con X como variable de paso 1
+        Factor producto;
+        for (const auto& factor : familia) {
+            producto = producto.producto(factor);
+        }
+        std::vector<int> ordenTabla(cond.manta);
+        ordenTabla.push_back(v);
+        std::vector<double> valores = producto.valoresEnOrden(ordenTabla);
+
+        cond.pasos.assign(cond.manta.size(), 1);
+        for (size_t k = cond.manta.size(); k-- > 1; ) {
+            cond.pasos[k - 1] = cond.pasos[k] * cardinalidades[cond.manta[k]];
+        }
+
+        // Distribución acumulada por fila (uniforme si la fila es toda cero)
+        int card = cond.cardinalidad;
+        cond.acumuladas.resize(valores.size());
+        for (size_t f = 0; f < filas; f++) {
+            const double* fila = &valores[f * card];
+            double total = 0.0;
+            for (int x = 0; x < card; x++) total += fila[x];
+            double acumulado = 0.0;
+            for (int x = 0; x < card; x++) {
+                acumulado += total > 0.0 ? fila[x] / total : 1.0 / card;
+                cond.acumuladas[f * card + x] = acumulado;
+            }
+        }
+        condicionales.push_back(cond);
+    }
+}
+
+/**
+ * Corre las cadenas y combina sus conteos
+ * Con m cadenas de n muestras y medias p_j:
+ *   W = media de las varianzas dentro de cada cadena
+ *   B/n = varianza de las medias p_j
+ *   R-hat = sqrt(((n-1)/n · W + B/n) / W)
+ * El error estándar usa medias por lotes: cada cadena se divide en lotes
+ * consecutivos y la dispersión de sus medias ya incluye la autocorrelación
+ */
+EstimacionGibbs MuestreoGibbs::estimar(const std::map<int, int>& consulta,
+                                       const ConfiguracionGibbs& config,
+                                       PoolHilos& hilos) const {
+    size_t numCadenas = config.numCadenas > 0 ? config.numCadenas : 1;
+    unsigned long long intervalo = config.intervalo > 0 ? config.intervalo : 1;
+    std::vector<std::pair<int, int>> objetivo(consulta.begin(), consulta.end());
+    std::vector<unsigned long long> aciertos(numCadenas, 0);
+
+    // Conteos por lote de cada cadena (memoria fija)
+    const unsigned long long maximoLotes = 20;
+    size_t numLotes = static_cast<size_t>(std::min(config.muestras, maximoLotes));
+    std::vector<std::vector<unsigned long long>> aciertosLote(numCadenas,
+        std::vector<unsigned long long>(numLotes, 0));
+
+    auto correrCadena = [&](size_t cadena) {
+        std::seed_seq semillas{static_cast<unsigned>(config.semilla),
+                               static_cast<unsigned>(config.semilla >> 32),
+                               static_cast<unsigned>(cadena)};
+        std::mt19937_64 generador(semillas);
+        std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+
+        std::vector<int> estado(cardinalidades.size(), 0);
+        for (size_t v = 0; v < observado.size(); v++) {
+            if (observado[v] >= 0) estado[v] = observado[v];
+        }
+        std::vector<double> pesos;
+
+        // Estado inicial: muestreo hacia adelante con la evidencia fija
+        for (int v : ordenTopologico) {
+            if (observado[v] >= 0) {
+                estado[v] = observado[v];
+                continue;
+            }
+            pesos.assign(cardinalidades[v], 0.0);
+            double total = 0.0;
+            for (int x = 0; x < cardinalidades[v]; x++) {
+                estado[v] = x;
+                pesos[x] = evaluar(tablas[v], estado);
+                total += pesos[x];
+            }
+            estado[v] = elegirValor(pesos, total, uniforme(generador));
+        }
+
+        auto barrido = [&]() {
+            for (const auto& cond : condicionales) {
+                double u = uniforme(generador);
+                int card = cond.cardinalidad;
+                int valor = card - 1;
+                if (!cond.acumuladas.empty()) {
+                    size_t fila = 0;
+                    for (size_t k = 0; k < cond.manta.size(); k++) {
+                        fila += estado[cond.manta[k]] * cond.pasos[k];
+                    }
+                    const double* acumuladas = &cond.acumuladas[fila * card];
+                    for (int x = 0; x < card - 1; x++) {
+                        if (u < acumuladas[x]) {
+                            valor = x;
+                            break;
+                        }
+                    }
+                } else {
+                    pesos.assign(card, 0.0);
+                    double total = 0.0;
+                    for (int x = 0; x < card; x++) {
+                        estado[cond.variable] = x;
+                        double p = 1.0;
+                        for (const auto& factor : cond.familia) p *= evaluar(factor, estado);
+                        pesos[x] = p;
+                        total += p;
+                    }
+                    valor = elegirValor(pesos, total, u);
+                }
+                estado[cond.variable] = valor;
+            }
+        };
+
+        for (unsigned long long b = 0; b < config.burnIn; b++) {
+            barrido();
+        }
+
+        unsigned long long cuenta = 0;
+        for (unsigned long long m = 0; m < config.muestras; m++) {
+            for (unsigned long long t = 0; t < intervalo; t++) {
+                barrido();
+            }
+            bool coincide = true;
+            for (const auto& par : objetivo) {
+                coincide = coincide && estado[par.first] == par.second;
+            }
+            if (coincide) {
+                cuenta++;
+                aciertosLote[cadena][m * numLotes / config.muestras]++;
+            }
+        }
+        aciertos[cadena] = cuenta;
+    };
+
+    hilos.ejecutar(numCadenas, correrCadena);
+
+    EstimacionGibbs resultado;
+    resultado.muestras = config.muestras * numCadenas;
+    resultado.probabilidad = 0.0;
+    resultado.errorEstandar = 0.0;
+    resultado.rHat = std::numeric_limits<double>::quiet_NaN();
+    if (config.muestras == 0) return resultado;
+
+    double n = static_cast<double>(config.muestras);
+    double m = static_cast<double>(numCadenas);
+    std::vector<double> medias(numCadenas);
+    double p = 0.0;
+    for (size_t j = 0; j < numCadenas; j++) {
+        medias[j] = aciertos[j] / n;
+        p += medias[j];
+    }
+    p /= m;
+    resultado.probabilidad = p;
+
+    // Error estándar por medias de lotes
+    std::vector<double> mediasLote;
+    for (size_t j = 0; j < numCadenas; j++) {
+        for (size_t b = 0; b < numLotes; b++) {
+            unsigned long long inicio = config.muestras * b / numLotes;
+            unsigned long long fin = config.muestras * (b + 1) / numLotes;
+            mediasLote.push_back(static_cast<double>(aciertosLote[j][b]) / (fin - inicio));
+        }
+    }
+    if (mediasLote.size() > 1) {
+        double varianzaLotes = 0.0;
+        for (double media : mediasLote) {
+            varianzaLotes += (media - p) * (media - p);
+        }
+        varianzaLotes /= (mediasLote.size() - 1.0);
+        resultado.errorEstandar = std::sqrt(varianzaLotes / mediasLote.size());
+    }
+
+    if (numCadenas < 2 || config.muestras < 2) return resultado;
+
+    double varianzaMedias = 0.0;
+    for (double media : medias) {
+        varianzaMedias += (media - p) * (media - p);
+    }
+    varianzaMedias /= (m - 1.0);
+
+    // Varianza dentro de cada cadena de un indicador: n/(n-1) · p_j (1 - p_j)
+    double dentro = 0.0;
+    for (double media : medias) {
+        dentro += n / (n - 1.0) * media * (1.0 - media);
+    }
+    dentro /= m;
+
+    double combinada = (n - 1.0) / n * dentro + varianzaMedias;
+    if (dentro > 0.0) {
+        resultado.rHat = std::sqrt(combinada / dentro);
+    } else {
+        resultado.rHat = varianzaMedias > 0.0 ? std::numeric_limits<double>::infinity() : 1.0;
+    }
+    return resultado;
+}
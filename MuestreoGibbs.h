@@ -0,0 +1,95 @@
+#ifndef MUESTREO_GIBBS_H
+#define MUESTREO_GIBBS_H
+
+#include "Factor.h"
+#include "PoolHilos.h"
+#include <vector>
+#include <map>
+
+/**
+ * Parámetros de una corrida de Gibbs
+ */
+struct ConfiguracionGibbs {
+    size_t numCadenas;              // Cadenas independientes (en paralelo)
+    unsigned long long muestras;    // Muestras conservadas por cadena
+    unsigned long long burnIn;      // Barridos descartados al inicio de cada cadena
+    unsigned long long intervalo;   // Barridos entre muestras conservadas (thinning)
+    unsigned long long semilla;     // Semilla de los generadores
+
+    ConfiguracionGibbs()
+        : numCadenas(4), muestras(10000), burnIn(1000), intervalo(1), semilla(42) {}
+};
+
+/**
+ * Resultado de una corrida de Gibbs
+ */
+struct EstimacionGibbs {
+    double probabilidad;            // Estimación de P(consulta | evidencia)
+    double errorEstandar;           // Error estándar por medias de lotes
+    double rHat;                    // Diagnóstico de Gelman-Rubin (≈ 1 al converger)
+    unsigned long long muestras;    // Muestras conservadas en total
+};
+
+/**
+ * Muestreador de Gibbs sobre la manta de Markov
+ *
+ * Cada barrido remuestrea cada nodo sin evidencia de P(X | manta de Markov),
+ * que es proporcional a P(X | padres) · Π P(hijo | padres del hijo). Estas
+ * condicionales se precalculan al construir el muestreador (con la evidencia
+ * ya aplicada) en tablas indexadas por las variables libres de la manta; cada
+ * fila guarda la distribución acumulada de X. Si la tabla de un nodo superaría
+ * el límite de tamaño, su condicional se evalúa en cada paso desde las tablas
+ * de la familia.
+ *
+ * Cada cadena solo guarda su estado y el conteo de coincidencias con la
+ * consulta, por lo que la memoria no crece con la longitud de las cadenas.
+ */
+class MuestreoGibbs {
+private:
+    // Condicional de un nodo libre dada su manta de Markov
+    struct Condicional {
+        int variable;
+        int cardinalidad;
+        std::vector<int> manta;             // Variables libres de la manta (ordenadas)
+        std::vector<size_t> pasos;          // Paso de cada variable de la manta en la tabla
+        std::vector<double> acumuladas;     // Por fila: distribución acumulada de X
+        std::vector<Factor> familia;        // Tablas a evaluar si no hay tabla precalculada
+    };
+
+    std::vector<int> cardinalidades;
+    std::vector<int> observado;                 // Valor observado por variable (-1 = libre)
+    std::vector<Condicional> condicionales;     // Una por variable libre
+    std::vector<Factor> tablas;                 // Tabla de cada nodo (para iniciar las cadenas)
+    std::vector<int> ordenTopologico;
+
+    // Máximo de valores de la tabla precalculada de un nodo
+    static const size_t LIMITE_TABLA = size_t(1) << 20;
+
+    /**
+     * Valor de un factor en la asignación actual
+     */
+    static double evaluar(const Factor& factor, const std::vector<int>& estado);
+
+public:
+    /**
+     * Constructor: precalcula las condicionales con la evidencia aplicada
+     * @param factores Tabla de cada nodo como factor (índice = nodo)
+     * @param cards Cardinalidad de cada variable
+     * @param orden Orden topológico de los nodos
+     * @param evidencia Índice de nodo -> índice de valor observado
+     */
+    MuestreoGibbs(const std::vector<Factor>& factores, const std::vector<int>& cards,
+                  const std::vector<int>& orden, const std::map<int, int>& evidencia);
+
+    /**
+     * Estima P(consulta | evidencia) con varias cadenas en paralelo
+     * @param consulta Índice de nodo -> índice de valor consultado
+     * @param config Número de cadenas, muestras, burn-in, intervalo y semilla
+     * @param hilos Grupo de hilos que procesa las cadenas
+     */
+    EstimacionGibbs estimar(const std::map<int, int>& consulta,
+                            const ConfiguracionGibbs& config,
+                            PoolHilos& hilos) const;
+};
+
+#endif
@@ -1,17 +1,17 @@
 #include "Nodo.h"
 #include <iostream>
 #include <iomanip>
-#include <sstream>
+#include <limits>
 
 /**
  * Constructor: inicializa un nodo con su nombre
  */
-Nodo::Nodo(const std::string& nom) : nombre(nom) {}
+Nodo::Nodo(const std::string& nom) : nombre(nom), datosTabla(nullptr), tamanoTabla(0) {}
 
 /**
  * Retorna el nombre del nodo
  */
-std::string Nodo::getNombre() const {
+const std::string& Nodo::getNombre() const {
     return nombre;
 }
 
@@ -20,15 +20,37 @@ std::string Nodo::getNombre() const {
  */
 void Nodo::setDominio(const std::vector<std::string>& valores) {
     dominio = valores;
+    indiceDominio.clear();
+    for (size_t i = 0; i < dominio.size(); i++) {
+        indiceDominio[dominio[i]] = static_cast<int>(i);
+    }
 }
 
 /**
  * Obtiene el dominio de valores
  */
-std::vector<std::string> Nodo::getDominio() const {
+const std::vector<std::string>& Nodo::getDominio() const {
     return dominio;
 }
 
+/**
+ * Busca la posición de un valor en el dominio
+ */
+int Nodo::indiceValor(const std::string& valor) const {
+    auto it = indiceDominio.find(valor);
+    if (it != indiceDominio.end()) {
+        return it->second;
+    }
+    return -1;
+}
+
+/**
+ * Retorna el tamaño del dominio
+ */
+size_t Nodo::getCardinalidad() const {
+    return dominio.size();
+}
+
 /**
  * Agrega un padre al nodo
  */
@@ -46,39 +68,173 @@ void Nodo::agregarHijo(std::shared_ptr<Nodo> hijo) {
 /**
  * Retorna el vector de padres
  */
-std::vector<std::shared_ptr<Nodo>> Nodo::getPadres() const {
+const std::vector<std::shared_ptr<Nodo>>& Nodo::getPadres() const {
     return padres;
 }
 
 /**
- * Retorna el vector de hijos
+ * Retorna los hijos que todavía existen
  */
 std::vector<std::shared_ptr<Nodo>> Nodo::getHijos() const {
-    return hijos;
+    std::vector<std::shared_ptr<Nodo>> vivos;
+    for (const auto& hijo : hijos) {
+        if (std::shared_ptr<Nodo> nodo = hijo.lock()) vivos.push_back(nodo);
+    }
+    return vivos;
 }
 
 /**
- * Convierte un vector de valores en una clave string única
- * Ejemplo: ["none", "yes"] -> "none,yes"
+ * Calcula los pasos de los padres (el último padre tiene paso 1)
+ * @return Tamaño de la tabla: filas * |dominio|
  */
-std::string Nodo::vectorAString(const std::vector<std::string>& valores) const {
-    if (valores.empty()) return "";
-    
-    std::string resultado = valores[0];
-    for (size_t i = 1; i < valores.size(); i++) {
-        resultado += "," + valores[i];
+size_t Nodo::calcularPasos() {
+    pasosPadres.assign(padres.size(), 1);
+    size_t filas = 1;
+    for (size_t k = padres.size(); k-- > 0; ) {
+        pasosPadres[k] = filas;
+        filas *= padres[k]->getCardinalidad();
+    }
+    return filas * dominio.size();
+}
+
+/**
+ * Retorna la cardinalidad de cada padre seguida de la del nodo
+ */
+std::vector<size_t> Nodo::formaActual() const {
+    std::vector<size_t> forma;
+    forma.reserve(padres.size() + 1);
+    for (const auto& padre : padres) forma.push_back(padre->getCardinalidad());
+    forma.push_back(dominio.size());
+    return forma;
+}
+
+/**
+ * Calcula los pasos de los padres y redimensiona la tabla
+ * Se reinicia la tabla si cambia su forma: con el mismo tamaño total pero
+ * otras cardinalidades (2x3 -> 3x2) cada posición significa otra fila
+ */
+void Nodo::prepararTabla() {
+    size_t total = calcularPasos();
+    std::vector<size_t> forma = formaActual();
+    if (tamanoTabla != total || formaTabla != forma) {
+        regionExterna.reset();
+        tabla.assign(total, std::numeric_limits<double>::quiet_NaN());
+        datosTabla = tabla.data();
+        tamanoTabla = total;
+        formaTabla = std::move(forma);
+    }
+}
+
+/**
+ * Pasa a usar una tabla externa sin copiarla
+ */
+bool Nodo::usarTablaExterna(const double* datos, size_t tamano,
+                            std::shared_ptr<const void> region) {
+    if (calcularPasos() != tamano) return false;
+    tabla.clear();
+    tabla.shrink_to_fit();
+    datosTabla = datos;
+    tamanoTabla = tamano;
+    formaTabla = formaActual();
+    regionExterna = region;
+    return true;
+}
+
+/**
+ * Copia el estado de la tabla tal como está en el origen
+ */
+void Nodo::copiarTablaDe(const Nodo& origen) {
+    pasosPadres = origen.pasosPadres;
+    formaTabla = origen.formaTabla;
+    tamanoTabla = origen.tamanoTabla;
+    regionExterna = origen.regionExterna;
+    if (regionExterna) {
+        tabla.clear();
+        datosTabla = origen.datosTabla;
+    } else {
+        tabla = origen.tabla;
+        datosTabla = origen.datosTabla ? tabla.data() : nullptr;
+    }
+}
+
+/**
+ * Copia la tabla externa a memoria propia (copia en escritura)
+ */
+void Nodo::adoptarTablaExterna() {
+    if (!regionExterna) return;
+    tabla.assign(datosTabla, datosTabla + tamanoTabla);
+    datosTabla = tabla.data();
+    regionExterna.reset();
+}
+
+/**
+ * Retorna la tabla densa
+ */
+const double* Nodo::getTabla() const {
+    return datosTabla;
+}
+
+/**
+ * Retorna el número de valores de la tabla densa
+ */
+size_t Nodo::getTamanoTabla() const {
+    return tamanoTabla;
+}
+
+/**
+ * Calcula la fila de la tabla para los índices de los padres
+ */
+size_t Nodo::indiceFila(const std::vector<int>& indicesPadres) const {
+    size_t fila = 0;
+    for (size_t k = 0; k < indicesPadres.size(); k++) {
+        fila += indicesPadres[k] * pasosPadres[k];
     }
-    return resultado;
+    return fila;
+}
+
+/**
+ * Retorna los pasos de los padres
+ */
+const std::vector<size_t>& Nodo::getPasosPadres() const {
+    return pasosPadres;
+}
+
+/**
+ * Retorna el número de filas de la tabla
+ */
+size_t Nodo::getNumeroFilas() const {
+    return dominio.empty() ? 0 : tamanoTabla / dominio.size();
 }
 
 /**
  * Establece la probabilidad condicional
  */
-void Nodo::setProbabilidad(const std::vector<std::string>& valoresPadres,
+bool Nodo::setProbabilidad(const std::vector<std::string>& valoresPadres,
                           const std::string& valorNodo,
                           double probabilidad) {
-    std::string clave = vectorAString(valoresPadres);
-    tablaProbabilidad[clave][valorNodo] = probabilidad;
+    prepararTabla();
+    
+    int valor = indiceValor(valorNodo);
+    if (valor < 0 || valoresPadres.size() != padres.size()) return false;
+    
+    size_t fila = 0;
+    for (size_t k = 0; k < padres.size(); k++) {
+        int indice = padres[k]->indiceValor(valoresPadres[k]);
+        if (indice < 0) return false;
+        fila += indice * pasosPadres[k];
+    }
+    
+    adoptarTablaExterna();
+    tabla[fila * dominio.size() + valor] = probabilidad;
+    return true;
+}
+
+/**
+ * Establece la probabilidad por índices
+ */
+void Nodo::setProbabilidad(int indiceValor, size_t fila, double probabilidad) {
+    adoptarTablaExterna();
+    tabla[fila * dominio.size() + indiceValor] = probabilidad;
 }
 
 /**
@@ -86,14 +242,19 @@ void Nodo::setProbabilidad(const std::vector<std::string>& valoresPadres,
  */
 double Nodo::getProbabilidad(const std::string& valorNodo,
                             const std::vector<std::string>& valoresPadres) const {
-    std::string clave = vectorAString(valoresPadres);
+    int valor = indiceValor(valorNodo);
+    bool valido = valor >= 0 && valoresPadres.size() == padres.size() &&
+                  tamanoTabla > 0;
     
-    auto it = tablaProbabilidad.find(clave);
-    if (it != tablaProbabilidad.end()) {
-        auto it2 = it->second.find(valorNodo);
-        if (it2 != it->second.end()) {
-            return it2->second;
-        }
+    size_t fila = 0;
+    for (size_t k = 0; valido && k < padres.size(); k++) {
+        int indice = padres[k]->indiceValor(valoresPadres[k]);
+        valido = indice >= 0;
+        fila += valido ? indice * pasosPadres[k] : 0;
+    }
+    
+    if (valido) {
+        return getProbabilidad(valor, fila);
     }
     
     // Si no se encuentra, retornar probabilidad uniforme
@@ -131,18 +292,20 @@ void Nodo::mostrarTablaProbabilidad() const {
     std::cout << "}\n";
     std::cout << "========================================\n";
     
+    size_t card = dominio.size();
+    size_t filas = getNumeroFilas();
+    
     if (padres.empty()) {
         // Nodo sin padres (raíz)
         std::cout << "P(" << nombre << ")\n";
         std::cout << "----------------------------------------\n";
         
-        auto it = tablaProbabilidad.find("");
-        if (it != tablaProbabilidad.end()) {
-            for (const auto& par : it->second) {
-                std::cout << std::setw(12) << par.first << " | " 
-                         << std::fixed << std::setprecision(2) 
-                         << par.second << "\n";
-            }
+        for (size_t v = 0; v < card && filas > 0; v++) {
+            double p = datosTabla[v];
+            if (p != p) continue;
+            std::cout << std::setw(12) << dominio[v] << " | " 
+                     << std::fixed << std::setprecision(2) 
+                     << p << "\n";
         }
     } else {
         // Nodo con padres - mostrar encabezado
@@ -156,28 +319,27 @@ void Nodo::mostrarTablaProbabilidad() const {
         std::cout << "\n";
         std::cout << std::string(10 * (padres.size() + dominio.size() + 1), '-') << "\n";
         
-        // Mostrar cada fila de la tabla
-        for (const auto& entrada : tablaProbabilidad) {
-            // Separar la clave en valores individuales
-            std::vector<std::string> valores;
-            std::stringstream ss(entrada.first);
-            std::string valor;
-            while (std::getline(ss, valor, ',')) {
-                valores.push_back(valor);
+        // Mostrar cada fila definida de la tabla
+        for (size_t fila = 0; fila < filas; fila++) {
+            const double* entrada = &datosTabla[fila * card];
+            bool definida = false;
+            for (size_t v = 0; v < card; v++) {
+                definida = definida || entrada[v] == entrada[v];
             }
+            if (!definida) continue;
             
-            // Mostrar valores de padres
-            for (const auto& v : valores) {
-                std::cout << std::setw(10) << v;
+            // Decodificar los valores de los padres a partir de la fila
+            for (size_t k = 0; k < padres.size(); k++) {
+                size_t indice = (fila / pasosPadres[k]) % padres[k]->getCardinalidad();
+                std::cout << std::setw(10) << padres[k]->getDominio()[indice];
             }
             std::cout << " |";
             
             // Mostrar probabilidades para cada valor del nodo
-            for (const auto& d : dominio) {
-                auto it = entrada.second.find(d);
-                if (it != entrada.second.end()) {
+            for (size_t v = 0; v < card; v++) {
+                if (entrada[v] == entrada[v]) {
                     std::cout << std::setw(10) << std::fixed 
-                             << std::setprecision(2) << it->second;
+                             << std::setprecision(2) << entrada[v];
                 } else {
                     std::cout << std::setw(10) << "---";
                 }
@@ -14,13 +14,42 @@ class Nodo {
 private:
     std::string nombre;                          // Nombre del nodo
     std::vector<std::shared_ptr<Nodo>> padres;  // Nodos predecesores
-    std::vector<std::shared_ptr<Nodo>> hijos;   // Nodos sucesores
+    std::vector<std::weak_ptr<Nodo>> hijos;     // Nodos sucesores (débiles: sin ciclo con padres)
     std::vector<std::string> dominio;            // Valores posibles del nodo
+    std::map<std::string, int> indiceDominio;    // Valor -> posición en el dominio
     
-    // Tabla de probabilidad condicional
-    // La clave es una combinación de valores de los padres (como string)
-    // El valor es un mapa: valor_nodo -> probabilidad
-    std::map<std::string, std::map<std::string, double>> tablaProbabilidad;
+    // Tabla de probabilidad condicional en un único arreglo contiguo
+    // Cada fila corresponde a una combinación de valores de los padres y
+    // contiene una probabilidad por cada valor del dominio:
+    //   posición = fila * |dominio| + índice del valor
+    // La fila se obtiene en base mixta sobre los dominios de los padres:
+    //   fila = Σ índice(padre_k) * pasosPadres[k]   (el último padre tiene paso 1)
+    // Las entradas no definidas se marcan con NaN
+    std::vector<double> tabla;
+    std::vector<size_t> pasosPadres;
+    std::vector<size_t> formaTabla;             // Cardinalidad de cada padre y |dominio| con que se armó la tabla
+    
+    // Tabla en uso: apunta a la tabla propia o a una región externa de solo
+    // lectura (por ejemplo, una imagen binaria mapeada en memoria), que se
+    // mantiene viva mientras el nodo la use
+    const double* datosTabla;
+    size_t tamanoTabla;
+    std::shared_ptr<const void> regionExterna;
+    
+    /**
+     * Calcula el paso de cada padre y el tamaño que debe tener la tabla
+     */
+    size_t calcularPasos();
+    
+    /**
+     * Forma actual de la tabla: cardinalidad de cada padre y del nodo
+     */
+    std::vector<size_t> formaActual() const;
+    
+    /**
+     * Copia la tabla externa a la tabla propia antes de modificarla
+     */
+    void adoptarTablaExterna();
 
 public:
     /**
@@ -29,10 +58,13 @@ public:
      */
     Nodo(const std::string& nom);
     
+    Nodo(const Nodo&) = delete;
+    Nodo& operator=(const Nodo&) = delete;
+    
     /**
      * Obtiene el nombre del nodo
      */
-    std::string getNombre() const;
+    const std::string& getNombre() const;
     
     /**
      * Establece el dominio de valores del nodo
@@ -43,7 +75,18 @@ public:
     /**
      * Obtiene el dominio de valores
      */
-    std::vector<std::string> getDominio() const;
+    const std::vector<std::string>& getDominio() const;
+    
+    /**
+     * Obtiene la posición de un valor dentro del dominio
+     * @return Índice del valor o -1 si no pertenece al dominio
+     */
+    int indiceValor(const std::string& valor) const;
+    
+    /**
+     * Obtiene el número de valores del dominio
+     */
+    size_t getCardinalidad() const;
     
     /**
      * Agrega un nodo padre
@@ -58,20 +101,29 @@ public:
     /**
      * Obtiene la lista de padres
      */
-    std::vector<std::shared_ptr<Nodo>> getPadres() const;
+    const std::vector<std::shared_ptr<Nodo>>& getPadres() const;
     
     /**
-     * Obtiene la lista de hijos
+     * Obtiene la lista de hijos que siguen vivos
+     * Arma un vector nuevo; la inferencia usa GrafoCompilado
      */
     std::vector<std::shared_ptr<Nodo>> getHijos() const;
     
+    /**
+     * Ajusta el tamaño de la tabla a los dominios actuales del nodo y
+     * de sus padres. Si cambia la forma (cardinalidad de algún padre o del
+     * nodo), la tabla se reinicia aunque el tamaño total sea el mismo
+     */
+    void prepararTabla();
+    
     /**
      * Establece la probabilidad para una configuración específica
      * @param valoresPadres Valores de los padres como vector de strings
      * @param valorNodo Valor del nodo
      * @param probabilidad Probabilidad P(nodo=valorNodo|padres)
+     * @return false si algún valor no pertenece a su dominio
      */
-    void setProbabilidad(const std::vector<std::string>& valoresPadres, 
+    bool setProbabilidad(const std::vector<std::string>& valoresPadres, 
                         const std::string& valorNodo, 
                         double probabilidad);
     
@@ -84,6 +136,71 @@ public:
     double getProbabilidad(const std::string& valorNodo, 
                           const std::vector<std::string>& valoresPadres) const;
     
+    /**
+     * Obtiene la probabilidad usando índices enteros (sin búsquedas)
+     * @param indiceValor Posición del valor del nodo en su dominio
+     * @param fila Fila de la tabla (ver indiceFila)
+     * @return Probabilidad P(nodo=valor|padres)
+     */
+    double getProbabilidad(int indiceValor, size_t fila) const {
+        double p = datosTabla[fila * dominio.size() + indiceValor];
+        // Entrada no definida: probabilidad uniforme
+        return p == p ? p : 1.0 / dominio.size();
+    }
+    
+    /**
+     * Establece la probabilidad usando índices enteros (sin búsquedas)
+     * La tabla ya debe estar preparada (ver prepararTabla)
+     * @param indiceValor Posición del valor del nodo en su dominio
+     * @param fila Fila de la tabla (ver indiceFila)
+     * @param probabilidad Probabilidad P(nodo=valor|padres)
+     */
+    void setProbabilidad(int indiceValor, size_t fila, double probabilidad);
+    
+    /**
+     * Usa una tabla externa de solo lectura en lugar de la propia
+     * Los padres y dominios ya deben estar definidos. Si luego se modifica
+     * una probabilidad, la tabla se copia primero a memoria propia
+     * @param datos Tabla densa con el mismo formato que la propia
+     * @param tamano Número de valores (debe ser filas * |dominio|)
+     * @param region Dueño de la memoria de los datos
+     * @return false si el tamaño no coincide con las dimensiones del nodo
+     */
+    bool usarTablaExterna(const double* datos, size_t tamano,
+                          std::shared_ptr<const void> region);
+    
+    /**
+     * Toma la tabla de otro nodo con los mismos padres y dominios
+     * Una tabla externa se comparte (es de solo lectura); la propia se copia
+     */
+    void copiarTablaDe(const Nodo& origen);
+    
+    /**
+     * Acceso a la tabla densa (nulo si aún no se preparó)
+     */
+    const double* getTabla() const;
+    
+    /**
+     * Número de valores de la tabla densa
+     */
+    size_t getTamanoTabla() const;
+    
+    /**
+     * Calcula la fila de la tabla para una combinación de padres
+     * @param indicesPadres Índice del valor de cada padre en su dominio
+     */
+    size_t indiceFila(const std::vector<int>& indicesPadres) const;
+    
+    /**
+     * Obtiene el paso (en filas) de cada padre dentro de la tabla
+     */
+    const std::vector<size_t>& getPasosPadres() const;
+    
+    /**
+     * Número de filas de la tabla (combinaciones de valores de los padres)
+     */
+    size_t getNumeroFilas() const;
+    
     /**
      * Verifica si el nodo es raíz
      */
@@ -99,11 +216,6 @@ public:
      */
     void mostrarTablaProbabilidad() const;
     
-private:
-    /**
-     * Convierte un vector de valores en una clave string
-     */
-    std::string vectorAString(const std::vector<std::string>& valores) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "NucleosFactor.h"
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RB_NUCLEOS_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Versiones escalares
+
+void multiplicarEscalares(double* destino, const double* a, const double* b, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        destino[i] = a[i] * b[i];
+    }
+}
+
+void multiplicarPorEscalarEscalares(double* destino, const double* a, double escalar, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        destino[i] = a[i] * escalar;
+    }
+}
+
+void acumularEscalares(double* destino, const double* origen, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        destino[i] += origen[i];
+    }
+}
+
+/**
+ * Suma con 16 acumuladores intercalados (el acumulador j recibe los
+ * elementos j, j + 16, j + 32...). Se combinan como cuatro vectores de 4:
+ *   t[j] = (a[j] + a[4 + j]) + (a[8 + j] + a[12 + j])
+ *   total = (t[0] + t[1]) + (t[2] + t[3])
+ * y el resto se suma en orden. Es el mismo orden que la versión AVX2
+ */
+double sumarEscalares(const double* valores, size_t cantidad) {
+    const size_t carriles = NucleosFactor::CARRILES_SUMA;
+    double acumulador[carriles] = {};
+    size_t i = 0;
+    for (; i + carriles <= cantidad; i += carriles) {
+        for (size_t j = 0; j < carriles; j++) {
+            acumulador[j] += valores[i + j];
+        }
+    }
+    double t[4];
+    for (size_t j = 0; j < 4; j++) {
+        t[j] = (acumulador[j] + acumulador[4 + j]) + (acumulador[8 + j] + acumulador[12 + j]);
+    }
+    double total = (t[0] + t[1]) + (t[2] + t[3]);
+    for (; i < cantidad; i++) {
+        total += valores[i];
+    }
+    return total;
+}
+
+void dividirEscalares(double* valores, double divisor, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        valores[i] /= divisor;
+    }
+}
+
+void dividirElementosEscalares(double* valores, const double* divisores, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        valores[i] /= divisores[i];
+    }
+}
+
+const NucleosFactor::Tabla ESCALARES = {
+    "escalar",
+    multiplicarEscalares,
+    multiplicarPorEscalarEscalares,
+    acumularEscalares,
+    sumarEscalares,
+    dividirEscalares,
+    dividirElementosEscalares
+};
+
+#ifdef RB_NUCLEOS_AVX2
+
+// Versiones AVX2: bloques de 4 doubles con cargas no alineadas; el resto
+// del tramo (menos de 4 elementos) se procesa como en la versión escalar
+
+__attribute__((target("avx2")))
+void multiplicarAvx2(double* destino, const double* a, const double* b, size_t cantidad) {
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm256_storeu_pd(destino + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (; i < cantidad; i++) {
+        destino[i] = a[i] * b[i];
+    }
+}
+
+__attribute__((target("avx2")))
+void multiplicarPorEscalarAvx2(double* destino, const double* a, double escalar, size_t cantidad) {
+    __m256d factor = _mm256_set1_pd(escalar);
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm256_storeu_pd(destino + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), factor));
+    }
+    for (; i < cantidad; i++) {
+        destino[i] = a[i] * escalar;
+    }
+}
+
+__attribute__((target("avx2")))
+void acumularAvx2(double* destino, const double* origen, size_t cantidad) {
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm256_storeu_pd(destino + i, _mm256_add_pd(_mm256_loadu_pd(destino + i), _mm256_loadu_pd(origen + i)));
+    }
+    for (; i < cantidad; i++) {
+        destino[i] += origen[i];
+    }
+}
+
+__attribute__((target("avx2")))
+double sumarAvx2(const double* valores, size_t cantidad) {
+    // Cuatro acumuladores independientes para no esperar la latencia de cada suma
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= cantidad; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(valores + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(valores + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(valores + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(valores + i + 12));
+    }
+    __m256d acumulador = _mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3));
+    double carriles[4];
+    _mm256_storeu_pd(carriles, acumulador);
+    double total = (carriles[0] + carriles[1]) + (carriles[2] + carriles[3]);
+    for (; i < cantidad; i++) {
+        total += valores[i];
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+void dividirAvx2(double* valores, double divisor, size_t cantidad) {
+    __m256d d = _mm256_set1_pd(divisor);
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm256_storeu_pd(valores + i, _mm256_div_pd(_mm256_loadu_pd(valores + i), d));
+    }
+    for (; i < cantidad; i++) {
+        valores[i] /= divisor;
+    }
+}
+
+__attribute__((target("avx2")))
+void dividirElementosAvx2(double* valores, const double* divisores, size_t cantidad) {
+    size_t i = 0;
+    for (; i + 4 <= cantidad; i += 4) {
+        _mm256_storeu_pd(valores + i, _mm256_div_pd(_mm256_loadu_pd(valores + i), _mm256_loadu_pd(divisores + i)));
+    }
+    for (; i < cantidad; i++) {
+        valores[i] /= divisores[i];
+    }
+}
+
+const NucleosFactor::Tabla AVX2 = {
+    "avx2",
+    multiplicarAvx2,
+    multiplicarPorEscalarAvx2,
+    acumularAvx2,
+    sumarAvx2,
+    dividirAvx2,
+    dividirElementosAvx2
+};
+
+#endif
+
+/**
+ * Núcleos en uso; se inicializa al primer uso con los mejores disponibles
+ */
+std::atomic<const NucleosFactor::Tabla*>& enUso() {
+    static std::atomic<const NucleosFactor::Tabla*> tabla(
+        NucleosFactor::avx2() ? NucleosFactor::avx2() : &ESCALARES);
+    return tabla;
+}
+
+}
+
+/**
+ * Retorna los núcleos escalares
+ */
+const NucleosFactor::Tabla& NucleosFactor::escalares() {
+    return ESCALARES;
+}
+
+/**
+ * Retorna los núcleos AVX2 si la CPU los soporta
+ */
+const NucleosFactor::Tabla* NucleosFactor::avx2() {
+#ifdef RB_NUCLEOS_AVX2
+    static const bool disponible = __builtin_cpu_supports("avx2");
+    return disponible ? &AVX2 : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+/**
+ * Retorna los núcleos en uso
+ */
+const NucleosFactor::Tabla& NucleosFactor::activos() {
+    return *enUso().load(std::memory_order_relaxed);
+}
+
+/**
+ * Elige entre los núcleos AVX2 (si hay) y los escalares
+ */
+void NucleosFactor::seleccionar(bool permitirAvx2) {
+    const Tabla* tabla = permitirAvx2 && avx2() ? avx2() : &ESCALARES;
+    enUso().store(tabla, std::memory_order_relaxed);
+}
@@ -0,0 +1,74 @@
+#ifndef NUCLEOS_FACTOR_H
+#define NUCLEOS_FACTOR_H
+
+#include <cstddef>
+
+/**
+ * Núcleos numéricos de las operaciones con factores
+ *
+ * El producto, la suma de una variable y la normalización se reducen a
+ * recorridos de tramos contiguos de doubles. Cada núcleo tiene una versión
+ * escalar y una AVX2 (4 doubles por instrucción); la AVX2 se elige al
+ * primer uso si la CPU la soporta (__builtin_cpu_supports), de modo que el
+ * mismo binario corre en cualquier x86-64.
+ *
+ * Las dos versiones dan resultados idénticos bit a bit: las operaciones
+ * elemento a elemento no cambian el redondeo, y las sumas usan en ambas el
+ * mismo orden (CARRILES_SUMA acumuladores intercalados que se combinan al
+ * final; ver sumarEscalares). Con menos elementos que carriles la suma es
+ * la secuencial de siempre.
+ */
+class NucleosFactor {
+public:
+    static constexpr size_t CARRILES_SUMA = 16;
+
+    /**
+     * Conjunto de núcleos de una implementación
+     * Los arreglos de destino no se solapan con los de origen
+     */
+    struct Tabla {
+        const char* nombre;
+
+        // destino[i] = a[i] * b[i]
+        void (*multiplicar)(double* destino, const double* a, const double* b, size_t cantidad);
+
+        // destino[i] = a[i] * escalar (un operando que no depende del tramo)
+        void (*multiplicarEscalar)(double* destino, const double* a, double escalar, size_t cantidad);
+
+        // destino[i] += origen[i]
+        void (*acumular)(double* destino, const double* origen, size_t cantidad);
+
+        // Σ valores[i]
+        double (*sumar)(const double* valores, size_t cantidad);
+
+        // valores[i] /= divisor
+        void (*dividir)(double* valores, double divisor, size_t cantidad);
+
+        // valores[i] /= divisores[i]
+        void (*dividirElementos)(double* valores, const double* divisores, size_t cantidad);
+    };
+
+    /**
+     * Núcleos escalares (disponibles siempre)
+     */
+    static const Tabla& escalares();
+
+    /**
+     * Núcleos AVX2
+     * @return nulo si la CPU no soporta AVX2 o el compilador no es x86-64
+     */
+    static const Tabla* avx2();
+
+    /**
+     * Núcleos en uso: AVX2 si está disponible, salvo que se desactive
+     */
+    static const Tabla& activos();
+
+    /**
+     * Elige los núcleos en uso (para comparar implementaciones)
+     * @param permitirAvx2 false fuerza los núcleos escalares
+     */
+    static void seleccionar(bool permitirAvx2);
+};
+
+#endif
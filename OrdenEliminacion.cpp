@@ -0,0 +1,175 @@
+#include "OrdenEliminacion.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * Agrega b a la lista ordenada de vecinos de a (si no estaba)
+ */
+void conectar(std::vector<std::vector<int>>& vecinos, int a, int b) {
+    auto it = std::lower_bound(vecinos[a].begin(), vecinos[a].end(), b);
+    if (it == vecinos[a].end() || *it != b) {
+        vecinos[a].insert(it, b);
+    }
+}
+
+bool conectadas(const std::vector<std::vector<int>>& vecinos, int a, int b) {
+    return std::binary_search(vecinos[a].begin(), vecinos[a].end(), b);
+}
+
+}
+
+/**
+ * Simula la eliminación
+ * 1. Arma el grafo moral: las variables de cada alcance quedan conectadas
+ * 2. En cada paso puntúa las ocultas pendientes con la heurística y elige
+ *    la menor (desempate por tamaño del factor intermedio y luego por
+ *    posición en la lista); solo se recalculan los puntajes que cambiaron
+ * 3. Registra su clique, conecta sus vecinos entre sí y la retira del grafo
+ */
+OrdenEliminacion::OrdenEliminacion(const std::vector<std::vector<int>>& alcances,
+                                   const std::vector<int>& ocultas,
+                                   const std::vector<int>& cardinalidades,
+                                   HeuristicaOrden heuristica) {
+    costo.anchoInducido = 0;
+    costo.entradasMaximas = 1.0;
+    costo.entradasTotales = 0.0;
+
+    size_t n = cardinalidades.size();
+    std::vector<std::vector<int>> vecinos(n);
+    std::vector<bool> presente(n, false);    // Aparece en algún factor y no se eliminó
+    for (const auto& vars : alcances) {
+        for (int a : vars) {
+            presente[a] = true;
+            for (int b : vars) {
+                if (a != b) conectar(vecinos, a, b);
+            }
+        }
+    }
+
+    // Combinaciones de la variable junto con sus vecinos, multiplicadas en
+    // orden de índice (sin factores que la mencionen, el producto es la unidad)
+    auto tamanoClique = [&](int v) {
+        if (!presente[v]) return 1.0;
+        double tamano = 1.0;
+        bool incluida = false;
+        for (int u : vecinos[v]) {
+            if (!incluida && v < u) {
+                tamano *= cardinalidades[v];
+                incluida = true;
+            }
+            tamano *= cardinalidades[u];
+        }
+        if (!incluida) tamano *= cardinalidades[v];
+        return tamano;
+    };
+
+    auto puntaje = [&](int v, double tamano) {
+        const std::vector<int>& lista = vecinos[v];
+        switch (heuristica) {
+            case HeuristicaOrden::GRADO_MINIMO:
+                return static_cast<double>(lista.size());
+            case HeuristicaOrden::RELLENO_MINIMO:
+            case HeuristicaOrden::RELLENO_PONDERADO: {
+                double relleno = 0.0;
+                for (size_t a = 0; a < lista.size(); a++) {
+                    for (size_t b = a + 1; b < lista.size(); b++) {
+                        if (conectadas(vecinos, lista[a], lista[b])) continue;
+                        relleno += heuristica == HeuristicaOrden::RELLENO_MINIMO ? 1.0 :
+                            static_cast<double>(cardinalidades[lista[a]]) * cardinalidades[lista[b]];
+                    }
+                }
+                return relleno;
+            }
+            case HeuristicaOrden::TAMANO_MINIMO:
+            default:
+                return tamano;
+        }
+    };
+
+    // Puntajes por variable; al eliminar una variable solo cambian los de sus
+    // vecinos (pierden un vecino o ganan aristas) y los de los vecinos de
+    // estos (las aristas de relleno pueden unir a dos de sus vecinos)
+    std::vector<double> puntajes(n, 0.0), tamanos(n, 0.0);
+    std::vector<bool> vigente(n, false);
+
+    std::vector<int> pendientes(ocultas);
+    orden.reserve(pendientes.size());
+    while (!pendientes.empty()) {
+        size_t mejor = 0;
+        for (size_t h = 0; h < pendientes.size(); h++) {
+            int v = pendientes[h];
+            if (!vigente[v]) {
+                tamanos[v] = tamanoClique(v);
+                puntajes[v] = puntaje(v, tamanos[v]);
+                vigente[v] = true;
+            }
+            int m = pendientes[mejor];
+            if (puntajes[v] < puntajes[m] || (puntajes[v] == puntajes[m] && tamanos[v] < tamanos[m])) {
+                mejor = h;
+            }
+        }
+        int variable = pendientes[mejor];
+        pendientes.erase(pendientes.begin() + mejor);
+        orden.push_back(variable);
+        if (!presente[variable]) continue;
+
+        double tamano = tamanos[variable];
+        std::vector<int> clique(vecinos[variable]);
+        clique.insert(std::lower_bound(clique.begin(), clique.end(), variable), variable);
+        costo.anchoInducido = std::max(costo.anchoInducido, clique.size() - 1);
+        costo.entradasMaximas = std::max(costo.entradasMaximas, tamano);
+        costo.entradasTotales += tamano;
+        cliques.push_back(std::move(clique));
+
+        // Aristas de relleno y retiro de la variable
+        for (int a : vecinos[variable]) {
+            for (int b : vecinos[variable]) {
+                if (a != b) conectar(vecinos, a, b);
+            }
+            vecinos[a].erase(std::lower_bound(vecinos[a].begin(), vecinos[a].end(), variable));
+        }
+        for (int a : vecinos[variable]) {
+            vigente[a] = false;
+            for (int b : vecinos[a]) vigente[b] = false;
+        }
+        vecinos[variable].clear();
+        presente[variable] = false;
+    }
+
+    // Producto final de las variables que quedan en algún factor
+    size_t restantes = 0;
+    double tamanoFinal = 1.0;
+    for (size_t v = 0; v < n; v++) {
+        if (!presente[v]) continue;
+        restantes++;
+        tamanoFinal *= cardinalidades[v];
+    }
+    if (restantes > 0) {
+        costo.anchoInducido = std::max(costo.anchoInducido, restantes - 1);
+    }
+    costo.entradasMaximas = std::max(costo.entradasMaximas, tamanoFinal);
+    costo.entradasTotales += tamanoFinal;
+    costo.bytesMaximos = costo.entradasMaximas * sizeof(double);
+}
+
+/**
+ * Retorna las variables en el orden de eliminación
+ */
+const std::vector<int>& OrdenEliminacion::getOrden() const {
+    return orden;
+}
+
+/**
+ * Retorna el clique de cada variable eliminada
+ */
+const std::vector<std::vector<int>>& OrdenEliminacion::getCliques() const {
+    return cliques;
+}
+
+/**
+ * Retorna el costo del orden
+ */
+const CostoEliminacion& OrdenEliminacion::getCosto() const {
+    return costo;
+}
@@ -0,0 +1,79 @@
+#ifndef ORDEN_ELIMINACION_H
+#define ORDEN_ELIMINACION_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * Heurísticas para elegir la siguiente variable a eliminar
+ * Todas miran el grafo moral (dos variables son vecinas si comparten un
+ * factor) y desempatan por el tamaño del factor intermedio
+ */
+enum class HeuristicaOrden {
+    TAMANO_MINIMO,       // Factor intermedio con menos combinaciones
+    GRADO_MINIMO,        // Menos vecinos
+    RELLENO_MINIMO,      // Menos aristas nuevas entre los vecinos
+    RELLENO_PONDERADO    // Menor suma de card(a) * card(b) de las aristas nuevas
+};
+
+/**
+ * Costo de eliminar las variables en un orden, calculado sin tocar los valores
+ */
+struct CostoEliminacion {
+    size_t anchoInducido;       // Variables del factor más grande menos una
+    double entradasMaximas;     // Combinaciones del factor más grande
+    double bytesMaximos;        // Memoria de ese factor (entradas * sizeof(double))
+    double entradasTotales;     // Suma de las combinaciones de todos los productos
+};
+
+/**
+ * Orden de eliminación de variables y su costo
+ *
+ * Simula la eliminación sobre el grafo moral de los alcances: al eliminar
+ * una variable, el producto de los factores que la mencionan tiene como
+ * alcance la variable y sus vecinos (su clique), y al sumarla sus vecinos
+ * quedan conectados entre sí (aristas de relleno). El costo incluye el
+ * producto final de las variables que no se eliminan.
+ *
+ * Con TAMANO_MINIMO y el mismo orden de candidatos se obtiene exactamente
+ * el orden voraz que usaba la eliminación de variables; RELLENO_MINIMO es la
+ * triangulación del árbol de cliques.
+ */
+class OrdenEliminacion {
+private:
+    std::vector<int> orden;                     // Variables en el orden elegido
+    std::vector<std::vector<int>> cliques;      // Clique de cada variable eliminada (ordenado)
+    CostoEliminacion costo;
+
+public:
+    /**
+     * Constructor: elige el orden
+     * @param alcances Variables de cada factor (ya reducido por la evidencia)
+     * @param ocultas Variables a eliminar; los empates se resuelven a favor
+     *        de la primera en esta lista
+     * @param cardinalidades Tamaño del dominio de cada variable (por índice)
+     * @param heuristica Criterio de elección en cada paso
+     */
+    OrdenEliminacion(const std::vector<std::vector<int>>& alcances,
+                     const std::vector<int>& ocultas,
+                     const std::vector<int>& cardinalidades,
+                     HeuristicaOrden heuristica);
+
+    /**
+     * Variables a eliminar en el orden elegido
+     */
+    const std::vector<int>& getOrden() const;
+
+    /**
+     * Clique (variable y sus vecinos al eliminarla) de cada variable del
+     * orden que aparece en algún factor
+     */
+    const std::vector<std::vector<int>>& getCliques() const;
+
+    /**
+     * Ancho inducido y tamaño de los factores intermedios
+     */
+    const CostoEliminacion& getCosto() const;
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "PonderacionVerosimilitud.h"
+#include <random>
+#include <cmath>
+
+/**
+ * Constructor: guarda referencias al grafo compilado de la red
+ */
+PonderacionVerosimilitud::PonderacionVerosimilitud(const GrafoCompilado& grafoRed,
+                                                   const std::vector<int>& orden)
+    : grafo(grafoRed), ordenTopologico(orden) {}
+
+/**
+ * Estimación por ponderación de verosimilitud
+ * Con pesos w e indicador I (la muestra coincide con la consulta):
+ *   p = Σ w·I / Σ w
+ *   error estándar ≈ sqrt(Σ w²·(I - p)²) / Σ w   (método delta)
+ *   tamaño efectivo = (Σ w)² / Σ w²
+ */
+EstimacionAproximada PonderacionVerosimilitud::estimar(const std::map<int, int>& consulta,
+                                                       const std::map<int, int>& evidencia,
+                                                       unsigned long long numMuestras,
+                                                       unsigned long long semilla,
+                                                       PoolHilos& hilos) const {
+    // Sumas acumuladas por cada flujo
+    struct Sumas {
+        double peso = 0.0;              // Σ w
+        double pesoCuadrado = 0.0;      // Σ w²
+        double pesoConsulta = 0.0;      // Σ w·I
+        double cuadradoConsulta = 0.0;  // Σ w²·I
+    };
+
+    const unsigned long long maximoFlujos = 64;
+    size_t numFlujos = static_cast<size_t>(numMuestras < maximoFlujos ? numMuestras : maximoFlujos);
+    if (numFlujos == 0) numFlujos = 1;
+    std::vector<Sumas> sumas(numFlujos);
+
+    // Evidencia y consulta como vectores por índice (-1 = libre)
+    std::vector<int> observado(grafo.getNumeroNodos(), -1);
+    for (const auto& par : evidencia) observado[par.first] = par.second;
+    std::vector<std::pair<int, int>> objetivo(consulta.begin(), consulta.end());
+
+    auto procesarFlujo = [&](size_t flujo) {
+        unsigned long long inicio = numMuestras * flujo / numFlujos;
+        unsigned long long fin = numMuestras * (flujo + 1) / numFlujos;
+
+        std::seed_seq semillas{static_cast<unsigned>(semilla), static_cast<unsigned>(semilla >> 32),
+                               static_cast<unsigned>(flujo)};
+        std::mt19937_64 generador(semillas);
+        std::uniform_real_distribution<double> uniforme(0.0, 1.0);
+
+        // La evidencia queda fija aunque su nodo no se recorra
+        std::vector<int> estado(grafo.getNumeroNodos(), 0);
+        for (const auto& par : evidencia) estado[par.first] = par.second;
+        Sumas local;
+
+        for (unsigned long long m = inicio; m < fin; m++) {
+            double w = 1.0;
+            for (int i : ordenTopologico) {
+                size_t fila = grafo.fila(i, estado.data());
+                int card = grafo.getCardinalidad(i);
+                if (observado[i] >= 0) {
+                    estado[i] = observado[i];
+                    w *= grafo.probabilidad(i, observado[i], fila);
+                    continue;
+                }
+
+                // Muestrear proporcionalmente a la fila de la tabla
+                double total = 0.0;
+                for (int v = 0; v < card; v++) total += grafo.probabilidad(i, v, fila);
+                double u = uniforme(generador) * total;
+                int valor = card - 1;
+                double acumulado = 0.0;
+                for (int v = 0; v < card - 1; v++) {
+                    acumulado += grafo.probabilidad(i, v, fila);
+                    if (u < acumulado) {
+                        valor = v;
+                        break;
+                    }
+                }
+                estado[i] = valor;
+            }
+
+            bool coincide = true;
+            for (const auto& par : objetivo) {
+                coincide = coincide && estado[par.first] == par.second;
+            }
+
+            local.peso += w;
+            local.pesoCuadrado += w * w;
+            if (coincide) {
+                local.pesoConsulta += w;
+                local.cuadradoConsulta += w * w;
+            }
+        }
+        sumas[flujo] = local;
+    };
+
+    hilos.ejecutar(numFlujos, procesarFlujo);
+
+    // Combinar los flujos en orden
+    Sumas total;
+    for (const auto& s : sumas) {
+        total.peso += s.peso;
+        total.pesoCuadrado += s.pesoCuadrado;
+        total.pesoConsulta += s.pesoConsulta;
+        total.cuadradoConsulta += s.cuadradoConsulta;
+    }
+
+    EstimacionAproximada resultado;
+    resultado.muestras = numMuestras;
+    resultado.probabilidad = 0.0;
+    resultado.errorEstandar = 0.0;
+    resultado.tamanoEfectivo = 0.0;
+
+    if (total.peso > 0.0) {
+        double p = total.pesoConsulta / total.peso;
+        // Σ w²(I - p)² = Σ w²·I·(1 - 2p) + p²·Σ w²   (porque I² = I)
+        double varianza = total.cuadradoConsulta * (1.0 - 2.0 * p) + p * p * total.pesoCuadrado;
+        resultado.probabilidad = p;
+        resultado.errorEstandar = std::sqrt(varianza > 0.0 ? varianza : 0.0) / total.peso;
+        resultado.tamanoEfectivo = total.peso * total.peso / total.pesoCuadrado;
+    }
+
+    return resultado;
+}
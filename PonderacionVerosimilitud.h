@@ -0,0 +1,60 @@
+#ifndef PONDERACION_VEROSIMILITUD_H
+#define PONDERACION_VEROSIMILITUD_H
+
+#include "GrafoCompilado.h"
+#include "PoolHilos.h"
+#include <vector>
+#include <map>
+#include <memory>
+
+/**
+ * Resultado de una inferencia aproximada por muestreo
+ */
+struct EstimacionAproximada {
+    double probabilidad;          // Estimación de P(consulta | evidencia)
+    double errorEstandar;         // Error estándar de la estimación
+    double tamanoEfectivo;        // Tamaño efectivo de la muestra (Σw)² / Σw²
+    unsigned long long muestras;  // Número de muestras generadas
+};
+
+/**
+ * Motor de inferencia aproximada por ponderación de verosimilitud
+ *
+ * Cada muestra se genera en orden topológico: los nodos de evidencia quedan
+ * fijos y multiplican el peso de la muestra por P(evidencia | padres); los
+ * demás se muestrean de su tabla dados los valores de sus padres.
+ *
+ * Las muestras se reparten en un número fijo de flujos, cada uno con su
+ * propio generador (semilla, número de flujo). Los flujos se procesan en
+ * paralelo y sus sumas se combinan en orden, por lo que el resultado solo
+ * depende de la semilla y del número de muestras.
+ */
+class PonderacionVerosimilitud {
+private:
+    const GrafoCompilado& grafo;                         // Topología y tablas por índice
+    const std::vector<int>& ordenTopologico;             // Padres antes que hijos
+
+public:
+    /**
+     * Constructor
+     * @param grafoRed Topología y tablas de la red por índice
+     * @param orden Orden topológico de los índices que se muestrean
+     */
+    PonderacionVerosimilitud(const GrafoCompilado& grafoRed, const std::vector<int>& orden);
+
+    /**
+     * Estima P(consulta | evidencia)
+     * @param consulta Índice de nodo -> índice de valor consultado
+     * @param evidencia Índice de nodo -> índice de valor observado
+     * @param numMuestras Número total de muestras
+     * @param semilla Semilla de los generadores
+     * @param hilos Grupo de hilos que procesa los flujos
+     */
+    EstimacionAproximada estimar(const std::map<int, int>& consulta,
+                                 const std::map<int, int>& evidencia,
+                                 unsigned long long numMuestras,
+                                 unsigned long long semilla,
+                                 PoolHilos& hilos) const;
+};
+
+#endif
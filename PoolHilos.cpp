@@ -0,0 +1,130 @@
+#include "PoolHilos.h"
+
+/**
+ * Constructor: crea una cola y un hilo por trabajador
+ */
+PoolHilos::PoolHilos(size_t numHilos)
+    : trabajoActual(nullptr), generacion(0), pendientes(0), trabajando(0), detener(false) {
+    if (numHilos == 0) {
+        numHilos = std::thread::hardware_concurrency();
+        if (numHilos == 0) numHilos = 1;
+    }
+    for (size_t i = 0; i < numHilos; i++) {
+        colas.emplace_back(new ColaTareas());
+    }
+    for (size_t i = 0; i < numHilos; i++) {
+        hilos.emplace_back(&PoolHilos::bucleTrabajador, this, i);
+    }
+}
+
+/**
+ * Destructor: avisa a los hilos que terminen y los espera
+ */
+PoolHilos::~PoolHilos() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexEstado);
+        detener = true;
+    }
+    hayTrabajo.notify_all();
+    for (auto& hilo : hilos) {
+        hilo.join();
+    }
+}
+
+/**
+ * Retorna el número de hilos
+ */
+size_t PoolHilos::getNumeroHilos() const {
+    return hilos.size();
+}
+
+/**
+ * Toma la siguiente tarea: primero del frente de la cola propia y,
+ * si está vacía, del final de las colas de los demás hilos
+ */
+bool PoolHilos::obtenerTarea(size_t id, size_t& tarea) {
+    for (size_t k = 0; k < colas.size(); k++) {
+        ColaTareas& cola = *colas[(id + k) % colas.size()];
+        std::lock_guard<std::mutex> bloqueo(cola.mutex);
+        if (cola.tareas.empty()) continue;
+        if (k == 0) {
+            tarea = cola.tareas.front();
+            cola.tareas.pop_front();
+        } else {
+            tarea = cola.tareas.back();
+            cola.tareas.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Ciclo de un hilo trabajador
+ */
+void PoolHilos::bucleTrabajador(size_t id) {
+    unsigned long long vista = 0;
+    while (true) {
+        const std::function<void(size_t)>* trabajo;
+        {
+            std::unique_lock<std::mutex> bloqueo(mutexEstado);
+            hayTrabajo.wait(bloqueo, [&] { return detener || generacion != vista; });
+            if (detener) return;
+            vista = generacion;
+            trabajo = trabajoActual;
+            // El lote ya terminó antes de que este hilo despertara
+            if (trabajo == nullptr) continue;
+            trabajando++;
+        }
+
+        size_t tarea;
+        size_t completadas = 0;
+        while (obtenerTarea(id, tarea)) {
+            (*trabajo)(tarea);
+            completadas++;
+        }
+
+        {
+            std::lock_guard<std::mutex> bloqueo(mutexEstado);
+            pendientes -= completadas;
+            trabajando--;
+        }
+        loteTerminado.notify_all();
+    }
+}
+
+/**
+ * Reparte las tareas en bloques contiguos y espera a que terminen
+ */
+void PoolHilos::ejecutar(size_t numTareas, const std::function<void(size_t)>& trabajo) {
+    if (numTareas == 0) return;
+
+    std::lock_guard<std::mutex> ejecucion(mutexEjecucion);
+    std::unique_lock<std::mutex> bloqueo(mutexEstado);
+
+    size_t numColas = colas.size();
+    for (size_t h = 0; h < numColas; h++) {
+        std::lock_guard<std::mutex> bloqueoCola(colas[h]->mutex);
+        size_t inicio = numTareas * h / numColas;
+        size_t fin = numTareas * (h + 1) / numColas;
+        for (size_t t = inicio; t < fin; t++) {
+            colas[h]->tareas.push_back(t);
+        }
+    }
+
+    trabajoActual = &trabajo;
+    pendientes = numTareas;
+    generacion++;
+    hayTrabajo.notify_all();
+
+    loteTerminado.wait(bloqueo, [&] { return pendientes == 0 && trabajando == 0; });
+    trabajoActual = nullptr;
+}
+
+/**
+ * Grupo compartido, creado en el primer uso
+ */
+PoolHilos& PoolHilos::compartido() {
+    static PoolHilos pool(0);
+    return pool;
+}
@@ -0,0 +1,86 @@
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <cstddef>
+
+/**
+ * Grupo de hilos persistentes con robo de trabajo
+ *
+ * Cada llamada a ejecutar() reparte las tareas 0..n-1 en bloques contiguos,
+ * uno por hilo. Cada hilo consume su cola desde el frente y, cuando se vacía,
+ * roba tareas del final de la cola de otro hilo. La llamada retorna cuando
+ * todas las tareas terminaron.
+ *
+ * Las tareas no deben llamar a ejecutar() sobre el mismo grupo.
+ */
+class PoolHilos {
+private:
+    // Cola de tareas de un hilo
+    struct ColaTareas {
+        std::mutex mutex;
+        std::deque<size_t> tareas;
+    };
+
+    std::vector<std::thread> hilos;
+    std::vector<std::unique_ptr<ColaTareas>> colas;
+
+    std::mutex mutexEjecucion;                  // Serializa llamadas a ejecutar()
+    std::mutex mutexEstado;
+    std::condition_variable hayTrabajo;
+    std::condition_variable loteTerminado;
+    const std::function<void(size_t)>* trabajoActual;
+    unsigned long long generacion;              // Cambia con cada lote
+    size_t pendientes;                          // Tareas del lote sin terminar
+    size_t trabajando;                          // Hilos dentro del lote actual
+    bool detener;
+
+    /**
+     * Ciclo de cada hilo: espera un lote y procesa tareas hasta agotarlas
+     */
+    void bucleTrabajador(size_t id);
+
+    /**
+     * Toma una tarea de la cola propia o la roba de otra cola
+     * @return false si no quedan tareas en ninguna cola
+     */
+    bool obtenerTarea(size_t id, size_t& tarea);
+
+public:
+    /**
+     * Constructor: inicia los hilos
+     * @param numHilos Número de hilos (0 = núcleos disponibles)
+     */
+    explicit PoolHilos(size_t numHilos);
+
+    /**
+     * Destructor: detiene y espera a todos los hilos
+     */
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    /**
+     * Número de hilos del grupo
+     */
+    size_t getNumeroHilos() const;
+
+    /**
+     * Ejecuta trabajo(i) para cada i en [0, numTareas) y espera a que terminen
+     */
+    void ejecutar(size_t numTareas, const std::function<void(size_t)>& trabajo);
+
+    /**
+     * Grupo compartido con un hilo por núcleo disponible
+     */
+    static PoolHilos& compartido();
+};
+
+#endif
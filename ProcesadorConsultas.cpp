@@ -0,0 +1,265 @@
+#include "ProcesadorConsultas.h"
+#include <memory>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+// Líneas por bloque: suficientes para repartir entre hilos sin retener
+// demasiadas respuestas en memoria
+const size_t LINEAS_POR_BLOQUE = 1024;
+
+/**
+ * Número real en JSON (NaN e infinito no existen en JSON)
+ */
+void agregarNumero(std::string& texto, double valor) {
+    if (!std::isfinite(valor)) {
+        texto += "null";
+        return;
+    }
+    char numero[32];
+    std::snprintf(numero, sizeof(numero), "%.12g", valor);
+    texto += numero;
+}
+
+}
+
+/**
+ * Constructor
+ */
+ProcesadorConsultas::ProcesadorConsultas(const ContenedorRed& contenedorRed,
+                                         const OpcionesConsulta& opcionesConsulta)
+    : contenedor(contenedorRed), opciones(opcionesConsulta) {
+    bool motorParalelo = opciones.motor == MotorConsulta::ENUMERACION_PARALELA ||
+                         opciones.motor == MotorConsulta::PONDERACION ||
+                         opciones.motor == MotorConsulta::GIBBS;
+    // Grupo propio: las tareas no pueden usar el grupo de los motores
+    if (!motorParalelo && opciones.numHilos != 1) {
+        hilos = std::make_shared<PoolHilos>(opciones.numHilos);
+    }
+}
+
+/**
+ * Separa por espacios y comas; cada asignación debe tener la forma nombre=valor
+ */
+bool ProcesadorConsultas::leerAsignaciones(const RedBayesiana& red,
+                                           std::string_view texto,
+                                           std::map<std::string, std::string>& destino,
+                                           std::string& error) {
+    size_t i = 0;
+    while (i < texto.size()) {
+        while (i < texto.size() && (LectorTexto::esEspacio(texto[i]) || texto[i] == ',')) i++;
+        size_t inicio = i;
+        while (i < texto.size() && !LectorTexto::esEspacio(texto[i]) && texto[i] != ',') i++;
+        if (i == inicio) break;
+
+        std::string_view asignacion = texto.substr(inicio, i - inicio);
+        size_t igual = asignacion.find('=');
+        if (igual == std::string_view::npos || igual == 0 || igual + 1 == asignacion.size()) {
+            error = "Se esperaba Variable=valor en '" + std::string(asignacion) + "'";
+            return false;
+        }
+        std::string nombre(asignacion.substr(0, igual));
+        std::string valor(asignacion.substr(igual + 1));
+
+        std::shared_ptr<const Nodo> nodo = red.obtenerNodo(nombre);
+        if (!nodo) {
+            error = "Variable " + nombre + " no existe en la red";
+            return false;
+        }
+        if (nodo->indiceValor(valor) < 0) {
+            error = "Valor '" + valor + "' no está en el dominio de " + nombre;
+            return false;
+        }
+        if (!destino.emplace(nombre, valor).second) {
+            error = "Variable " + nombre + " repetida";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Valida la línea y llama al motor elegido, todo sobre la misma versión
+ */
+std::string ProcesadorConsultas::responder(std::string_view linea, size_t numeroLinea) const {
+    linea = LectorTexto::recortar(linea);
+    if (linea.empty() || linea[0] == '#') return std::string();
+
+    std::shared_ptr<const RedBayesiana> version = contenedor.actual();
+    const RedBayesiana& red = *version;
+    std::string respuesta = "{\"linea\":" + std::to_string(numeroLinea) + ",";
+    std::map<std::string, std::string> consulta;
+    std::map<std::string, std::string> evidencia;
+    std::string error;
+
+    size_t barra = linea.find('|');
+    bool valida = leerAsignaciones(red, linea.substr(0, barra), consulta, error) &&
+                  (barra == std::string_view::npos ||
+                   leerAsignaciones(red, linea.substr(barra + 1), evidencia, error));
+    if (valida && consulta.empty()) {
+        error = "La consulta no tiene variables";
+        valida = false;
+    }
+    for (auto it = consulta.begin(); valida && it != consulta.end(); ++it) {
+        if (evidencia.count(it->first)) {
+            error = "Variable " + it->first + " en la consulta y en la evidencia";
+            valida = false;
+        }
+    }
+    if (!valida) {
+        return respuesta + "\"error\":\"" + escaparJson(error) + "\"}";
+    }
+
+    respuesta += "\"probabilidad\":";
+    switch (opciones.motor) {
+        case MotorConsulta::PONDERACION: {
+            EstimacionAproximada e = red.inferenciaAproximada(consulta, evidencia,
+                                                              opciones.muestras, opciones.semilla);
+            agregarNumero(respuesta, e.probabilidad);
+            respuesta += ",\"error_estandar\":";
+            agregarNumero(respuesta, e.errorEstandar);
+            break;
+        }
+        case MotorConsulta::GIBBS: {
+            ConfiguracionGibbs config;
+            config.muestras = opciones.muestras;
+            config.semilla = opciones.semilla;
+            EstimacionGibbs e = red.inferenciaGibbs(consulta, evidencia, config);
+            agregarNumero(respuesta, e.probabilidad);
+            respuesta += ",\"error_estandar\":";
+            agregarNumero(respuesta, e.errorEstandar);
+            respuesta += ",\"r_hat\":";
+            agregarNumero(respuesta, e.rHat);
+            break;
+        }
+        default: {
+            MetodoInferencia metodo = MetodoInferencia::ENUMERACION;
+            if (opciones.motor == MotorConsulta::ELIMINACION_VARIABLES) {
+                metodo = MetodoInferencia::ELIMINACION_VARIABLES;
+            } else if (opciones.motor == MotorConsulta::ENUMERACION_PARALELA) {
+                metodo = MetodoInferencia::ENUMERACION_PARALELA;
+            } else if (opciones.motor == MotorConsulta::ENUMERACION_RECURSIVA) {
+                metodo = MetodoInferencia::ENUMERACION_RECURSIVA;
+            }
+            agregarNumero(respuesta, red.inferencia(consulta, evidencia, metodo));
+        }
+    }
+    return respuesta + "}";
+}
+
+/**
+ * Sin grupo propio (motores que ya usan todos los hilos) se responde en
+ * orden; si no, las líneas del bloque se reparten entre sus hilos
+ */
+size_t ProcesadorConsultas::responderBloque(const std::vector<std::string_view>& lineas,
+                                            size_t primeraLinea,
+                                            std::ostream& salida) const {
+    std::vector<std::string> respuestas(lineas.size());
+    if (!hilos || lineas.size() < 2) {
+        for (size_t k = 0; k < lineas.size(); k++) {
+            respuestas[k] = responder(lineas[k], primeraLinea + k);
+        }
+    } else {
+        hilos->ejecutar(lineas.size(), [&](size_t k) {
+            respuestas[k] = responder(lineas[k], primeraLinea + k);
+        });
+    }
+
+    std::string texto;
+    size_t respondidas = 0;
+    for (const auto& respuesta : respuestas) {
+        if (respuesta.empty()) continue;
+        texto += respuesta;
+        texto += '\n';
+        respondidas++;
+    }
+    salida.write(texto.data(), texto.size());
+    salida.flush();
+    return respondidas;
+}
+
+/**
+ * Arma bloques con las líneas ya recibidas: la primera se espera y las
+ * siguientes solo se toman si ya están en el búfer de entrada
+ */
+size_t ProcesadorConsultas::procesar(std::istream& entrada, std::ostream& salida) const {
+    std::vector<std::string> textos;
+    std::vector<std::string_view> lineas;
+    size_t numeroLinea = 1;
+    size_t respondidas = 0;
+    std::string linea;
+
+    while (std::getline(entrada, linea)) {
+        textos.clear();
+        textos.push_back(linea);
+        while (textos.size() < LINEAS_POR_BLOQUE && entrada.rdbuf()->in_avail() > 0 &&
+               std::getline(entrada, linea)) {
+            textos.push_back(linea);
+        }
+        lineas.assign(textos.begin(), textos.end());
+        respondidas += responderBloque(lineas, numeroLinea, salida);
+        numeroLinea += textos.size();
+    }
+    return respondidas;
+}
+
+/**
+ * Las líneas son vistas sobre el archivo mapeado
+ */
+long long ProcesadorConsultas::procesarArchivo(const std::string& archivo, std::ostream& salida) const {
+    LectorTexto lector;
+    if (!lector.abrir(archivo)) return -1;
+
+    std::vector<std::string_view> lineas;
+    std::string_view linea;
+    size_t primeraLinea = 1;
+    long long respondidas = 0;
+    while (lector.siguienteLinea(linea)) {
+        lineas.push_back(linea);
+        if (lineas.size() == LINEAS_POR_BLOQUE) {
+            respondidas += responderBloque(lineas, primeraLinea, salida);
+            primeraLinea += lineas.size();
+            lineas.clear();
+        }
+    }
+    if (!lineas.empty()) {
+        respondidas += responderBloque(lineas, primeraLinea, salida);
+    }
+    return respondidas;
+}
+
+/**
+ * Nombres de la línea de comandos
+ */
+bool ProcesadorConsultas::motorDesdeNombre(const std::string& nombre, MotorConsulta& motor) {
+    if (nombre == "enumeracion") motor = MotorConsulta::ENUMERACION;
+    else if (nombre == "eliminacion") motor = MotorConsulta::ELIMINACION_VARIABLES;
+    else if (nombre == "paralela") motor = MotorConsulta::ENUMERACION_PARALELA;
+    else if (nombre == "recursiva") motor = MotorConsulta::ENUMERACION_RECURSIVA;
+    else if (nombre == "ponderacion") motor = MotorConsulta::PONDERACION;
+    else if (nombre == "gibbs") motor = MotorConsulta::GIBBS;
+    else return false;
+    return true;
+}
+
+/**
+ * Escapado mínimo de JSON (los bytes UTF-8 pasan sin cambios)
+ */
+std::string ProcesadorConsultas::escaparJson(std::string_view texto) {
+    std::string resultado;
+    resultado.reserve(texto.size());
+    for (char c : texto) {
+        if (c == '"' || c == '\\') {
+            resultado += '\\';
+            resultado += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char codigo[8];
+            std::snprintf(codigo, sizeof(codigo), "\\u%04x", static_cast<unsigned>(c));
+            resultado += codigo;
+        } else {
+            resultado += c;
+        }
+    }
+    return resultado;
+}
@@ -0,0 +1,124 @@
+#ifndef PROCESADOR_CONSULTAS_H
+#define PROCESADOR_CONSULTAS_H
+
+#include "ContenedorRed.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <memory>
+#include <istream>
+#include <ostream>
+
+/**
+ * Motores con los que se responden las consultas por lotes
+ */
+enum class MotorConsulta {
+    ENUMERACION,
+    ELIMINACION_VARIABLES,
+    ENUMERACION_PARALELA,
+    ENUMERACION_RECURSIVA,
+    PONDERACION,            // Ponderación por verosimilitud (aproximado)
+    GIBBS                   // Muestreo de Gibbs (aproximado)
+};
+
+/**
+ * Opciones del procesamiento de consultas
+ */
+struct OpcionesConsulta {
+    MotorConsulta motor;
+    unsigned long long muestras;    // Ponderación: total; Gibbs: por cadena
+    unsigned long long semilla;
+    size_t numHilos;                // Hilos para repartir consultas (0 = núcleos disponibles)
+
+    OpcionesConsulta()
+        : motor(MotorConsulta::ENUMERACION), muestras(100000), semilla(42), numHilos(0) {}
+};
+
+/**
+ * Responde consultas escritas una por línea con una línea JSON cada una
+ *
+ * Formato de cada consulta (los espacios o comas separan asignaciones):
+ *   Train=delayed | Rain=heavy Maintenance=yes
+ * A la izquierda de '|' van las variables de consulta y a la derecha la
+ * evidencia, que es opcional. Las líneas vacías y las que empiezan con '#'
+ * se ignoran. Respuestas:
+ *   {"linea":3,"probabilidad":0.32}
+ *   {"linea":4,"error":"Variable Lluvia no existe en la red"}
+ * Los motores aproximados agregan "error_estandar" (y Gibbs "r_hat").
+ *
+ * Con los motores secuenciales las consultas de cada bloque se reparten
+ * entre varios hilos; las respuestas salen siempre en el orden de entrada.
+ * Cada consulta usa la versión de la red publicada cuando comienza.
+ */
+class ProcesadorConsultas {
+private:
+    const ContenedorRed& contenedor;
+    OpcionesConsulta opciones;
+    std::shared_ptr<PoolHilos> hilos;   // Reparte consultas (nulo con motores paralelos)
+
+    /**
+     * Lee asignaciones "Variable=valor" y las valida contra la red
+     * @return false si hay un error (se describe en error)
+     */
+    static bool leerAsignaciones(const RedBayesiana& red,
+                                 std::string_view texto,
+                                 std::map<std::string, std::string>& destino,
+                                 std::string& error);
+
+    /**
+     * Responde un bloque de líneas consecutivas
+     * @param lineas Líneas del bloque
+     * @param primeraLinea Número de la primera línea
+     * @param salida Recibe las respuestas, una por línea
+     * @return Número de consultas respondidas
+     */
+    size_t responderBloque(const std::vector<std::string_view>& lineas,
+                           size_t primeraLinea,
+                           std::ostream& salida) const;
+
+public:
+    /**
+     * Constructor
+     * @param contenedor Versiones de la red (debe vivir mientras se use el procesador)
+     * @param opciones Motor, muestras, semilla e hilos
+     */
+    ProcesadorConsultas(const ContenedorRed& contenedor, const OpcionesConsulta& opciones);
+
+    /**
+     * Responde una línea
+     * @param linea Texto de la consulta
+     * @param numeroLinea Número que se informa en la respuesta
+     * @return Respuesta JSON sin salto de línea; vacía si la línea está en
+     *         blanco o es un comentario
+     */
+    std::string responder(std::string_view linea, size_t numeroLinea) const;
+
+    /**
+     * Responde todas las consultas de un flujo, por bloques
+     * Un bloque toma las líneas que ya están disponibles sin esperar más,
+     * así que también sirve para conversar por una tubería
+     * @return Número de consultas respondidas
+     */
+    size_t procesar(std::istream& entrada, std::ostream& salida) const;
+
+    /**
+     * Responde todas las consultas de un archivo (mapeado en memoria)
+     * @return Número de consultas respondidas; -1 si no se pudo abrir
+     */
+    long long procesarArchivo(const std::string& archivo, std::ostream& salida) const;
+
+    /**
+     * Traduce un nombre de motor: enumeracion, eliminacion, paralela,
+     * recursiva, ponderacion o gibbs
+     * @return false si el nombre no es válido
+     */
+    static bool motorDesdeNombre(const std::string& nombre, MotorConsulta& motor);
+
+    /**
+     * Escapa comillas, barras y caracteres de control para un texto JSON
+     */
+    static std::string escaparJson(std::string_view texto);
+};
+
+#endif
@@ -1,14 +1,50 @@
 #include "RedBayesiana.h"
+#include "FactorLote.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <string_view>
 
 /**
  * Constructor: inicializa una red bayesiana vacía
  */
-RedBayesiana::RedBayesiana() {}
+RedBayesiana::RedBayesiana()
+    : podaRelevancia(true), heuristicaOrden(HeuristicaOrden::TAMANO_MINIMO), cache(1 << 20) {}
+
+/**
+ * Constructor de copia: clona los nodos y los enlaza entre sí, y compila
+ * de nuevo el grafo (que apunta a los nodos). El árbol de cliques y el grupo
+ * de hilos no dependen de los nodos y se comparten
+ */
+RedBayesiana::RedBayesiana(const RedBayesiana& otra)
+    : indicePorNombre(otra.indicePorNombre), arbolCliques(otra.arbolCliques), pool(otra.pool),
+      podaRelevancia(otra.podaRelevancia), heuristicaOrden(otra.heuristicaOrden),
+      cache(otra.cache), estadisticas(otra.estadisticas) {
+    for (const auto& original : otra.nodosPorIndice) {
+        nodosPorIndice.push_back(std::make_shared<Nodo>(original->getNombre()));
+        nodosPorIndice.back()->setDominio(original->getDominio());
+    }
+    for (size_t i = 0; i < nodosPorIndice.size(); i++) {
+        const Nodo& original = *otra.nodosPorIndice[i];
+        for (const auto& padre : original.getPadres()) {
+            nodosPorIndice[i]->agregarPadre(nodosPorIndice[indicePorNombre.at(padre->getNombre())]);
+        }
+        for (const auto& hijo : original.getHijos()) {
+            nodosPorIndice[i]->agregarHijo(nodosPorIndice[indicePorNombre.at(hijo->getNombre())]);
+        }
+    }
+    for (size_t i = 0; i < nodosPorIndice.size(); i++) {
+        nodosPorIndice[i]->copiarTablaDe(*otra.nodosPorIndice[i]);
+        nodos[nodosPorIndice[i]->getNombre()] = nodosPorIndice[i];
+        if (nodosPorIndice[i]->esRaiz()) nodosRaiz.push_back(nodosPorIndice[i]);
+    }
+    grafo = GrafoCompilado(nodosPorIndice, indicePorNombre);
+}
 
 /**
  * Carga la estructura de la red desde un archivo
@@ -21,6 +57,8 @@ bool RedBayesiana::cargarEstructura(const std::string& nombreArchivo) {
         return false;
     }
     
+    // Los nodos se arman aparte y solo se instalan si la estructura es válida
+    std::map<std::string, std::shared_ptr<Nodo>> leidos;
     std::string linea;
     while (std::getline(archivo, linea)) {
         // Ignorar líneas vacías o comentarios
@@ -31,29 +69,26 @@ bool RedBayesiana::cargarEstructura(const std::string& nombreArchivo) {
         
         if (iss >> nombrePadre >> nombreHijo) {
             // Crear o obtener nodo padre
-            if (nodos.find(nombrePadre) == nodos.end()) {
-                nodos[nombrePadre] = std::make_shared<Nodo>(nombrePadre);
+            if (leidos.find(nombrePadre) == leidos.end()) {
+                leidos[nombrePadre] = std::make_shared<Nodo>(nombrePadre);
             }
             
             // Crear o obtener nodo hijo
-            if (nodos.find(nombreHijo) == nodos.end()) {
-                nodos[nombreHijo] = std::make_shared<Nodo>(nombreHijo);
+            if (leidos.find(nombreHijo) == leidos.end()) {
+                leidos[nombreHijo] = std::make_shared<Nodo>(nombreHijo);
             }
             
             // Establecer relación padre-hijo
-            nodos[nombreHijo]->agregarPadre(nodos[nombrePadre]);
-            nodos[nombrePadre]->agregarHijo(nodos[nombreHijo]);
+            leidos[nombreHijo]->agregarPadre(leidos[nombrePadre]);
+            leidos[nombrePadre]->agregarHijo(leidos[nombreHijo]);
         }
     }
     
     archivo.close();
     
-    // Identificar nodos raíz
-    for (const auto& par : nodos) {
-        if (par.second->esRaiz()) {
-            nodosRaiz.push_back(par.second);
-        }
-    }
+    std::vector<std::shared_ptr<Nodo>> creados;
+    for (const auto& par : leidos) creados.push_back(par.second);
+    if (!reemplazarNodos(creados)) return false;
     
     std::cout << "✓ Estructura cargada: " << nodos.size() << " nodos, "
               << nodosRaiz.size() << " raíces\n";
@@ -67,130 +102,251 @@ bool RedBayesiana::cargarEstructura(const std::string& nombreArchivo) {
  * NODO NombreNodo
  * DOMINIO valor1 valor2 valor3...
  * valor_padre1 valor_padre2... | valor_nodo prob
+ *
+ * El archivo se recorre sobre un único búfer (ver LectorTexto): las líneas y
+ * los tokens son vistas sin copias y los números se leen con from_chars.
+ * Cada valor se identifica por su posición en el dominio, así que validar
+ * una fila no construye cadenas
  */
 bool RedBayesiana::cargarProbabilidades(const std::string& nombreArchivo) {
-    std::ifstream archivo(nombreArchivo);
-    if (!archivo.is_open()) {
+    LectorTexto lector;
+    if (!lector.abrir(nombreArchivo)) {
         std::cerr << "Error: No se puede abrir " << nombreArchivo << "\n";
         return false;
     }
     
-    std::string linea;
-    std::shared_ptr<Nodo> nodoActual = nullptr;
-    int lineaNum = 0;
+    // Dominio de cada nodo como vistas sobre el búfer del lector, o sobre
+    // copias de los dominios que los nodos ya tenían antes de esta carga
+    struct DominioLeido {
+        std::vector<std::string_view> valores;
+        std::unordered_map<std::string_view, int> posiciones;   // Solo dominios grandes
+        int lineaDefinicion;    // Última línea DOMINIO (0 si es anterior a la carga)
+        bool leido;
+    };
+    const size_t LIMITE_BUSQUEDA_LINEAL = 16;
+    std::vector<DominioLeido> dominios(nodosPorIndice.size());
+    std::deque<std::string> valoresCopiados;
     
-    while (std::getline(archivo, linea)) {
-        lineaNum++;
+    auto definirDominio = [&](int n, std::vector<std::string_view> valores, int linea) {
+        DominioLeido& d = dominios[n];
+        d.valores = std::move(valores);
+        d.posiciones.clear();
+        if (d.valores.size() > LIMITE_BUSQUEDA_LINEAL) {
+            for (size_t i = 0; i < d.valores.size(); i++) {
+                d.posiciones[d.valores[i]] = static_cast<int>(i);
+            }
+        }
+        d.lineaDefinicion = linea;
+        d.leido = true;
+    };
+    auto dominioDe = [&](int n) -> const DominioLeido& {
+        if (!dominios[n].leido) {
+            std::vector<std::string_view> valores;
+            for (const auto& valor : nodosPorIndice[n]->getDominio()) {
+                valoresCopiados.push_back(valor);
+                valores.push_back(valoresCopiados.back());
+            }
+            definirDominio(n, std::move(valores), 0);
+        }
+        return dominios[n];
+    };
+    // Posición de un valor en el dominio (si se repite, la última, como Nodo::indiceValor)
+    auto posicionEn = [](const DominioLeido& d, std::string_view valor) {
+        if (!d.posiciones.empty()) {
+            auto it = d.posiciones.find(valor);
+            return it != d.posiciones.end() ? it->second : -1;
+        }
+        for (size_t i = d.valores.size(); i-- > 0; ) {
+            if (d.valores[i] == valor) return static_cast<int>(i);
+        }
+        return -1;
+    };
+    
+    // Las filas de probabilidad se aplican al terminar la lectura. La fila de
+    // la tabla se calcula al leer si ya se conocen los dominios de todos los
+    // padres; si no (o si después se redefine el dominio del nodo o de un
+    // padre), se vuelve a resolver al final desde el texto de la línea
+    const size_t SIN_FILA = static_cast<size_t>(-1);
+    struct FilaPendiente {
+        int nodo;
+        int valor;              // Posición en el dominio del nodo
+        int linea;
+        double probabilidad;
+        size_t fila;            // Fila de la tabla o SIN_FILA
+        std::string_view texto;
+    };
+    std::vector<FilaPendiente> filasPendientes;
+    
+    std::string_view linea;
+    int nodoActual = -1;
+    std::vector<const DominioLeido*> dominiosPadres;   // De los padres del nodo actual
+    
+    while (lector.siguienteLinea(linea)) {
+        int lineaNum = lector.getNumeroLinea();
         
         // Ignorar líneas vacías o comentarios
         if (linea.empty() || linea[0] == '#') continue;
         
         // Eliminar espacios al inicio y final
-        size_t inicio = linea.find_first_not_of(" \t\r\n");
-        size_t fin = linea.find_last_not_of(" \t\r\n");
-        if (inicio == std::string::npos) continue;
-        linea = linea.substr(inicio, fin - inicio + 1);
+        linea = LectorTexto::recortar(linea);
+        if (linea.empty()) continue;
         
-        std::istringstream iss(linea);
-        std::string palabra;
-        iss >> palabra;
+        // Solo una línea que empieza con 'N' o 'D' puede ser NODO o DOMINIO
+        std::string_view resto = linea;
+        std::string_view palabra;
+        if (linea[0] == 'N' || linea[0] == 'D') {
+            LectorTexto::siguienteToken(resto, palabra);
+        }
         
         // Nueva definición de nodo
         if (palabra == "NODO") {
-            std::string nombreNodo;
-            iss >> nombreNodo;
-            nodoActual = obtenerNodo(nombreNodo);
-            if (!nodoActual) {
+            std::string_view nombreNodo;
+            LectorTexto::siguienteToken(resto, nombreNodo);
+            auto it = indicePorNombre.find(std::string(nombreNodo));
+            nodoActual = it != indicePorNombre.end() ? it->second : -1;
+            dominiosPadres.clear();
+            if (nodoActual >= 0) {
+                for (int padre : grafo.getPadres(nodoActual)) {
+                    dominiosPadres.push_back(&dominioDe(padre));
+                }
+            }
+            if (nodoActual < 0) {
                 std::cerr << "Línea " << lineaNum << " - Advertencia: Nodo no encontrado en estructura: " 
                          << nombreNodo << "\n";
                 std::cerr << "Asegúrese de definir primero la estructura en estructura.txt\n";
             }
         }
         // Definición de dominio
-        else if (palabra == "DOMINIO" && nodoActual) {
-            std::vector<std::string> dominio;
-            std::string valor;
-            while (iss >> valor) {
-                dominio.push_back(valor);
+        else if (palabra == "DOMINIO" && nodoActual >= 0) {
+            std::vector<std::string_view> valores;
+            std::string_view valor;
+            while (LectorTexto::siguienteToken(resto, valor)) {
+                valores.push_back(valor);
             }
-            nodoActual->setDominio(dominio);
+            nodosPorIndice[nodoActual]->setDominio(std::vector<std::string>(valores.begin(), valores.end()));
+            definirDominio(nodoActual, std::move(valores), lineaNum);
             
             // Verificación: El dominio debe tener al menos 2 valores
-            if (dominio.size() < 2) {
+            if (dominios[nodoActual].valores.size() < 2) {
                 std::cerr << "Línea " << lineaNum << " - Advertencia: Dominio con menos de 2 valores para " 
-                         << nodoActual->getNombre() << "\n";
+                         << nodosPorIndice[nodoActual]->getNombre() << "\n";
             }
         }
         // Línea de probabilidad
-        else if (nodoActual && nodoActual->getDominio().size() > 0) {
-            // Retroceder para leer toda la línea
-            iss.clear();
-            iss.seekg(0);
-            
-            std::vector<std::string> valoresPadres;
-            std::string valorNodo;
-            double probabilidad;
+        else if (nodoActual >= 0 && !dominioDe(nodoActual).valores.empty()) {
+            const size_t numPadres = dominiosPadres.size();
             
             // Buscar el separador '|'
             size_t posPipe = linea.find('|');
+            std::string_view parteIzq, parteDer;
             
-            if (posPipe != std::string::npos) {
+            if (posPipe != std::string_view::npos) {
                 // Hay separador '|': formato "valores_padres | valor_nodo prob"
-                std::string parteIzq = linea.substr(0, posPipe);
-                std::string parteDer = linea.substr(posPipe + 1);
-                
-                // Leer valores de padres
-                std::istringstream issIzq(parteIzq);
-                std::string valor;
-                while (issIzq >> valor) {
-                    valoresPadres.push_back(valor);
-                }
-                
-                // Leer valor del nodo y probabilidad
-                std::istringstream issDer(parteDer);
-                if (issDer >> valorNodo >> probabilidad) {
-                    // Verificar que el número de valores de padres coincida
-                    if (nodoActual->getPadres().size() != valoresPadres.size()) {
-                        std::cerr << "Línea " << lineaNum << " - Error: Número de valores de padres ("
-                                 << valoresPadres.size() << ") no coincide con número de padres ("
-                                 << nodoActual->getPadres().size() << ") para " 
-                                 << nodoActual->getNombre() << "\n";
-                        continue;
-                    }
-                    
-                    // Verificar que valorNodo está en el dominio
-                    auto dominio = nodoActual->getDominio();
-                    if (std::find(dominio.begin(), dominio.end(), valorNodo) == dominio.end()) {
-                        std::cerr << "Línea " << lineaNum << " - Advertencia: Valor '" << valorNodo 
-                                 << "' no está en el dominio de " << nodoActual->getNombre() << "\n";
-                    }
-                    
-                    nodoActual->setProbabilidad(valoresPadres, valorNodo, probabilidad);
-                }
-            } else {
+                parteIzq = linea.substr(0, posPipe);
+                parteDer = linea.substr(posPipe + 1);
+            } else if (numPadres == 0) {
                 // Sin separador '|': formato para nodos raíz "valor probabilidad"
-                if (nodoActual->getPadres().empty()) {
-                    if (iss >> valorNodo >> probabilidad) {
-                        // Verificar que valorNodo está en el dominio
-                        auto dominio = nodoActual->getDominio();
-                        if (std::find(dominio.begin(), dominio.end(), valorNodo) == dominio.end()) {
-                            std::cerr << "Línea " << lineaNum << " - Advertencia: Valor '" << valorNodo 
-                                     << "' no está en el dominio de " << nodoActual->getNombre() << "\n";
-                        }
-                        
-                        nodoActual->setProbabilidad({}, valorNodo, probabilidad);
-                    }
-                } else {
-                    std::cerr << "Línea " << lineaNum << " - Error: Falta separador '|' para nodo con padres\n";
+                parteDer = linea;
+            } else {
+                std::cerr << "Línea " << lineaNum << " - Error: Falta separador '|' para nodo con padres\n";
+                continue;
+            }
+            
+            // Leer valor del nodo y probabilidad
+            std::string_view valorNodo, textoProbabilidad;
+            double probabilidad;
+            if (!LectorTexto::siguienteToken(parteDer, valorNodo) ||
+                !LectorTexto::siguienteToken(parteDer, textoProbabilidad) ||
+                !LectorTexto::leerNumero(textoProbabilidad, probabilidad)) {
+                continue;
+            }
+            
+            // Leer valores de padres, calculando la fila si es posible
+            size_t numValoresPadres = 0;
+            size_t fila = 0;
+            std::string_view pendientes = parteIzq;
+            std::string_view valor;
+            while (LectorTexto::siguienteToken(pendientes, valor)) {
+                if (numValoresPadres < numPadres && fila != SIN_FILA) {
+                    const DominioLeido& d = *dominiosPadres[numValoresPadres];
+                    int indice = posicionEn(d, valor);
+                    fila = indice < 0 ? SIN_FILA : fila * d.valores.size() + indice;
                 }
+                numValoresPadres++;
             }
-        } else if (nodoActual && nodoActual->getDominio().size() == 0) {
+            
+            // Verificar que el número de valores de padres coincida
+            if (posPipe != std::string_view::npos && numValoresPadres != numPadres) {
+                std::cerr << "Línea " << lineaNum << " - Error: Número de valores de padres ("
+                         << numValoresPadres << ") no coincide con número de padres ("
+                         << numPadres << ") para " << nodosPorIndice[nodoActual]->getNombre() << "\n";
+                continue;
+            }
+            
+            // Verificar que valorNodo está en el dominio
+            int indiceValor = posicionEn(dominios[nodoActual], valorNodo);
+            if (indiceValor < 0) {
+                std::cerr << "Línea " << lineaNum << " - Advertencia: Valor '" << valorNodo 
+                         << "' no está en el dominio de " << nodosPorIndice[nodoActual]->getNombre() << "\n";
+                continue;
+            }
+            
+            filasPendientes.push_back({nodoActual, indiceValor, lineaNum, probabilidad, fila, linea});
+        } else if (nodoActual >= 0) {
             std::cerr << "Línea " << lineaNum << " - Error: Debe definir DOMINIO antes de las probabilidades para " 
-                     << nodoActual->getNombre() << "\n";
+                     << nodosPorIndice[nodoActual]->getNombre() << "\n";
         }
     }
     
-    archivo.close();
+    // Última línea en la que cambió el dominio de cada nodo o de alguno de
+    // sus padres: las filas leídas antes de esa línea se resuelven de nuevo
+    std::vector<int> ultimoCambio(nodosPorIndice.size(), 0);
+    for (size_t n = 0; n < nodosPorIndice.size(); n++) {
+        ultimoCambio[n] = dominios[n].lineaDefinicion;
+        for (int padre : grafo.getPadres(static_cast<int>(n))) {
+            ultimoCambio[n] = std::max(ultimoCambio[n], dominios[padre].lineaDefinicion);
+        }
+    }
+    
+    // Dimensionar las tablas y aplicar las filas leídas
+    for (const auto& par : nodos) {
+        par.second->prepararTabla();
+    }
+    for (const auto& pendiente : filasPendientes) {
+        int indiceValor = pendiente.valor;
+        size_t fila = pendiente.fila;
+        if (fila == SIN_FILA || pendiente.linea < ultimoCambio[pendiente.nodo]) {
+            std::string_view valores, derecha = pendiente.texto;
+            size_t posPipe = derecha.find('|');
+            if (posPipe != std::string_view::npos) {
+                valores = derecha.substr(0, posPipe);
+                derecha.remove_prefix(posPipe + 1);
+            }
+            std::string_view valor;
+            LectorTexto::siguienteToken(derecha, valor);
+            indiceValor = posicionEn(dominios[pendiente.nodo], valor);
+            
+            GrafoCompilado::Rango padres = grafo.getPadres(pendiente.nodo);
+            fila = indiceValor < 0 ? SIN_FILA : 0;
+            for (size_t k = 0; k < padres.size() && fila != SIN_FILA; k++) {
+                LectorTexto::siguienteToken(valores, valor);
+                const DominioLeido& d = dominioDe(padres[k]);
+                int indice = posicionEn(d, valor);
+                fila = indice < 0 ? SIN_FILA : fila * d.valores.size() + indice;
+            }
+        }
+        
+        if (fila != SIN_FILA) {
+            nodosPorIndice[pendiente.nodo]->setProbabilidad(indiceValor, fila, pendiente.probabilidad);
+        } else {
+            std::cerr << "Línea " << pendiente.linea << " - Error: Valores de padres fuera de dominio para "
+                     << nodosPorIndice[pendiente.nodo]->getNombre() << "\n";
+        }
+    }
+    // Los dominios y las tablas cambiaron: se vuelve a compilar el grafo
+    grafo = GrafoCompilado(nodosPorIndice, indicePorNombre);
+    arbolCliques.reset();
+    cache.limpiar();
     
     // Validar que todos los nodos tienen dominio y probabilidades completas
     bool todasCompletas = true;
@@ -212,6 +368,128 @@ bool RedBayesiana::cargarProbabilidades(const std::string& nombreArchivo) {
     return true;
 }
 
+/**
+ * Exporta la red como imagen binaria
+ */
+bool RedBayesiana::exportarImagen(const std::string& nombreArchivo) const {
+    if (nodosPorIndice.empty() || !redUtilizable()) {
+        std::cerr << "Error: No hay una red completa para exportar\n";
+        return false;
+    }
+    
+    if (!ImagenRed::escribir(nombreArchivo, nodosPorIndice, grafo)) {
+        return false;
+    }
+    std::cout << "✓ Imagen exportada: " << nombreArchivo << "\n";
+    return true;
+}
+
+/**
+ * Carga una red desde una imagen binaria
+ * Los nodos se crean con sus dominios y relaciones, y sus tablas apuntan
+ * a la región mapeada, que vive mientras algún nodo la use
+ */
+bool RedBayesiana::cargarImagen(const std::string& nombreArchivo) {
+    std::vector<ImagenRed::NodoImagen> leidos;
+    std::shared_ptr<const void> region;
+    if (!ImagenRed::mapear(nombreArchivo, leidos, region)) {
+        return false;
+    }
+    
+    std::vector<std::shared_ptr<Nodo>> creados;
+    for (const auto& leido : leidos) {
+        creados.push_back(std::make_shared<Nodo>(leido.nombre));
+        creados.back()->setDominio(leido.dominio);
+    }
+    size_t numProbabilidades = 0;
+    for (size_t i = 0; i < leidos.size(); i++) {
+        for (int p : leidos[i].padres) creados[i]->agregarPadre(creados[p]);
+        for (int h : leidos[i].hijos) creados[i]->agregarHijo(creados[h]);
+    }
+    for (size_t i = 0; i < leidos.size(); i++) {
+        creados[i]->usarTablaExterna(leidos[i].tabla, leidos[i].tamanoTabla, region);
+        numProbabilidades += leidos[i].tamanoTabla;
+    }
+    if (!reemplazarNodos(creados)) return false;
+    
+    std::cout << "✓ Imagen cargada: " << nodos.size() << " nodos, "
+              << numProbabilidades << " probabilidades mapeadas\n";
+    return true;
+}
+
+/**
+ * Importa una red BIF o UAI
+ * Los nodos se crean en el orden del archivo; los nombres repetidos ya
+ * fueron rechazados por el importador
+ */
+bool RedBayesiana::importarRed(const std::string& nombreArchivo) {
+    std::vector<ImportadorRed::NodoImportado> leidos;
+    if (!ImportadorRed::leer(nombreArchivo, leidos)) {
+        return false;
+    }
+    
+    std::vector<std::shared_ptr<Nodo>> creados;
+    for (const auto& leido : leidos) {
+        creados.push_back(std::make_shared<Nodo>(leido.nombre));
+        creados.back()->setDominio(leido.dominio);
+    }
+    size_t numProbabilidades = 0;
+    for (size_t i = 0; i < leidos.size(); i++) {
+        for (int p : leidos[i].padres) {
+            creados[i]->agregarPadre(creados[p]);
+            creados[p]->agregarHijo(creados[i]);
+        }
+    }
+    for (size_t i = 0; i < leidos.size(); i++) {
+        creados[i]->prepararTabla();
+        size_t cardinalidad = leidos[i].dominio.size();
+        for (size_t j = 0; j < leidos[i].tabla.size(); j++) {
+            creados[i]->setProbabilidad(static_cast<int>(j % cardinalidad), j / cardinalidad,
+                                        leidos[i].tabla[j]);
+        }
+        numProbabilidades += leidos[i].tabla.size();
+    }
+    if (!reemplazarNodos(creados)) return false;
+    
+    std::cout << "✓ Red importada: " << nodos.size() << " nodos, "
+              << numProbabilidades << " probabilidades\n";
+    return true;
+}
+
+/**
+ * Asigna a cada nodo su posición en el mapa como índice entero y compila
+ * la topología (padres, hijos y orden topológico) por índices. Todo se arma
+ * en variables locales: una estructura con ciclos no toca la red actual
+ */
+bool RedBayesiana::reemplazarNodos(const std::vector<std::shared_ptr<Nodo>>& creados) {
+    std::map<std::string, std::shared_ptr<Nodo>> nuevos;
+    for (const auto& nodo : creados) nuevos[nodo->getNombre()] = nodo;
+    
+    std::vector<std::shared_ptr<Nodo>> porIndice;
+    std::map<std::string, int> indices;
+    for (const auto& par : nuevos) {
+        indices[par.first] = static_cast<int>(porIndice.size());
+        porIndice.push_back(par.second);
+    }
+    GrafoCompilado compilado(porIndice, indices);
+    if (!compilado.esAciclico()) {
+        std::cerr << "Error: La estructura contiene ciclos; no es un grafo acíclico\n";
+        return false;
+    }
+    
+    nodos.swap(nuevos);
+    nodosPorIndice.swap(porIndice);
+    indicePorNombre.swap(indices);
+    grafo = std::move(compilado);
+    nodosRaiz.clear();
+    for (const auto& nodo : creados) {
+        if (nodo->esRaiz()) nodosRaiz.push_back(nodo);
+    }
+    arbolCliques.reset();
+    cache.limpiar();
+    return true;
+}
+
 /**
  * Muestra la estructura de la red
  */
@@ -246,7 +524,7 @@ void RedBayesiana::mostrarEstructuraRecursiva(std::shared_ptr<Nodo> nodo,
     std::cout << "└─ " << nodo->getNombre();
     
     // Mostrar padres
-    auto padres = nodo->getPadres();
+    const auto& padres = nodo->getPadres();
     if (!padres.empty()) {
         std::cout << " [Padres: ";
         for (size_t i = 0; i < padres.size(); i++) {
@@ -259,7 +537,7 @@ void RedBayesiana::mostrarEstructuraRecursiva(std::shared_ptr<Nodo> nodo,
     }
     
     // Mostrar dominio
-    auto dominio = nodo->getDominio();
+    const auto& dominio = nodo->getDominio();
     if (!dominio.empty()) {
         std::cout << " {";
         for (size_t i = 0; i < dominio.size(); i++) {
@@ -293,7 +571,7 @@ void RedBayesiana::mostrarTodasLasTablas() const {
 /**
  * Obtiene un nodo por su nombre
  */
-std::shared_ptr<Nodo> RedBayesiana::obtenerNodo(const std::string& nombre) const {
+std::shared_ptr<const Nodo> RedBayesiana::obtenerNodo(const std::string& nombre) const {
     auto it = nodos.find(nombre);
     if (it != nodos.end()) {
         return it->second;
@@ -313,260 +591,1367 @@ std::vector<std::string> RedBayesiana::obtenerNombresNodos() const {
 }
 
 /**
- * Genera todas las combinaciones de valores para un conjunto de variables
+ * Calcula la probabilidad conjunta P(todas las variables)
+ * Usa la regla de la cadena: P(X1,...,Xn) = ∏ P(Xi | Parents(Xi))
+ * Cada término se obtiene por índices, sin construir claves ni copiar mapas
  */
-std::vector<std::map<std::string, std::string>> RedBayesiana::generarCombinaciones(
-    const std::vector<std::pair<std::string, std::shared_ptr<Nodo>>>& variables) const {
-    
-    std::vector<std::map<std::string, std::string>> resultado;
+double RedBayesiana::calcularProbabilidadConjunta(const VectorArena<int>& estado,
+                                                  const std::vector<int>& factores) const {
+    double probabilidad = 1.0;
     
-    if (variables.empty()) {
-        resultado.push_back(std::map<std::string, std::string>());
-        return resultado;
+    // Para cada nodo, multiplicar P(nodo | padres)
+    for (int i : factores) {
+        probabilidad *= grafo.probabilidad(i, estado.data());
     }
     
-    // Caso base: una variable
-    if (variables.size() == 1) {
-        auto dominio = variables[0].second->getDominio();
-        for (const auto& valor : dominio) {
-            std::map<std::string, std::string> combinacion;
-            combinacion[variables[0].first] = valor;
-            resultado.push_back(combinacion);
+    return probabilidad;
+}
+
+/**
+ * Traduce nombres y valores a índices, validando que existan
+ */
+bool RedBayesiana::resolverAsignacion(const std::map<std::string, std::string>& entrada,
+                                      std::map<int, int>& destino) const {
+    for (const auto& par : entrada) {
+        auto it = indicePorNombre.find(par.first);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << par.first << " no existe en la red\n";
+            return false;
         }
-        return resultado;
-    }
-    
-    // Caso recursivo: combinar primera variable con el resto
-    std::vector<std::pair<std::string, std::shared_ptr<Nodo>>> resto(
-        variables.begin() + 1, variables.end());
-    auto combinacionesResto = generarCombinaciones(resto);
-    
-    auto dominio = variables[0].second->getDominio();
-    for (const auto& valor : dominio) {
-        for (const auto& combResto : combinacionesResto) {
-            std::map<std::string, std::string> combinacion = combResto;
-            combinacion[variables[0].first] = valor;
-            resultado.push_back(combinacion);
+        int valor = nodosPorIndice[it->second]->indiceValor(par.second);
+        if (valor < 0) {
+            std::cerr << "Advertencia: Valor '" << par.second
+                     << "' no está en el dominio de " << par.first << "\n";
+            return false;
         }
+        destino[it->second] = valor;
     }
-    
-    return resultado;
+    return true;
 }
 
 /**
- * Calcula la probabilidad conjunta P(todas las variables)
- * Usa la regla de la cadena: P(X1,...,Xn) = ∏ P(Xi | Parents(Xi))
+ * Construye el factor P(nodo | padres) sobre las variables ordenadas
+ * {nodo} ∪ padres, recorriendo todas sus combinaciones
  */
-double RedBayesiana::calcularProbabilidadConjunta(
-    const std::map<std::string, std::string>& asignacion) const {
+Factor RedBayesiana::factorDeNodo(int indice) const {
+    GrafoCompilado::Rango padres = grafo.getPadres(indice);
+    const size_t* pasosPadres = grafo.getPasosPadres(indice);
     
-    double probabilidad = 1.0;
+    // Variables del factor: el nodo y sus padres, ordenados por índice
+    std::vector<int> familia;
+    familia.push_back(indice);
+    familia.insert(familia.end(), padres.begin(), padres.end());
+    std::vector<int> vars(familia);
+    std::sort(vars.begin(), vars.end());
     
-    // Para cada nodo, multiplicar P(nodo | padres)
-    for (const auto& par : nodos) {
-        std::shared_ptr<Nodo> nodo = par.second;
-        std::string nombreNodo = nodo->getNombre();
-        
-        // Verificar que la variable esté en la asignación
-        if (asignacion.find(nombreNodo) == asignacion.end()) {
-            std::cerr << "Error: Variable " << nombreNodo << " no encontrada en asignación\n";
-            return 0.0;
+    std::vector<int> cards;
+    for (int v : vars) {
+        cards.push_back(grafo.getCardinalidad(v));
+    }
+    
+    // Paso de cada variable del factor dentro de la tabla del nodo
+    std::vector<size_t> pasoTabla(vars.size(), 0);
+    size_t posicionNodo = 0;
+    for (size_t f = 0; f < familia.size(); f++) {
+        size_t pos = std::lower_bound(vars.begin(), vars.end(), familia[f]) - vars.begin();
+        if (f == 0) {
+            posicionNodo = pos;
+        } else {
+            pasoTabla[pos] = pasosPadres[f - 1];
         }
+    }
+    
+    Factor factor(vars, cards);
+    std::vector<int> asignacion(vars.size(), 0);
+    size_t fila = 0;
+    RB_CONTAR_TABLA(factor.tamano());
+    
+    for (size_t k = 0; k < factor.tamano(); k++) {
+        factor[k] = grafo.probabilidad(indice, asignacion[posicionNodo], fila);
         
-        std::string valorNodo = asignacion.at(nombreNodo);
-        
-        // Obtener valores de los padres
-        std::vector<std::string> valoresPadres;
-        for (const auto& padre : nodo->getPadres()) {
-            valoresPadres.push_back(asignacion.at(padre->getNombre()));
+        // Avanzar a la siguiente combinación (la última variable cambia primero)
+        for (size_t l = vars.size(); l-- > 0; ) {
+            if (++asignacion[l] < cards[l]) {
+                fila += pasoTabla[l];
+                break;
+            }
+            fila -= (cards[l] - 1) * pasoTabla[l];
+            asignacion[l] = 0;
         }
-        
-        // Multiplicar probabilidad condicional
-        double prob = nodo->getProbabilidad(valorNodo, valoresPadres);
-        probabilidad *= prob;
     }
     
-    return probabilidad;
+    return factor;
 }
 
 /**
- * Realiza inferencia sin traza
+ * Rechaza las redes con ciclos y los nodos sin dominio
  */
-double RedBayesiana::inferencia(const std::map<std::string, std::string>& consulta,
-                                const std::map<std::string, std::string>& evidencia) {
-    return inferenciaConTraza(consulta, evidencia);
+bool RedBayesiana::redUtilizable() const {
+    if (!grafo.esAciclico()) {
+        std::cerr << "Error: La estructura contiene ciclos; no se puede inferir\n";
+        return false;
+    }
+    for (const auto& nodo : nodosPorIndice) {
+        if (nodo->getDominio().empty()) {
+            std::cerr << "Error: Nodo '" << nodo->getNombre()
+                     << "' no tiene dominio definido\n";
+            return false;
+        }
+    }
+    return true;
 }
 
 /**
- * Realiza inferencia por enumeración con traza detallada
- * Calcula P(consulta | evidencia)
+ * Calcula la subred relevante según la configuración de poda
  */
-double RedBayesiana::inferenciaConTraza(
-    const std::map<std::string, std::string>& consulta,
-    const std::map<std::string, std::string>& evidencia) {
+SubredRelevante RedBayesiana::subredDe(const std::vector<int>& variablesConsulta,
+                                       const std::map<int, int>& evidencia) const {
+    RB_FASE(PODA);
+    SubredRelevante subred(grafo, variablesConsulta, evidencia, podaRelevancia);
+    RB_FASE(PREPARACION);
+    return subred;
+}
+
+/**
+ * Muestra los nodos podados de una subred
+ */
+void RedBayesiana::mostrarPoda(const SubredRelevante& subred) const {
+    auto mostrarLista = [&](const std::vector<int>& lista) {
+        if (lista.empty()) {
+            std::cout << "Ninguno";
+            return;
+        }
+        for (size_t k = 0; k < lista.size(); k++) {
+            if (k > 0) std::cout << ", ";
+            std::cout << nodosPorIndice[lista[k]]->getNombre();
+        }
+    };
     
-    std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
-    std::cout << "║      PROCESO DE INFERENCIA POR ENUMERACIÓN        ║\n";
-    std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+    std::cout << "NODOS PODADOS:\n";
+    std::cout << "  Estériles (no son ancestros): ";
+    mostrarLista(subred.getEsteriles());
+    std::cout << "\n  d-separados de la consulta:   ";
+    mostrarLista(subred.getSeparados());
+    std::cout << "\n\n";
+}
+
+/**
+ * Inferencia por eliminación de variables
+ * 1. Crea un factor por cada tabla de la subred y lo reduce con la evidencia
+ * 2. Elige el orden de eliminación de las variables ocultas
+ * 3. Las elimina y normaliza el producto de los factores restantes
+ */
+Factor RedBayesiana::eliminacionVariables(const std::vector<int>& variablesConsulta,
+                                          const std::map<int, int>& evidencia,
+                                          const SubredRelevante& subred) const {
+    // Factores iniciales reducidos por la evidencia
+    VectorArena<Factor> factores;
+    factores.reserve(subred.getFactores().size());
+    for (int i : subred.getFactores()) {
+        Factor factor = factorDeNodo(i);
+        for (const auto& obs : evidencia) {
+            if (factor.contiene(obs.first)) {
+                factor = factor.reducir(obs.first, obs.second);
+            }
+        }
+        factores.push_back(factor);
+    }
     
-    // Mostrar consulta
-    std::cout << "CONSULTA: P(";
-    bool primero = true;
-    for (const auto& par : consulta) {
-        if (!primero) std::cout << ", ";
-        std::cout << par.first << "=" << par.second;
-        primero = false;
+    RB_FASE(CALCULO);
+    OrdenEliminacion orden = ordenarEliminacion(variablesConsulta, evidencia, subred, heuristicaOrden);
+    return eliminarEnOrden(factores, orden.getOrden(), Factor());
+}
+
+/**
+ * Los alcances son las familias (nodo y padres) de las tablas de la subred
+ * sin las variables observadas; las ocultas, las variables de la subred que
+ * no son de consulta ni de evidencia, en orden de índice
+ */
+OrdenEliminacion RedBayesiana::ordenarEliminacion(const std::vector<int>& variablesConsulta,
+                                                  const std::map<int, int>& evidencia,
+                                                  const SubredRelevante& subred,
+                                                  HeuristicaOrden heuristica) const {
+    std::vector<std::vector<int>> alcances;
+    for (int i : subred.getFactores()) {
+        std::vector<int> alcance;
+        if (!evidencia.count(i)) alcance.push_back(i);
+        for (int padre : grafo.getPadres(i)) {
+            if (!evidencia.count(padre)) alcance.push_back(padre);
+        }
+        alcances.push_back(alcance);
     }
-    std::cout << ")\n\n";
     
-    // Mostrar evidencia
-    std::cout << "EVIDENCIA: ";
-    if (evidencia.empty()) {
-        std::cout << "Ninguna";
-    } else {
-        primero = true;
-        for (const auto& par : evidencia) {
-            if (!primero) std::cout << ", ";
-            std::cout << par.first << "=" << par.second;
-            primero = false;
+    std::vector<int> ocultas;
+    for (int v : subred.getVariables()) {
+        if (std::find(variablesConsulta.begin(), variablesConsulta.end(), v) == variablesConsulta.end() &&
+            !evidencia.count(v)) {
+            ocultas.push_back(v);
         }
     }
-    std::cout << "\n\n";
     
-    // Identificar variables ocultas
-    std::vector<std::pair<std::string, std::shared_ptr<Nodo>>> variablesOcultas;
-    for (const auto& par : nodos) {
-        std::string nombre = par.first;
-        if (consulta.find(nombre) == consulta.end() &&
-            evidencia.find(nombre) == evidencia.end()) {
-            variablesOcultas.push_back({nombre, par.second});
+    return OrdenEliminacion(alcances, ocultas, grafo.getCardinalidades(), heuristica);
+}
+
+/**
+ * Elimina cada variable multiplicando los factores que la mencionan y
+ * sumándola del producto; luego multiplica lo que queda (solo variables
+ * de consulta) y normaliza
+ */
+template <typename TipoFactor>
+TipoFactor RedBayesiana::eliminarEnOrden(VectorArena<TipoFactor> factores,
+                                         const std::vector<int>& orden,
+                                         const TipoFactor& unidad) const {
+    for (int variable : orden) {
+        TipoFactor producto(unidad);
+        VectorArena<TipoFactor> restantes;
+        restantes.reserve(factores.size());
+        for (auto& factor : factores) {
+            if (factor.contiene(variable)) {
+                producto = producto.producto(factor);
+            } else {
+                restantes.push_back(std::move(factor));
+            }
         }
+        restantes.push_back(producto.sumarVariable(variable));
+        factores.swap(restantes);
     }
     
-    std::cout << "VARIABLES OCULTAS: ";
-    if (variablesOcultas.empty()) {
-        std::cout << "Ninguna";
-    } else {
-        for (size_t i = 0; i < variablesOcultas.size(); i++) {
-            std::cout << variablesOcultas[i].first;
-            if (i < variablesOcultas.size() - 1) std::cout << ", ";
+    // Factor final sobre las variables de consulta
+    TipoFactor resultado(unidad);
+    for (const auto& factor : factores) {
+        resultado = resultado.producto(factor);
+    }
+    RB_FASE(NORMALIZACION);
+    resultado.normalizar();
+    
+    return resultado;
+}
+
+/**
+ * Fija la evidencia y ordena las variables a recorrer: primero las ocultas
+ * de la subred y al final las de consulta
+ */
+PlanEnumeracion RedBayesiana::prepararRecorrido(const std::vector<int>& variablesConsulta,
+                                                const std::map<int, int>& evidencia,
+                                                const SubredRelevante& subred) const {
+    PlanEnumeracion recorrido;
+    recorrido.estado.assign(nodosPorIndice.size(), 0);
+    for (const auto& par : evidencia) recorrido.estado[par.first] = par.second;
+    recorrido.factores = subred.getFactores();
+    
+    // Variables recorridas: primero las ocultas y al final las de consulta
+    for (int v : subred.getVariables()) {
+        if (std::find(variablesConsulta.begin(), variablesConsulta.end(), v) == variablesConsulta.end() &&
+            evidencia.find(v) == evidencia.end()) {
+            recorrido.variables.push_back(v);
+            recorrido.cardinalidades.push_back(grafo.getCardinalidad(v));
         }
     }
-    std::cout << "\n\n";
     
-    // Generar combinaciones de variables ocultas
-    auto combinacionesOcultas = generarCombinaciones(variablesOcultas);
+    // Paso de cada variable de consulta en el vector de resultados
+    recorrido.pasosConsulta.assign(variablesConsulta.size(), 1);
+    recorrido.casillas = 1;
+    for (size_t k = variablesConsulta.size(); k-- > 0; ) {
+        recorrido.pasosConsulta[k] = recorrido.casillas;
+        recorrido.casillas *= grafo.getCardinalidad(variablesConsulta[k]);
+    }
+    for (int v : variablesConsulta) {
+        recorrido.variables.push_back(v);
+        recorrido.cardinalidades.push_back(grafo.getCardinalidad(v));
+    }
     
-    std::cout << "─────────────────────────────────────────────────────\n";
-    std::cout << "     Calculando P(Consulta, Evidencia):\n";
-    std::cout << "─────────────────────────────────────────────────────\n\n";
+    return recorrido;
+}
+
+/**
+ * Enumeración en una sola pasada
+ */
+std::vector<double> RedBayesiana::enumeracionPosterior(const std::vector<int>& variablesConsulta,
+                                                       const std::map<int, int>& evidencia,
+                                                       const SubredRelevante& subred,
+                                                       bool traza) const {
+    PlanEnumeracion recorrido = prepararRecorrido(variablesConsulta, evidencia, subred);
+    VectorArena<int> estado(recorrido.estado.begin(), recorrido.estado.end());
+    std::vector<double> resultado;
+    recorrerEnumeracion(variablesConsulta, recorrido, estado, traza, resultado);
+    return resultado;
+}
+
+/**
+ * Recorre las combinaciones de ocultas y consulta; cada probabilidad
+ * conjunta se acumula en la casilla de su combinación de consulta.
+ * La suma de todas las casillas es P(evidencia)
+ */
+void RedBayesiana::recorrerEnumeracion(const std::vector<int>& variablesConsulta,
+                                       const PlanEnumeracion& recorrido,
+                                       VectorArena<int>& estado,
+                                       bool traza,
+                                       std::vector<double>& resultado) const {
+    const std::vector<int>& variables = recorrido.variables;
+    const std::vector<size_t>& pasosConsulta = recorrido.pasosConsulta;
     
-    double probConsultaYEvidencia = 0.0;
+    resultado.assign(recorrido.casillas, 0.0);
     int iteracion = 1;
     
-    // Sumar sobre todas las combinaciones de variables ocultas
-    for (const auto& combinacionOculta : combinacionesOcultas) {
-        // Crear asignación completa
-        std::map<std::string, std::string> asignacionCompleta;
-        
-        // Agregar consulta
-        for (const auto& par : consulta) {
-            asignacionCompleta[par.first] = par.second;
-        }
-        
-        // Agregar evidencia
-        for (const auto& par : evidencia) {
-            asignacionCompleta[par.first] = par.second;
-        }
+    IteradorAsignaciones iterador(estado, variables, recorrido.cardinalidades);
+    RB_FASE(CALCULO);
+    for (; iterador.valido(); iterador.avanzar()) {
+        double prob = calcularProbabilidadConjunta(estado, recorrido.factores);
         
-        // Agregar variables ocultas
-        for (const auto& par : combinacionOculta) {
-            asignacionCompleta[par.first] = par.second;
+        size_t casilla = 0;
+        for (size_t k = 0; k < variablesConsulta.size(); k++) {
+            casilla += estado[variablesConsulta[k]] * pasosConsulta[k];
         }
+        resultado[casilla] += prob;
         
-        // Calcular probabilidad conjunta
-        double prob = calcularProbabilidadConjunta(asignacionCompleta);
-        
-        std::cout << "  [" << std::setw(2) << iteracion++ << "] ";
-        for (const auto& par : combinacionOculta) {
-            std::cout << par.first << "=" << par.second << " ";
+        if (traza) {
+            std::cout << "  [" << std::setw(2) << iteracion++ << "] ";
+            for (int v : variables) {
+                const Nodo& nodo = *nodosPorIndice[v];
+                std::cout << nodo.getNombre() << "=" << nodo.getDominio()[estado[v]] << " ";
+            }
+            std::cout << " => P = " << std::fixed << std::setprecision(6) << prob << "\n";
         }
-        std::cout << " => P = " << std::fixed << std::setprecision(6) << prob << "\n";
-        
-        probConsultaYEvidencia += prob;
+    }
+    RB_CONTAR_ASIGNACIONES(iterador.total());
+    RB_CONTAR_TABLA(iterador.total() * recorrido.factores.size());
+}
+
+/**
+ * Enumeración paralela
+ */
+std::vector<double> RedBayesiana::enumeracionParalela(const std::vector<int>& variablesConsulta,
+                                                      const std::map<int, int>& evidencia,
+                                                      const SubredRelevante& subred) const {
+    const PlanEnumeracion recorrido = prepararRecorrido(variablesConsulta, evidencia, subred);
+    VectorArena<int> estado(recorrido.estado.begin(), recorrido.estado.end());
+    return recorrerEnumeracionParalela(variablesConsulta, recorrido, estado);
+}
+
+/**
+ * El espacio de combinaciones se divide en bloques de tamaño fijo, que
+ * los hilos procesan con robo de trabajo. Cada bloque posiciona su propio
+ * iterador y acumula en sus propias casillas; las sumas parciales se
+ * combinan al final en el orden de los bloques, de modo que el resultado
+ * es idéntico bit a bit sin importar el número de hilos
+ */
+std::vector<double> RedBayesiana::recorrerEnumeracionParalela(const std::vector<int>& variablesConsulta,
+                                                              const PlanEnumeracion& recorrido,
+                                                              const VectorArena<int>& estadoInicial) const {
+    unsigned long long total = 1;
+    for (int c : recorrido.cardinalidades) {
+        total *= static_cast<unsigned long long>(c);
     }
     
-    std::cout << "\nΣ P(Consulta, Evidencia, Ocultas) = " << std::fixed 
-              << std::setprecision(6) << probConsultaYEvidencia << "\n\n";
+    // El número de bloques depende solo del tamaño del espacio
+    const unsigned long long minimoPorBloque = 4096;
+    const unsigned long long maximoBloques = 4096;
+    unsigned long long numBloques = (total + minimoPorBloque - 1) / minimoPorBloque;
+    if (numBloques > maximoBloques) numBloques = maximoBloques;
+    if (numBloques == 0) numBloques = 1;
     
-    // Si hay evidencia, calcular P(Evidencia) para normalizar
-    if (!evidencia.empty()) {
-        std::cout << "─────────────────────────────────────────────────────\n";
-        std::cout << "        Calculando P(Evidencia):\n";
-        std::cout << "─────────────────────────────────────────────────────\n\n";
-        
-        // Variables ocultas ahora incluyen también la consulta
-        std::vector<std::pair<std::string, std::shared_ptr<Nodo>>> todasVariablesOcultas = variablesOcultas;
-        for (const auto& par : consulta) {
-            todasVariablesOcultas.push_back({par.first, obtenerNodo(par.first)});
-        }
-        
-        auto todasCombinaciones = generarCombinaciones(todasVariablesOcultas);
-        double probEvidencia = 0.0;
-        iteracion = 1;
+    std::vector<std::vector<double>> parciales(numBloques);
+    std::vector<EstadisticasArena> memoriaBloques(numBloques, EstadisticasArena());
+    
+    // Cada bloque trabaja en la arena de su hilo; lo que reservó se toma de
+    // los contadores de esa arena, porque en los hilos del pool no hay
+    // medición activa
+    auto procesarBloque = [&](size_t bloque) {
+        unsigned long long inicio = total * bloque / numBloques;
+        unsigned long long fin = total * (bloque + 1) / numBloques;
         
-        for (const auto& combinacion : todasCombinaciones) {
-            std::map<std::string, std::string> asignacionCompleta;
-            
-            // Agregar evidencia
-            for (const auto& par : evidencia) {
-                asignacionCompleta[par.first] = par.second;
-            }
-            
-            // Agregar todas las demás variables
-            for (const auto& par : combinacion) {
-                asignacionCompleta[par.first] = par.second;
-            }
-            
-            double prob = calcularProbabilidadConjunta(asignacionCompleta);
+        ArenaConsulta& memoria = ArenaConsulta::delHilo();
+        EstadisticasArena antes = memoria.getEstadisticas();
+        std::vector<double> casillas(recorrido.casillas, 0.0);
+        {
+            ArenaConsulta::Ambito arena;
+            VectorArena<int> estado(estadoInicial);
+            IteradorAsignaciones iterador(estado, recorrido.variables, recorrido.cardinalidades);
+            iterador.posicionar(inicio);
             
-            std::cout << "  [" << std::setw(2) << iteracion++ << "] ";
-            for (const auto& par : combinacion) {
-                std::cout << par.first << "=" << par.second << " ";
+            for (unsigned long long k = inicio; k < fin && iterador.valido(); k++, iterador.avanzar()) {
+                size_t casilla = 0;
+                for (size_t q = 0; q < variablesConsulta.size(); q++) {
+                    casilla += estado[variablesConsulta[q]] * recorrido.pasosConsulta[q];
+                }
+                casillas[casilla] += calcularProbabilidadConjunta(estado, recorrido.factores);
             }
-            std::cout << " => P = " << std::fixed << std::setprecision(6) << prob << "\n";
-            
-            probEvidencia += prob;
         }
+        EstadisticasArena despues = memoria.getEstadisticas();
+        memoriaBloques[bloque].reservas = despues.reservas - antes.reservas;
+        memoriaBloques[bloque].reservasSistema = despues.reservasSistema - antes.reservasSistema;
+        parciales[bloque].swap(casillas);
+    };
+    
+    // Los bloques no miden: los contadores se suman aquí, en el hilo que mide
+    RB_FASE(CALCULO);
+    PoolHilos& hilos = pool ? *pool : PoolHilos::compartido();
+    hilos.ejecutar(static_cast<size_t>(numBloques), procesarBloque);
+    EstadisticasArena memoria = EstadisticasArena();
+    for (const EstadisticasArena& m : memoriaBloques) {
+        memoria.reservas += m.reservas;
+        memoria.reservasSistema += m.reservasSistema;
+    }
+    RB_CONTAR_RESERVAS(memoria.reservas, memoria.reservasSistema);
+    RB_CONTAR_ASIGNACIONES(total);
+    RB_CONTAR_TABLA(total * recorrido.factores.size());
+    
+    // Reducción en orden fijo
+    std::vector<double> resultado(recorrido.casillas, 0.0);
+    for (const auto& parcial : parciales) {
+        for (size_t c = 0; c < parcial.size(); c++) {
+            resultado[c] += parcial[c];
+        }
+    }
+    return resultado;
+}
+
+/**
+ * Enumeración recursiva
+ * Para cada combinación de la consulta calcula
+ *   Σ_{x1} P(x1 | pa) Σ_{x2} P(x2 | pa) ... Σ_{xn} P(xn | pa)
+ * con los nodos en orden topológico: la probabilidad de un nodo solo
+ * depende de niveles anteriores, así que se lee una vez por prefijo y se
+ * multiplica por la suma de todo lo que sigue, en lugar de recalcular el
+ * producto completo en cada asignación. Las ramas con probabilidad cero
+ * no se recorren
+ */
+std::vector<double> RedBayesiana::enumeracionRecursiva(const std::vector<int>& variablesConsulta,
+                                                       const std::map<int, int>& evidencia,
+                                                       const SubredRelevante& subred) const {
+    size_t n = grafo.getNumeroNodos();
+    VectorArena<int> estado(n, 0);
+    std::vector<bool> fijos(n, false);
+    for (const auto& par : evidencia) {
+        estado[par.first] = par.second;
+        fijos[par.first] = true;
+    }
+    std::vector<int> cardinalidades;
+    for (int v : variablesConsulta) {
+        fijos[v] = true;
+        cardinalidades.push_back(grafo.getCardinalidad(v));
+    }
+    
+    std::vector<int> orden = ordenRecursivo(subred);
+    std::vector<double> resultado;
+    recorrerRecursivo(variablesConsulta, cardinalidades, orden, fijos, estado, resultado);
+    return resultado;
+}
+
+/**
+ * Filtra el orden topológico de la red a los nodos con tabla de la subred
+ */
+std::vector<int> RedBayesiana::ordenRecursivo(const SubredRelevante& subred) const {
+    std::vector<bool> conTabla(grafo.getNumeroNodos(), false);
+    for (int v : subred.getFactores()) conTabla[v] = true;
+    std::vector<int> orden;
+    for (int v : grafo.getOrdenTopologico()) {
+        if (conTabla[v]) orden.push_back(v);
+    }
+    return orden;
+}
+
+/**
+ * Recorre las combinaciones de la consulta en orden por filas y suma el
+ * resto de la red para cada una
+ */
+void RedBayesiana::recorrerRecursivo(const std::vector<int>& variablesConsulta,
+                                     const std::vector<int>& cardinalidadesConsulta,
+                                     const std::vector<int>& orden,
+                                     const std::vector<bool>& fijos,
+                                     VectorArena<int>& estado,
+                                     std::vector<double>& resultado) const {
+    RecorridoRecursivo recorrido{orden, fijos, estado, 0, 0};
+    
+    IteradorAsignaciones iterador(estado, variablesConsulta, cardinalidadesConsulta);
+    resultado.clear();
+    resultado.reserve(static_cast<size_t>(iterador.total()));
+    RB_FASE(CALCULO);
+    for (; iterador.valido(); iterador.avanzar()) {
+        resultado.push_back(sumarDesde(recorrido, 0));
+    }
+    RB_CONTAR_ASIGNACIONES(recorrido.hojas);
+    RB_CONTAR_TABLA(recorrido.lecturas);
+}
+
+/**
+ * Un nivel de la recursión: nodo fijo -> su probabilidad por el resto;
+ * nodo oculto -> suma sobre sus valores
+ */
+double RedBayesiana::sumarDesde(RecorridoRecursivo& recorrido, size_t nivel) const {
+    if (nivel == recorrido.orden.size()) {
+        recorrido.hojas++;
+        return 1.0;
+    }
+    
+    int v = recorrido.orden[nivel];
+    VectorArena<int>& estado = recorrido.estado;
+    size_t fila = grafo.fila(v, estado.data());
+    if (recorrido.fijo[v]) {
+        recorrido.lecturas++;
+        double p = grafo.probabilidad(v, estado[v], fila);
+        return p == 0.0 ? 0.0 : p * sumarDesde(recorrido, nivel + 1);
+    }
+    
+    double suma = 0.0;
+    int cardinalidad = grafo.getCardinalidad(v);
+    for (int valor = 0; valor < cardinalidad; valor++) {
+        recorrido.lecturas++;
+        double p = grafo.probabilidad(v, valor, fila);
+        if (p == 0.0) continue;
+        estado[v] = valor;
+        suma += p * sumarDesde(recorrido, nivel + 1);
+    }
+    return suma;
+}
+
+/**
+ * Distribución posterior normalizada sobre índices ya resueltos
+ */
+std::vector<double> RedBayesiana::posterior(const std::vector<int>& variablesConsulta,
+                                            const std::map<int, int>& evidencia,
+                                            MetodoInferencia metodo) const {
+    SubredRelevante subred = subredDe(variablesConsulta, evidencia);
+    if (metodo == MetodoInferencia::ELIMINACION_VARIABLES) {
+        Factor resultado = eliminacionVariables(variablesConsulta, evidencia, subred);
+        return resultado.valoresEnOrden(variablesConsulta);
+    }
+    
+    std::vector<double> resultado;
+    if (metodo == MetodoInferencia::ENUMERACION_PARALELA) {
+        resultado = enumeracionParalela(variablesConsulta, evidencia, subred);
+    } else if (metodo == MetodoInferencia::ENUMERACION_RECURSIVA) {
+        resultado = enumeracionRecursiva(variablesConsulta, evidencia, subred);
+    } else {
+        resultado = enumeracionPosterior(variablesConsulta, evidencia, subred, false);
+    }
+    RB_FASE(NORMALIZACION);
+    double probEvidencia = 0.0;
+    for (double p : resultado) probEvidencia += p;
+    if (probEvidencia > 0.0) {
+        for (double& p : resultado) p /= probEvidencia;
+    }
+    return resultado;
+}
+
+/**
+ * Calcula la distribución posterior completa de las variables de consulta
+ */
+std::vector<double> RedBayesiana::distribucionPosterior(
+    const std::vector<std::string>& variablesConsulta,
+    const std::map<std::string, std::string>& evidencia,
+    MetodoInferencia metodo) const {
+    
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    std::map<int, int> valoresEvidencia;
+    if (!redUtilizable() || !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return std::vector<double>();
+    }
+    
+    std::vector<int> variables;
+    for (const auto& nombre : variablesConsulta) {
+        auto it = indicePorNombre.find(nombre);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << nombre << " no existe en la red\n";
+            return std::vector<double>();
+        }
+        if (valoresEvidencia.count(it->second) ||
+            std::find(variables.begin(), variables.end(), it->second) != variables.end()) {
+            std::cerr << "Error: Variable " << nombre << " repetida en la consulta o en la evidencia\n";
+            return std::vector<double>();
+        }
+        variables.push_back(it->second);
+    }
+    
+    return posterior(variables, valoresEvidencia, metodo);
+}
+
+/**
+ * Prepara una forma de consulta
+ * 1. Resuelve los nombres a índices y rechaza variables repetidas
+ * 2. Poda la red: la subred solo depende de qué nodos están observados,
+ *    así que se calcula con valores cualesquiera
+ * 3. Arma el plan del método, que cada ejecución recorre sin rehacerlo
+ */
+ConsultaPreparada RedBayesiana::preparar(const std::vector<std::string>& variablesConsulta,
+                                         const std::vector<std::string>& variablesEvidencia,
+                                         MetodoInferencia metodo) const {
+    if (!redUtilizable()) {
+        return ConsultaPreparada();
+    }
+    
+    ConsultaPreparada preparada(this, metodo);
+    auto resolver = [&](const std::string& nombre, std::vector<int>& destino) {
+        auto it = indicePorNombre.find(nombre);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << nombre << " no existe en la red\n";
+            return false;
+        }
+        if (std::find(preparada.consulta.begin(), preparada.consulta.end(), it->second) != preparada.consulta.end() ||
+            std::find(preparada.evidencia.begin(), preparada.evidencia.end(), it->second) != preparada.evidencia.end()) {
+            std::cerr << "Error: Variable " << nombre << " repetida en la consulta o en la evidencia\n";
+            return false;
+        }
+        destino.push_back(it->second);
+        return true;
+    };
+    for (const auto& nombre : variablesEvidencia) {
+        if (!resolver(nombre, preparada.evidencia)) return ConsultaPreparada();
+    }
+    for (const auto& nombre : variablesConsulta) {
+        if (!resolver(nombre, preparada.consulta)) return ConsultaPreparada();
+    }
+    
+    std::map<int, int> evidencia;
+    for (int v : preparada.evidencia) {
+        evidencia[v] = 0;
+        preparada.cardinalidadesEvidencia.push_back(grafo.getCardinalidad(v));
+    }
+    SubredRelevante subred = subredDe(preparada.consulta, evidencia);
+    
+    // El costo de la eliminación se calcula con cualquier método, para
+    // poder comparar motores con la misma consulta preparada
+    OrdenEliminacion orden = ordenarEliminacion(preparada.consulta, evidencia, subred, heuristicaOrden);
+    preparada.costo = orden.getCosto();
+    
+    if (metodo == MetodoInferencia::ELIMINACION_VARIABLES) {
+        // Los factores se guardan sin reducir; el orden usa los alcances
+        // que tendrán una vez reducidos
+        for (int i : subred.getFactores()) {
+            preparada.factores.push_back(factorDeNodo(i));
+        }
+        preparada.ordenEliminacion = orden.getOrden();
+        preparada.plan.casillas = 1;
+        for (int v : preparada.consulta) preparada.plan.casillas *= grafo.getCardinalidad(v);
+    } else if (metodo == MetodoInferencia::ENUMERACION_RECURSIVA) {
+        preparada.ordenRecursivo = ordenRecursivo(subred);
+        preparada.fijos.assign(grafo.getNumeroNodos(), false);
+        for (int v : preparada.evidencia) preparada.fijos[v] = true;
+        for (int v : preparada.consulta) preparada.fijos[v] = true;
+        preparada.plan.estado.assign(grafo.getNumeroNodos(), 0);
+        preparada.plan.casillas = 1;
+        for (int v : preparada.consulta) {
+            preparada.plan.cardinalidades.push_back(grafo.getCardinalidad(v));
+            preparada.plan.casillas *= grafo.getCardinalidad(v);
+        }
+    } else {
+        preparada.plan = prepararRecorrido(preparada.consulta, evidencia, subred);
+    }
+    
+    return preparada;
+}
+
+/**
+ * Estima el costo de la eliminación de variables para una forma de consulta
+ * Resuelve los nombres, poda la red como lo haría la inferencia y simula
+ * la eliminación con la heurística pedida
+ */
+bool RedBayesiana::estimarCosto(const std::vector<std::string>& variablesConsulta,
+                                const std::vector<std::string>& variablesEvidencia,
+                                HeuristicaOrden heuristica,
+                                CostoEliminacion& costo) const {
+    std::vector<int> consulta;
+    std::map<int, int> evidencia;
+    for (const auto& nombre : variablesConsulta) {
+        auto it = indicePorNombre.find(nombre);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << nombre << " no existe en la red\n";
+            return false;
+        }
+        consulta.push_back(it->second);
+    }
+    for (const auto& nombre : variablesEvidencia) {
+        auto it = indicePorNombre.find(nombre);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << nombre << " no existe en la red\n";
+            return false;
+        }
+        evidencia[it->second] = 0;
+    }
+    
+    SubredRelevante subred = subredDe(consulta, evidencia);
+    costo = ordenarEliminacion(consulta, evidencia, subred, heuristica).getCosto();
+    return true;
+}
+
+/**
+ * Traduce los valores observados a índices, en el orden de la preparación
+ */
+bool RedBayesiana::indicesEvidencia(const ConsultaPreparada& consulta,
+                                    const std::vector<std::string>& valores,
+                                    std::vector<int>& destino) const {
+    if (consulta.red != this || valores.size() != consulta.evidencia.size()) {
+        std::cerr << "Error: Los valores no corresponden a la consulta preparada\n";
+        return false;
+    }
+    destino.resize(valores.size());
+    for (size_t k = 0; k < valores.size(); k++) {
+        const Nodo& nodo = *nodosPorIndice[consulta.evidencia[k]];
+        destino[k] = nodo.indiceValor(valores[k]);
+        if (destino[k] < 0) {
+            std::cerr << "Error: Valor " << valores[k] << " no pertenece al dominio de "
+                     << nodo.getNombre() << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Ejecuta una consulta preparada: fija los valores observados y recorre
+ * el plan. El resultado no pasa por la caché, que indexa por nombres
+ */
+std::vector<double> RedBayesiana::ejecutar(const ConsultaPreparada& consulta,
+                                           const std::vector<int>& valoresEvidencia) const {
+    std::vector<double> resultado;
+    ejecutar(consulta, valoresEvidencia, resultado);
+    return resultado;
+}
+
+/**
+ * Valida la consulta y los valores, y recorre el plan dentro de un ámbito
+ * de la arena
+ */
+bool RedBayesiana::ejecutar(const ConsultaPreparada& consulta,
+                            const std::vector<int>& valoresEvidencia,
+                            std::vector<double>& resultado) const {
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    resultado.clear();
+    if (consulta.red != this) {
+        std::cerr << "Error: La consulta preparada no pertenece a esta red\n";
+        return false;
+    }
+    if (valoresEvidencia.size() != consulta.evidencia.size()) {
+        std::cerr << "Error: Se esperaban " << consulta.evidencia.size()
+                 << " valores de evidencia\n";
+        return false;
+    }
+    for (size_t k = 0; k < valoresEvidencia.size(); k++) {
+        if (valoresEvidencia[k] < 0 || valoresEvidencia[k] >= consulta.cardinalidadesEvidencia[k]) {
+            std::cerr << "Error: Valor fuera del dominio de "
+                     << nodosPorIndice[consulta.evidencia[k]]->getNombre() << "\n";
+            return false;
+        }
+    }
+    ejecutarPlan(consulta, valoresEvidencia, resultado);
+    return true;
+}
+
+/**
+ * Recorre el plan del método con los valores observados
+ */
+void RedBayesiana::ejecutarPlan(const ConsultaPreparada& consulta,
+                                const std::vector<int>& valoresEvidencia,
+                                std::vector<double>& resultado) const {
+    if (consulta.metodo == MetodoInferencia::ELIMINACION_VARIABLES) {
+        VectorArena<Factor> factores;
+        factores.reserve(consulta.factores.size());
+        for (const Factor& base : consulta.factores) {
+            Factor reducido;
+            bool reduce = false;
+            for (size_t k = 0; k < consulta.evidencia.size(); k++) {
+                const Factor& actual = reduce ? reducido : base;
+                if (actual.contiene(consulta.evidencia[k])) {
+                    reducido = actual.reducir(consulta.evidencia[k], valoresEvidencia[k]);
+                    reduce = true;
+                }
+            }
+            factores.push_back(reduce ? std::move(reducido) : base);
+        }
+        RB_FASE(CALCULO);
+        Factor final = eliminarEnOrden(std::move(factores), consulta.ordenEliminacion, Factor());
+        final.valoresEnOrden(consulta.consulta, resultado);
+        return;
+    }
+    
+    VectorArena<int> estado(consulta.plan.estado.begin(), consulta.plan.estado.end());
+    for (size_t k = 0; k < valoresEvidencia.size(); k++) {
+        estado[consulta.evidencia[k]] = valoresEvidencia[k];
+    }
+    if (consulta.metodo == MetodoInferencia::ENUMERACION_PARALELA) {
+        resultado = recorrerEnumeracionParalela(consulta.consulta, consulta.plan, estado);
+    } else if (consulta.metodo == MetodoInferencia::ENUMERACION_RECURSIVA) {
+        recorrerRecursivo(consulta.consulta, consulta.plan.cardinalidades, consulta.ordenRecursivo,
+                          consulta.fijos, estado, resultado);
+    } else {
+        recorrerEnumeracion(consulta.consulta, consulta.plan, estado, false, resultado);
+    }
+    RB_FASE(NORMALIZACION);
+    double probEvidencia = 0.0;
+    for (double p : resultado) probEvidencia += p;
+    if (probEvidencia > 0.0) {
+        for (double& p : resultado) p /= probEvidencia;
+    }
+}
+
+/**
+ * Ejecuta una consulta preparada para un lote de casos
+ * Con eliminación de variables los casos se procesan en bloques: cada
+ * factor base se reduce con la evidencia de todos los casos del bloque
+ * (FactorLote) y el mismo orden de eliminación se aplica una sola vez al
+ * bloque completo. Los bloques acotan la memoria de los factores
+ * intermedios; el último se rellena hasta un múltiplo de FactorLote::ANCHO
+ * con casos de descarte
+ */
+std::vector<double> RedBayesiana::ejecutarLote(const ConsultaPreparada& consulta,
+                                               const std::vector<std::vector<int>>& columnas,
+                                               size_t numCasos) const {
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    if (consulta.red != this) {
+        std::cerr << "Error: La consulta preparada no pertenece a esta red\n";
+        return std::vector<double>();
+    }
+    if (columnas.size() != consulta.evidencia.size()) {
+        std::cerr << "Error: Se esperaban " << consulta.evidencia.size()
+                 << " columnas de evidencia\n";
+        return std::vector<double>();
+    }
+    for (size_t k = 0; k < columnas.size(); k++) {
+        const std::string& nombre = nodosPorIndice[consulta.evidencia[k]]->getNombre();
+        if (columnas[k].size() != numCasos) {
+            std::cerr << "Error: La columna de " << nombre << " no tiene "
+                     << numCasos << " casos\n";
+            return std::vector<double>();
+        }
+        for (int valor : columnas[k]) {
+            if (valor < 0 || valor >= consulta.cardinalidadesEvidencia[k]) {
+                std::cerr << "Error: Valor fuera del dominio de " << nombre << "\n";
+                return std::vector<double>();
+            }
+        }
+    }
+    
+    size_t casillas = consulta.getNumeroCasillas();
+    std::vector<double> resultado(numCasos * casillas, 0.0);
+    
+    if (consulta.metodo != MetodoInferencia::ELIMINACION_VARIABLES) {
+        std::vector<int> valores(columnas.size());
+        std::vector<double> distribucion;
+        ArenaConsulta& memoria = ArenaConsulta::delHilo();
+        for (size_t caso = 0; caso < numCasos; caso++) {
+            ArenaConsulta::Marca marca = memoria.marcar();
+            for (size_t k = 0; k < columnas.size(); k++) valores[k] = columnas[k][caso];
+            ejecutarPlan(consulta, valores, distribucion);
+            std::copy(distribucion.begin(), distribucion.end(), resultado.begin() + caso * casillas);
+            memoria.restaurar(marca);
+        }
+        return resultado;
+    }
+    
+    // Posición en el factor final (variables ordenadas por índice) de cada
+    // casilla en el orden de la consulta
+    std::vector<int> ordenadas(consulta.consulta);
+    std::sort(ordenadas.begin(), ordenadas.end());
+    std::vector<int> cardinalidades;
+    for (int v : ordenadas) cardinalidades.push_back(grafo.getCardinalidad(v));
+    Factor posiciones(ordenadas, cardinalidades);
+    for (size_t c = 0; c < casillas; c++) posiciones[c] = static_cast<double>(c);
+    std::vector<double> posicionCasilla = posiciones.valoresEnOrden(consulta.consulta);
+    
+    // Cada bloque vuelve la arena a la marca: sus factores ya no existen
+    // al pasar al siguiente, así que la memoria no crece con numCasos
+    const size_t casosPorBloque = 256;
+    std::vector<std::vector<int>> bloque(columnas.size());
+    std::vector<const int*> punteros(columnas.size());
+    ArenaConsulta& memoria = ArenaConsulta::delHilo();
+    for (size_t inicio = 0; inicio < numCasos; inicio += casosPorBloque) {
+        ArenaConsulta::Marca marca = memoria.marcar();
+        size_t cuantos = std::min(casosPorBloque, numCasos - inicio);
+        size_t casos = (cuantos + FactorLote::ANCHO - 1) / FactorLote::ANCHO * FactorLote::ANCHO;
         
-        std::cout << "\nΣ P(Evidencia, Ocultas) = " << std::fixed 
-                  << std::setprecision(6) << probEvidencia << "\n\n";
-        
-        // Calcular probabilidad condicional
-        double resultado = probConsultaYEvidencia / probEvidencia;
+        RB_FASE(PREPARACION);
+        for (size_t k = 0; k < columnas.size(); k++) {
+            bloque[k].assign(casos, 0);
+            std::copy(columnas[k].begin() + inicio, columnas[k].begin() + inicio + cuantos,
+                      bloque[k].begin());
+            punteros[k] = bloque[k].data();
+        }
+        {
+            VectorArena<FactorLote> factores;
+            factores.reserve(consulta.factores.size());
+            for (const Factor& base : consulta.factores) {
+                factores.emplace_back(base, consulta.evidencia, punteros, casos);
+            }
+            RB_CONTAR_TABLA(factores.size() * casos);
+            
+            RB_FASE(CALCULO);
+            FactorLote final = eliminarEnOrden(std::move(factores), consulta.ordenEliminacion,
+                                               FactorLote(casos));
+            for (size_t c = 0; c < casillas; c++) {
+                const double* columna = final.columna(static_cast<size_t>(posicionCasilla[c]));
+                for (size_t caso = 0; caso < cuantos; caso++) {
+                    resultado[(inicio + caso) * casillas + c] = columna[caso];
+                }
+            }
+        }
+        memoria.restaurar(marca);
+    }
+    RB_CONTAR_ASIGNACIONES(numCasos);
+    
+    return resultado;
+}
+
+/**
+ * Clave canónica: método, consulta y evidencia separados por caracteres
+ * de control que no aparecen en los nombres de la red
+ */
+std::string RedBayesiana::claveConsulta(const std::map<std::string, std::string>& consulta,
+                                        const std::map<std::string, std::string>& evidencia,
+                                        MetodoInferencia metodo) {
+    std::string clave(1, static_cast<char>('0' + static_cast<int>(metodo)));
+    for (const auto& par : consulta) {
+        clave += '\x1f';
+        clave += par.first;
+        clave += '=';
+        clave += par.second;
+    }
+    clave += '\x1e';
+    for (const auto& par : evidencia) {
+        clave += '\x1f';
+        clave += par.first;
+        clave += '=';
+        clave += par.second;
+    }
+    return clave;
+}
+
+/**
+ * Realiza inferencia con el método seleccionado
+ * Primero busca la consulta en la caché; si no está, obtiene la posterior
+ * sobre las variables de consulta y toma la casilla pedida. Sin evidencia,
+ * la enumeración fija también la consulta y suma solo sobre las ocultas
+ */
+double RedBayesiana::inferencia(const std::map<std::string, std::string>& consulta,
+                                const std::map<std::string, std::string>& evidencia,
+                                MetodoInferencia metodo) const {
+    std::string clave = claveConsulta(consulta, evidencia, metodo);
+    double guardado;
+    if (cache.buscar(clave, guardado)) {
+        return guardado;
+    }
+    
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    std::map<int, int> valoresConsulta;
+    std::map<int, int> valoresEvidencia;
+    // Una red inutilizable no tiene probabilidad definida
+    if (!redUtilizable()) return std::numeric_limits<double>::quiet_NaN();
+    if (!resolverAsignacion(consulta, valoresConsulta) ||
+        !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return 0.0;
+    }
+    
+    std::vector<int> variables;
+    size_t casilla = 0;
+    for (const auto& par : valoresConsulta) {
+        variables.push_back(par.first);
+        casilla = casilla * grafo.getCardinalidad(par.first) + par.second;
+    }
+    
+    // Sin evidencia solo se podan nodos estériles, así la suma es P(consulta)
+    double resultado;
+    if (metodo == MetodoInferencia::ENUMERACION && valoresEvidencia.empty()) {
+        SubredRelevante subred = subredDe(variables, valoresEvidencia);
+        resultado = enumeracionPosterior(std::vector<int>(), valoresConsulta, subred, false)[0];
+    } else if (metodo == MetodoInferencia::ENUMERACION_PARALELA && valoresEvidencia.empty()) {
+        SubredRelevante subred = subredDe(variables, valoresEvidencia);
+        resultado = enumeracionParalela(std::vector<int>(), valoresConsulta, subred)[0];
+    } else if (metodo == MetodoInferencia::ENUMERACION_RECURSIVA && valoresEvidencia.empty()) {
+        SubredRelevante subred = subredDe(variables, valoresEvidencia);
+        resultado = enumeracionRecursiva(std::vector<int>(), valoresConsulta, subred)[0];
+    } else {
+        resultado = posterior(variables, valoresEvidencia, metodo)[casilla];
+    }
+    
+    RB_FASE(NORMALIZACION);
+    cache.guardar(clave, resultado);
+    return resultado;
+}
+
+/**
+ * Realiza inferencia por enumeración con traza detallada
+ * Calcula P(consulta | evidencia) en una sola pasada: cada combinación
+ * de ocultas y consulta aporta a P(Evidencia) y, si coincide con la
+ * consulta, también a P(Consulta, Evidencia)
+ */
+double RedBayesiana::inferenciaConTraza(
+    const std::map<std::string, std::string>& consulta,
+    const std::map<std::string, std::string>& evidencia) const {
+    
+    std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
+    std::cout << "║      PROCESO DE INFERENCIA POR ENUMERACIÓN        ║\n";
+    std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+    
+    // Mostrar consulta
+    std::cout << "CONSULTA: P(";
+    bool primero = true;
+    for (const auto& par : consulta) {
+        if (!primero) std::cout << ", ";
+        std::cout << par.first << "=" << par.second;
+        primero = false;
+    }
+    std::cout << ")\n\n";
+    
+    // Mostrar evidencia
+    std::cout << "EVIDENCIA: ";
+    if (evidencia.empty()) {
+        std::cout << "Ninguna";
+    } else {
+        primero = true;
+        for (const auto& par : evidencia) {
+            if (!primero) std::cout << ", ";
+            std::cout << par.first << "=" << par.second;
+            primero = false;
+        }
+    }
+    std::cout << "\n\n";
+    
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    std::map<int, int> valoresConsulta;
+    std::map<int, int> valoresEvidencia;
+    // Una red inutilizable no tiene probabilidad definida
+    if (!redUtilizable()) return std::numeric_limits<double>::quiet_NaN();
+    if (!resolverAsignacion(consulta, valoresConsulta) ||
+        !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return 0.0;
+    }
+    
+    std::vector<int> variables;
+    size_t casilla = 0;
+    for (const auto& par : valoresConsulta) {
+        variables.push_back(par.first);
+        casilla = casilla * grafo.getCardinalidad(par.first) + par.second;
+    }
+    
+    // Solo se recorre la subred relevante
+    SubredRelevante subred = subredDe(variables, valoresEvidencia);
+    if (podaRelevancia) {
+        mostrarPoda(subred);
+    }
+    
+    // Identificar variables ocultas
+    std::cout << "VARIABLES OCULTAS: ";
+    primero = true;
+    for (int v : subred.getVariables()) {
+        if (valoresConsulta.count(v)) continue;
+        if (!primero) std::cout << ", ";
+        std::cout << nodosPorIndice[v]->getNombre();
+        primero = false;
+    }
+    if (primero) std::cout << "Ninguna";
+    std::cout << "\n\n";
+    
+    if (evidencia.empty()) {
+        // Sin evidencia: la consulta queda fija y solo se suman las ocultas
+        std::cout << "─────────────────────────────────────────────────────\n";
+        std::cout << "     Calculando P(Consulta):\n";
+        std::cout << "─────────────────────────────────────────────────────\n\n";
         
-        std::cout << "═════════════════════════════════════════════════════\n";
-        std::cout << "║                    RESULTADO                      ║\n";
-        std::cout << "═════════════════════════════════════════════════════\n\n";
-        std::cout << "P(Consulta | Evidencia) = P(Consulta, Evidencia) / P(Evidencia)\n";
-        std::cout << "                        = " << std::fixed << std::setprecision(6)
-                  << probConsultaYEvidencia << " / " << probEvidencia << "\n";
-        std::cout << "                        = " << std::fixed << std::setprecision(4) 
-                  << resultado << "\n";
-        std::cout << "                        = " << std::fixed << std::setprecision(2)
-                  << (resultado * 100) << "%\n\n";
+        double probConsulta = enumeracionPosterior(std::vector<int>(), valoresConsulta, subred, true)[0];
         
-        return resultado;
-    } else {
-        // Sin evidencia
+        std::cout << "\nΣ P(Consulta, Ocultas) = " << std::fixed 
+                  << std::setprecision(6) << probConsulta << "\n\n";
         std::cout << "═════════════════════════════════════════════════════\n";
         std::cout << "║             RESULTADO (sin evidencia)             ║\n";
         std::cout << "═════════════════════════════════════════════════════\n\n";
         std::cout << "P(Consulta) = " << std::fixed << std::setprecision(6) 
-                  << probConsultaYEvidencia << "\n";
+                  << probConsulta << "\n";
         std::cout << "            = " << std::fixed << std::setprecision(2)
-                  << (probConsultaYEvidencia * 100) << "%\n\n";
+                  << (probConsulta * 100) << "%\n\n";
         
-        return probConsultaYEvidencia;
+        return probConsulta;
     }
-}
\ No newline at end of file
+    
+    std::cout << "─────────────────────────────────────────────────────\n";
+    std::cout << "  Calculando P(Consulta, Evidencia) y P(Evidencia)\n";
+    std::cout << "  en una sola pasada:\n";
+    std::cout << "─────────────────────────────────────────────────────\n\n";
+    
+    std::vector<double> acumulados = enumeracionPosterior(variables, valoresEvidencia, subred, true);
+    RB_FASE(NORMALIZACION);
+    double probConsultaYEvidencia = acumulados[casilla];
+    double probEvidencia = 0.0;
+    for (double p : acumulados) probEvidencia += p;
+    
+    // Calcular probabilidad condicional
+    double resultado = probConsultaYEvidencia / probEvidencia;
+    
+    std::cout << "\nΣ P(Consulta, Evidencia, Ocultas) = " << std::fixed 
+              << std::setprecision(6) << probConsultaYEvidencia << "\n";
+    std::cout << "Σ P(Evidencia, Ocultas)           = " << std::fixed 
+              << std::setprecision(6) << probEvidencia << "\n";
+    if (subred.getFactores().size() + subred.getEsteriles().size() < nodosPorIndice.size()) {
+        std::cout << "(Las sumas omiten el factor constante de la parte d-separada\n";
+        std::cout << " de la red, que se cancela en el cociente)\n";
+    }
+    std::cout << "\n";
+    
+    std::cout << "═════════════════════════════════════════════════════\n";
+    std::cout << "║                    RESULTADO                      ║\n";
+    std::cout << "═════════════════════════════════════════════════════\n\n";
+    std::cout << "P(Consulta | Evidencia) = P(Consulta, Evidencia) / P(Evidencia)\n";
+    std::cout << "                        = " << std::fixed << std::setprecision(6)
+              << probConsultaYEvidencia << " / " << probEvidencia << "\n";
+    std::cout << "                        = " << std::fixed << std::setprecision(4) 
+              << resultado << "\n";
+    std::cout << "                        = " << std::fixed << std::setprecision(2)
+              << (resultado * 100) << "%\n\n";
+    
+    return resultado;
+}
+
+/**
+ * Construye el árbol de cliques a partir de un factor por nodo
+ */
+std::shared_ptr<ArbolCliques> RedBayesiana::construirArbol() const {
+    std::vector<Factor> factores;
+    for (size_t i = 0; i < grafo.getNumeroNodos(); i++) {
+        factores.push_back(factorDeNodo(static_cast<int>(i)));
+    }
+    return std::make_shared<ArbolCliques>(factores, grafo.getCardinalidades());
+}
+
+/**
+ * Compila la red en un árbol de cliques
+ */
+void RedBayesiana::compilar() {
+    if (!redUtilizable()) return;
+    
+    arbolCliques = construirArbol();
+    std::cout << "✓ Árbol de cliques compilado: " << arbolCliques->getNumeroCliques()
+              << " cliques, clique máximo de " << arbolCliques->getTamanoMaximoClique()
+              << " variables\n";
+}
+
+/**
+ * Retorna si existe un árbol compilado
+ */
+bool RedBayesiana::estaCompilada() const {
+    return arbolCliques != nullptr;
+}
+
+/**
+ * Marginales de todos los nodos con una sola propagación
+ */
+std::map<std::string, std::vector<double>> RedBayesiana::marginales(
+    const std::map<std::string, std::string>& evidencia) const {
+    
+    RB_MEDIR_INFERENCIA(estadisticas);
+    ArenaConsulta::Ambito arena;
+    std::map<std::string, std::vector<double>> resultado;
+    std::map<int, int> valoresEvidencia;
+    if (!redUtilizable() || !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return resultado;
+    }
+    
+    RB_FASE(PREPARACION);
+    std::shared_ptr<ArbolCliques> arbol = arbolCliques ? arbolCliques : construirArbol();
+    RB_FASE(CALCULO);
+    std::vector<std::vector<double>> distribuciones = arbol->propagar(valoresEvidencia);
+    RB_FASE(NORMALIZACION);
+    
+    for (size_t i = 0; i < nodosPorIndice.size(); i++) {
+        resultado[nodosPorIndice[i]->getNombre()] = distribuciones[i];
+    }
+    return resultado;
+}
+
+/**
+ * Inferencia aproximada por ponderación de verosimilitud
+ */
+EstimacionAproximada RedBayesiana::inferenciaAproximada(
+    const std::map<std::string, std::string>& consulta,
+    const std::map<std::string, std::string>& evidencia,
+    unsigned long long numMuestras,
+    unsigned long long semilla) const {
+    
+    RB_MEDIR_INFERENCIA(estadisticas);
+    EstimacionAproximada vacia = {0.0, 0.0, 0.0, 0};
+    std::map<int, int> valoresConsulta;
+    std::map<int, int> valoresEvidencia;
+    if (!redUtilizable()) {
+        vacia.probabilidad = std::numeric_limits<double>::quiet_NaN();
+        return vacia;
+    }
+    if (!resolverAsignacion(consulta, valoresConsulta) ||
+        !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return vacia;
+    }
+    
+    // Solo se muestrean los nodos cuya tabla es relevante
+    std::vector<int> variables;
+    for (const auto& par : valoresConsulta) variables.push_back(par.first);
+    SubredRelevante subred = subredDe(variables, valoresEvidencia);
+    std::vector<bool> relevante(nodosPorIndice.size(), false);
+    for (int v : subred.getFactores()) relevante[v] = true;
+    std::vector<int> orden;
+    for (int v : grafo.getOrdenTopologico()) {
+        if (relevante[v]) orden.push_back(v);
+    }
+    
+    PonderacionVerosimilitud motor(grafo, orden);
+    RB_FASE(CALCULO);
+    RB_CONTAR_ASIGNACIONES(numMuestras);
+    RB_CONTAR_TABLA(numMuestras * orden.size());
+    PoolHilos& hilos = pool ? *pool : PoolHilos::compartido();
+    return motor.estimar(valoresConsulta, valoresEvidencia, numMuestras, semilla, hilos);
+}
+
+/**
+ * Inferencia aproximada por muestreo de Gibbs
+ */
+EstimacionGibbs RedBayesiana::inferenciaGibbs(const std::map<std::string, std::string>& consulta,
+                                              const std::map<std::string, std::string>& evidencia,
+                                              const ConfiguracionGibbs& config) const {
+    RB_MEDIR_INFERENCIA(estadisticas);
+    EstimacionGibbs vacia = {0.0, 0.0, 0.0, 0};
+    std::map<int, int> valoresConsulta;
+    std::map<int, int> valoresEvidencia;
+    if (!redUtilizable()) {
+        vacia.probabilidad = std::numeric_limits<double>::quiet_NaN();
+        return vacia;
+    }
+    if (!resolverAsignacion(consulta, valoresConsulta) ||
+        !resolverAsignacion(evidencia, valoresEvidencia)) {
+        return vacia;
+    }
+    
+    // Las tablas fuera de la subred relevante quedan como factores constantes
+    std::vector<int> variables;
+    for (const auto& par : valoresConsulta) variables.push_back(par.first);
+    SubredRelevante subred = subredDe(variables, valoresEvidencia);
+    std::vector<Factor> factores(grafo.getNumeroNodos());
+    for (int v : subred.getFactores()) {
+        factores[v] = factorDeNodo(v);
+    }
+    std::vector<int> orden;
+    for (int v : grafo.getOrdenTopologico()) {
+        if (factores[v].contiene(v)) orden.push_back(v);
+    }
+    
+    MuestreoGibbs muestreador(factores, grafo.getCardinalidades(), orden, valoresEvidencia);
+    RB_FASE(CALCULO);
+    RB_CONTAR_ASIGNACIONES(config.numCadenas * (config.burnIn + config.muestras * config.intervalo));
+    PoolHilos& hilos = pool ? *pool : PoolHilos::compartido();
+    return muestreador.estimar(valoresConsulta, config, hilos);
+}
+
+/**
+ * Activa o desactiva la poda de relevancia
+ */
+void RedBayesiana::setPodaRelevancia(bool activa) {
+    podaRelevancia = activa;
+    cache.limpiar();
+}
+
+/**
+ * Indica si la poda de relevancia está activa
+ */
+bool RedBayesiana::getPodaRelevancia() const {
+    return podaRelevancia;
+}
+
+/**
+ * Cambia la heurística de orden de eliminación
+ * Un orden distinto puede cambiar el redondeo, así que se vacía la caché
+ */
+void RedBayesiana::setHeuristicaOrden(HeuristicaOrden heuristica) {
+    heuristicaOrden = heuristica;
+    cache.limpiar();
+}
+
+/**
+ * Retorna la heurística de orden de eliminación
+ */
+HeuristicaOrden RedBayesiana::getHeuristicaOrden() const {
+    return heuristicaOrden;
+}
+
+/**
+ * Nombres de los nodos que la poda descarta para una consulta
+ */
+bool RedBayesiana::nodosPodados(const std::vector<std::string>& variablesConsulta,
+                                const std::map<std::string, std::string>& evidencia,
+                                std::vector<std::string>& esteriles,
+                                std::vector<std::string>& separados) const {
+    std::map<int, int> valoresEvidencia;
+    if (!resolverAsignacion(evidencia, valoresEvidencia)) {
+        return false;
+    }
+    std::vector<int> variables;
+    for (const auto& nombre : variablesConsulta) {
+        auto it = indicePorNombre.find(nombre);
+        if (it == indicePorNombre.end()) {
+            std::cerr << "Error: Variable " << nombre << " no existe en la red\n";
+            return false;
+        }
+        variables.push_back(it->second);
+    }
+    
+    SubredRelevante subred = subredDe(variables, valoresEvidencia);
+    esteriles.clear();
+    separados.clear();
+    for (int v : subred.getEsteriles()) esteriles.push_back(nodosPorIndice[v]->getNombre());
+    for (int v : subred.getSeparados()) separados.push_back(nodosPorIndice[v]->getNombre());
+    return true;
+}
+
+/**
+ * Cambia el límite de memoria de la caché
+ */
+void RedBayesiana::setCapacidadCache(size_t bytes) {
+    cache.setCapacidad(bytes);
+}
+
+/**
+ * Retorna los contadores de la caché
+ */
+EstadisticasCache RedBayesiana::getEstadisticasCache() const {
+    return cache.getEstadisticas();
+}
+
+/**
+ * Vacía la caché de consultas
+ */
+void RedBayesiana::limpiarCache() {
+    cache.limpiar();
+}
+
+/**
+ * Crea un grupo de hilos propio para los motores paralelos
+ */
+void RedBayesiana::setNumeroHilos(size_t numHilos) {
+    pool = std::make_shared<PoolHilos>(numHilos);
+}
+
+/**
+ * Retorna el número de hilos de la enumeración paralela
+ */
+size_t RedBayesiana::getNumeroHilos() const {
+    return pool ? pool->getNumeroHilos() : PoolHilos::compartido().getNumeroHilos();
+}
+
+/**
+ * Mediciones de la última inferencia
+ */
+EstadisticasInferencia RedBayesiana::getEstadisticasUltimaInferencia() const {
+    return estadisticas.getUltima();
+}
+
+/**
+ * Mediciones acumuladas
+ */
+EstadisticasInferencia RedBayesiana::getEstadisticasInferencia() const {
+    return estadisticas.getAcumulada();
+}
+
+/**
+ * Reinicia las mediciones
+ */
+void RedBayesiana::reiniciarEstadisticasInferencia() {
+    estadisticas.reiniciar();
+}
@@ -2,11 +2,37 @@
 #define RED_BAYESIANA_H
 
 #include "Nodo.h"
+#include "GrafoCompilado.h"
+#include "Factor.h"
+#include "IteradorAsignaciones.h"
+#include "ArbolCliques.h"
+#include "PoolHilos.h"
+#include "PonderacionVerosimilitud.h"
+#include "MuestreoGibbs.h"
+#include "SubredRelevante.h"
+#include "CacheConsultas.h"
+#include "ImagenRed.h"
+#include "LectorTexto.h"
+#include "ImportadorRed.h"
+#include "EstadisticasInferencia.h"
+#include "ConsultaPreparada.h"
+#include "OrdenEliminacion.h"
+#include "ArenaConsulta.h"
 #include <string>
 #include <vector>
 #include <map>
 #include <memory>
 
+/**
+ * Algoritmos de inferencia exacta disponibles
+ */
+enum class MetodoInferencia {
+    ENUMERACION,             // Suma sobre todas las combinaciones de ocultas
+    ELIMINACION_VARIABLES,   // Producto y marginalización de factores
+    ENUMERACION_PARALELA,    // Enumeración repartida entre varios hilos
+    ENUMERACION_RECURSIVA    // Enumeración en orden topológico que comparte prefijos
+};
+
 /**
  * Clase que representa una Red Bayesiana completa
  * Soporta dominios de valores arbitrarios y cualquier estructura de red
@@ -19,6 +45,50 @@ private:
     // Nodos raíz de la red (sin padres)
     std::vector<std::shared_ptr<Nodo>> nodosRaiz;
     
+    // Índice entero de cada nodo (posición en el mapa de nodos)
+    std::vector<std::shared_ptr<Nodo>> nodosPorIndice;
+    std::map<std::string, int> indicePorNombre;
+    
+    // Topología por índices que leen los motores de inferencia
+    GrafoCompilado grafo;
+    
+    // Árbol de cliques compilado (nulo hasta llamar a compilar())
+    std::shared_ptr<ArbolCliques> arbolCliques;
+    
+    // Hilos para los motores paralelos (nulo = grupo compartido)
+    std::shared_ptr<PoolHilos> pool;
+    
+    // Descartar nodos estériles y d-separados antes de inferir
+    bool podaRelevancia;
+    
+    // Criterio para ordenar la eliminación de variables
+    HeuristicaOrden heuristicaOrden;
+    
+    // Resultados recientes de inferencia() (se vacía al recargar la red)
+    mutable CacheConsultas cache;
+    
+    // Contadores y tiempos por fase (solo se llenan con RB_ESTADISTICAS)
+    mutable RegistroInferencia estadisticas;
+    
+    /**
+     * Datos de la enumeración recursiva
+     */
+    struct RecorridoRecursivo {
+        const std::vector<int>& orden;       // Nodos cuya tabla entra, en orden topológico
+        const std::vector<bool>& fijo;       // Evidencia y consulta (no se suman)
+        VectorArena<int>& estado;            // Valor actual de cada nodo
+        unsigned long long lecturas;         // Probabilidades leídas de las tablas
+        unsigned long long hojas;            // Asignaciones completas alcanzadas
+    };
+    
+    /**
+     * Reemplaza la red actual por nodos ya enlazados y con sus tablas
+     * Asigna un índice entero a cada nodo y compila el grafo antes de
+     * instalarlos: si hay ciclos, la red actual queda como estaba
+     * @return false si la estructura tiene ciclos (se informa en cerr)
+     */
+    bool reemplazarNodos(const std::vector<std::shared_ptr<Nodo>>& creados);
+    
     /**
      * Función auxiliar para mostrar estructura recursivamente
      */
@@ -27,20 +97,191 @@ private:
                                      int nivel) const;
     
     /**
-     * Genera todas las combinaciones posibles de valores para variables
-     * @param variables Lista de pares (nombre_variable, nodo)
-     * @return Vector con todas las asignaciones posibles
+     * Calcula la probabilidad conjunta para una asignación completa
+     * @param estado Índice del valor de cada nodo (por índice de nodo)
+     * @param factores Nodos cuya tabla entra en el producto
+     * @return Producto de P(nodo | padres) sobre esos nodos
      */
-    std::vector<std::map<std::string, std::string>> generarCombinaciones(
-        const std::vector<std::pair<std::string, std::shared_ptr<Nodo>>>& variables) const;
+    double calcularProbabilidadConjunta(const VectorArena<int>& estado,
+                                        const std::vector<int>& factores) const;
     
     /**
-     * Calcula la probabilidad conjunta para una asignación completa
-     * @param asignacion Mapa variable->valor para todas las variables
-     * @return Probabilidad conjunta P(asignacion)
+     * Traduce un mapa variable -> valor a índices enteros
+     * @param entrada Mapa nombre de variable -> valor
+     * @param destino Mapa índice de nodo -> índice de valor
+     * @return false si alguna variable o valor no existe (se informa en cerr)
+     */
+    bool resolverAsignacion(const std::map<std::string, std::string>& entrada,
+                            std::map<int, int>& destino) const;
+    
+    /**
+     * Verifica que la red se pueda usar para inferir: sin ciclos (el orden
+     * topológico incluye todos los nodos) y con dominio en todos los nodos
+     * Informa en cerr
+     */
+    bool redUtilizable() const;
+    
+    /**
+     * Subred relevante para una consulta (la red completa si la poda
+     * está desactivada)
+     */
+    SubredRelevante subredDe(const std::vector<int>& variablesConsulta,
+                             const std::map<int, int>& evidencia) const;
+    
+    /**
+     * Clave canónica de una consulta para la caché
+     * Los mapas ya están ordenados por nombre de variable
+     */
+    static std::string claveConsulta(const std::map<std::string, std::string>& consulta,
+                                     const std::map<std::string, std::string>& evidencia,
+                                     MetodoInferencia metodo);
+    
+    /**
+     * Muestra los nodos podados de una subred
+     */
+    void mostrarPoda(const SubredRelevante& subred) const;
+    
+    /**
+     * Enumeración en una sola pasada sobre ocultas y consulta
+     * @param variablesConsulta Índices de las variables de consulta
+     * @param evidencia Índice de nodo -> índice de valor observado
+     * @param subred Variables y tablas que intervienen
+     * @param traza Si es true, muestra cada combinación recorrida
+     * @return P(consulta, evidencia) sin normalizar para cada combinación de
+     *         la consulta (orden por filas) sobre la subred
+     */
+    std::vector<double> enumeracionPosterior(const std::vector<int>& variablesConsulta,
+                                             const std::map<int, int>& evidencia,
+                                             const SubredRelevante& subred,
+                                             bool traza) const;
+    
+    /**
+     * Recorre un plan de enumeración ya preparado
+     * @param estado Estado inicial con la evidencia fijada (se modifica)
+     * @param resultado Recibe las sumas por casilla (se reutiliza su capacidad)
+     */
+    void recorrerEnumeracion(const std::vector<int>& variablesConsulta,
+                             const PlanEnumeracion& plan,
+                             VectorArena<int>& estado,
+                             bool traza,
+                             std::vector<double>& resultado) const;
+    
+    /**
+     * Construye un árbol de cliques con las tablas actuales
+     */
+    std::shared_ptr<ArbolCliques> construirArbol() const;
+    
+    /**
+     * Prepara el estado y el orden de las variables para la enumeración
      */
-    double calcularProbabilidadConjunta(
-        const std::map<std::string, std::string>& asignacion) const;
+    PlanEnumeracion prepararRecorrido(const std::vector<int>& variablesConsulta,
+                                      const std::map<int, int>& evidencia,
+                                      const SubredRelevante& subred) const;
+    
+    /**
+     * Igual que enumeracionPosterior, pero repartiendo bloques de
+     * combinaciones entre los hilos del grupo
+     */
+    std::vector<double> enumeracionParalela(const std::vector<int>& variablesConsulta,
+                                            const std::map<int, int>& evidencia,
+                                            const SubredRelevante& subred) const;
+    
+    /**
+     * Recorre en paralelo un plan de enumeración ya preparado
+     * @param estadoInicial Estado inicial con la evidencia fijada
+     */
+    std::vector<double> recorrerEnumeracionParalela(const std::vector<int>& variablesConsulta,
+                                                    const PlanEnumeracion& plan,
+                                                    const VectorArena<int>& estadoInicial) const;
+    
+    /**
+     * Enumeración recursiva (ENUMERATION-ASK): recorre los nodos en orden
+     * topológico, multiplica la probabilidad de cada uno una sola vez por
+     * prefijo y suma sobre los valores de las ocultas
+     * @return P(consulta, evidencia) sin normalizar para cada combinación de
+     *         la consulta (orden por filas) sobre la subred
+     */
+    std::vector<double> enumeracionRecursiva(const std::vector<int>& variablesConsulta,
+                                             const std::map<int, int>& evidencia,
+                                             const SubredRelevante& subred) const;
+    
+    /**
+     * Suma del producto de las tablas desde un nivel del orden topológico,
+     * con los niveles anteriores ya asignados en el estado
+     */
+    double sumarDesde(RecorridoRecursivo& recorrido, size_t nivel) const;
+    
+    /**
+     * Nodos con tabla de la subred en orden topológico
+     */
+    std::vector<int> ordenRecursivo(const SubredRelevante& subred) const;
+    
+    /**
+     * Enumeración recursiva sobre un orden ya preparado
+     * @param cardinalidadesConsulta Tamaño del dominio de cada variable de consulta
+     * @param fijos Nodos que no se suman (consulta y evidencia)
+     * @param estado Estado con la evidencia fijada (se modifica)
+     * @param resultado Recibe la suma de cada combinación de la consulta
+     */
+    void recorrerRecursivo(const std::vector<int>& variablesConsulta,
+                           const std::vector<int>& cardinalidadesConsulta,
+                           const std::vector<int>& orden,
+                           const std::vector<bool>& fijos,
+                           VectorArena<int>& estado,
+                           std::vector<double>& resultado) const;
+    
+    /**
+     * Distribución posterior normalizada con el método indicado
+     */
+    std::vector<double> posterior(const std::vector<int>& variablesConsulta,
+                                  const std::map<int, int>& evidencia,
+                                  MetodoInferencia metodo) const;
+    
+    /**
+     * Construye el factor P(nodo | padres) a partir de la tabla del nodo
+     * @param indice Índice entero del nodo
+     */
+    Factor factorDeNodo(int indice) const;
+    
+    /**
+     * Realiza inferencia por eliminación de variables
+     * Elimina las variables ocultas una a una en el orden que da la
+     * heurística elegida (por defecto, el factor intermedio más pequeño)
+     * @return Factor normalizado P(consulta | evidencia) sobre las
+     *         variables de consulta
+     */
+    Factor eliminacionVariables(const std::vector<int>& variablesConsulta,
+                                const std::map<int, int>& evidencia,
+                                const SubredRelevante& subred) const;
+    
+    /**
+     * Orden de eliminación de las ocultas de una subred y su costo
+     * Solo depende de qué variables están observadas, no de sus valores:
+     * los alcances son las familias de la subred sin la evidencia
+     * @param variablesConsulta Índices de las variables de consulta
+     * @param evidencia Índices de las variables observadas (los valores no se usan)
+     */
+    OrdenEliminacion ordenarEliminacion(const std::vector<int>& variablesConsulta,
+                                        const std::map<int, int>& evidencia,
+                                        const SubredRelevante& subred,
+                                        HeuristicaOrden heuristica) const;
+    
+    /**
+     * Elimina las variables en el orden dado, multiplica los factores
+     * restantes y normaliza. Sirve para Factor y para FactorLote
+     * @param unidad Factor constante 1 con el que empieza cada producto
+     */
+    template <typename TipoFactor>
+    TipoFactor eliminarEnOrden(VectorArena<TipoFactor> factores, const std::vector<int>& orden,
+                               const TipoFactor& unidad) const;
+    
+    /**
+     * Ejecuta una consulta preparada con valores ya validados
+     * @param resultado Recibe la distribución (se reutiliza su capacidad)
+     */
+    void ejecutarPlan(const ConsultaPreparada& consulta,
+                      const std::vector<int>& valoresEvidencia,
+                      std::vector<double>& resultado) const;
 
 public:
     /**
@@ -49,8 +290,19 @@ public:
     RedBayesiana();
     
     /**
-     * Carga la estructura de la red desde un archivo
+     * Copia la red con nodos propios: cargar tablas o estructura en la copia
+     * no modifica la original (las tablas mapeadas se comparten, son de
+     * solo lectura)
+     */
+    RedBayesiana(const RedBayesiana& otra);
+    
+    RedBayesiana& operator=(const RedBayesiana&) = delete;
+    
+    /**
+     * Carga la estructura de la red desde un archivo (reemplaza la red actual)
      * Formato: cada línea "NodoPadre NodoHijo"
+     * @return false si no se puede leer o si la estructura tiene ciclos; en
+     *         ese caso la red actual no cambia
      */
     bool cargarEstructura(const std::string& nombreArchivo);
     
@@ -60,6 +312,32 @@ public:
      */
     bool cargarProbabilidades(const std::string& nombreArchivo);
     
+    /**
+     * Exporta la red cargada como imagen binaria compilada
+     * (nombres internados, dominios, topología y tablas densas)
+     * @param nombreArchivo Ruta del archivo de salida
+     * @return true si se escribió correctamente
+     */
+    bool exportarImagen(const std::string& nombreArchivo) const;
+    
+    /**
+     * Carga una red desde una imagen binaria mapeada en memoria
+     * Reemplaza la red actual; las tablas se leen directamente de las
+     * páginas mapeadas, sin analizar texto ni copiarlas
+     * @param nombreArchivo Ruta de la imagen
+     * @return true si se cargó correctamente
+     */
+    bool cargarImagen(const std::string& nombreArchivo);
+    
+    /**
+     * Importa una red completa (estructura y tablas) desde un archivo
+     * BIF (.bif) o UAI (.uai), según su extensión
+     * Reemplaza la red actual
+     * @param nombreArchivo Ruta del archivo
+     * @return true si se importó correctamente (false si tiene ciclos)
+     */
+    bool importarRed(const std::string& nombreArchivo);
+    
     /**
      * Muestra la estructura de la red en formato texto
      */
@@ -71,9 +349,10 @@ public:
     void mostrarTodasLasTablas() const;
     
     /**
-     * Obtiene un nodo por su nombre
+     * Obtiene un nodo por su nombre (de solo lectura: la red puede estar
+     * publicada y compartida entre hilos)
      */
-    std::shared_ptr<Nodo> obtenerNodo(const std::string& nombre) const;
+    std::shared_ptr<const Nodo> obtenerNodo(const std::string& nombre) const;
     
     /**
      * Obtiene todos los nombres de nodos
@@ -84,16 +363,244 @@ public:
      * Realiza inferencia por enumeración con traza
      * @param consulta Mapa variable -> valor a consultar
      * @param evidencia Mapa variable -> valor observado
-     * @return Probabilidad calculada P(consulta | evidencia)
+     * @return Probabilidad calculada P(consulta | evidencia); NaN si la red
+     *         contiene ciclos o nodos sin dominio
      */
     double inferenciaConTraza(const std::map<std::string, std::string>& consulta,
-                              const std::map<std::string, std::string>& evidencia);
+                              const std::map<std::string, std::string>& evidencia) const;
     
     /**
      * Realiza inferencia sin mostrar traza detallada
+     * @param metodo Algoritmo a usar (enumeración o eliminación de variables)
+     * @return P(consulta | evidencia); NaN si la red no es utilizable
      */
     double inferencia(const std::map<std::string, std::string>& consulta,
-                     const std::map<std::string, std::string>& evidencia);
+                     const std::map<std::string, std::string>& evidencia,
+                     MetodoInferencia metodo = MetodoInferencia::ENUMERACION) const;
+    
+    /**
+     * Calcula en una sola pasada la distribución posterior completa
+     * P(variablesConsulta | evidencia) sobre el dominio conjunto de la consulta
+     * Ejemplo: {"Train"} con Rain=heavy -> {P(on_time|heavy), P(delayed|heavy)}
+     * @param variablesConsulta Variables cuya distribución se calcula
+     * @param evidencia Mapa variable -> valor observado
+     * @param metodo Algoritmo a usar
+     * @return Probabilidades en orden por filas (la última variable cambia
+     *         más rápido, valores en el orden de cada dominio); vacío si hay error
+     */
+    std::vector<double> distribucionPosterior(const std::vector<std::string>& variablesConsulta,
+                                              const std::map<std::string, std::string>& evidencia,
+                                              MetodoInferencia metodo = MetodoInferencia::ENUMERACION) const;
+    
+    /**
+     * Prepara una forma de consulta para ejecutarla muchas veces con
+     * distintos valores observados: resuelve los nombres, poda la red y
+     * arma el plan del método una sola vez
+     * @param variablesConsulta Variables cuya distribución se calcula
+     * @param variablesEvidencia Variables observadas (sin sus valores)
+     * @param metodo Algoritmo exacto que se usará
+     * @return Consulta preparada; inválida si alguna variable no existe o
+     *         se repite (se informa en cerr)
+     */
+    ConsultaPreparada preparar(const std::vector<std::string>& variablesConsulta,
+                               const std::vector<std::string>& variablesEvidencia,
+                               MetodoInferencia metodo = MetodoInferencia::ELIMINACION_VARIABLES) const;
+    
+    /**
+     * Estima, sin ejecutarla, el costo de una consulta por eliminación de
+     * variables: ancho inducido del orden y memoria del factor intermedio
+     * más grande. Sirve para elegir el motor o rechazar consultas
+     * demasiado caras antes de correrlas
+     * @param variablesConsulta Variables cuya distribución se calcula
+     * @param variablesEvidencia Variables observadas (sin sus valores)
+     * @param heuristica Criterio para ordenar la eliminación
+     * @param costo Recibe el costo estimado
+     * @return false si alguna variable no existe (se informa en cerr)
+     */
+    bool estimarCosto(const std::vector<std::string>& variablesConsulta,
+                      const std::vector<std::string>& variablesEvidencia,
+                      HeuristicaOrden heuristica,
+                      CostoEliminacion& costo) const;
+    
+    /**
+     * Traduce los valores observados a su posición en cada dominio
+     * @param consulta Consulta preparada con esta red
+     * @param valores Un valor por variable de evidencia, en el orden de preparar
+     * @param destino Recibe los índices
+     * @return false si algún valor no pertenece a su dominio
+     */
+    bool indicesEvidencia(const ConsultaPreparada& consulta,
+                          const std::vector<std::string>& valores,
+                          std::vector<int>& destino) const;
+    
+    /**
+     * Ejecuta una consulta preparada (sin pasar por la caché)
+     * @param consulta Consulta preparada con esta red
+     * @param valoresEvidencia Índice del valor observado de cada variable
+     *        de evidencia, en el orden de preparar
+     * @return P(consulta | evidencia) en orden por filas, como
+     *         distribucionPosterior; vacío si hay error
+     */
+    std::vector<double> ejecutar(const ConsultaPreparada& consulta,
+                                 const std::vector<int>& valoresEvidencia) const;
+    
+    /**
+     * Igual que ejecutar, pero escribe la distribución en un vector del
+     * llamador. Reutilizando el mismo vector, una consulta preparada por
+     * eliminación de variables, enumeración o enumeración recursiva no pide
+     * memoria al sistema en régimen estable: los factores y vectores de
+     * trabajo salen de la arena del hilo (ver ArenaConsulta)
+     * @param resultado Recibe P(consulta | evidencia); vacío si hay error
+     * @return false si hay error (se informa en cerr)
+     */
+    bool ejecutar(const ConsultaPreparada& consulta,
+                  const std::vector<int>& valoresEvidencia,
+                  std::vector<double>& resultado) const;
+    
+    /**
+     * Ejecuta una consulta preparada para muchos casos a la vez (por
+     * ejemplo, una fila de evidencia por cliente). Con eliminación de
+     * variables los factores llevan una dimensión más, la de los casos, y
+     * cada producto o suma recorre los casos en bucles vectorizables; con
+     * los demás métodos los casos se ejecutan uno por uno
+     * @param consulta Consulta preparada con esta red
+     * @param columnas Evidencia por columnas: columnas[k][caso] es el índice
+     *        del valor de la k-ésima variable de evidencia
+     * @param numCasos Número de casos (largo de cada columna)
+     * @return numCasos distribuciones seguidas, en la posición
+     *         caso * getNumeroCasillas() + casilla; vacío si hay error
+     */
+    std::vector<double> ejecutarLote(const ConsultaPreparada& consulta,
+                                     const std::vector<std::vector<int>>& columnas,
+                                     size_t numCasos) const;
+    
+    /**
+     * Inferencia aproximada por ponderación de verosimilitud
+     * Permite cambiar precisión por latencia con el número de muestras
+     * @param consulta Mapa variable -> valor a consultar
+     * @param evidencia Mapa variable -> valor observado
+     * @param numMuestras Número total de muestras
+     * @param semilla Semilla de los generadores aleatorios
+     * @return Estimación, error estándar y tamaño efectivo de la muestra
+     */
+    EstimacionAproximada inferenciaAproximada(const std::map<std::string, std::string>& consulta,
+                                              const std::map<std::string, std::string>& evidencia,
+                                              unsigned long long numMuestras = 100000,
+                                              unsigned long long semilla = 42) const;
+    
+    /**
+     * Inferencia aproximada por muestreo de Gibbs (MCMC)
+     * Se mantiene estable con evidencia poco probable, donde la
+     * ponderación por verosimilitud degenera
+     * @param consulta Mapa variable -> valor a consultar
+     * @param evidencia Mapa variable -> valor observado
+     * @param config Cadenas, muestras por cadena, burn-in, intervalo y semilla
+     * @return Estimación, error estándar y R-hat
+     */
+    EstimacionGibbs inferenciaGibbs(const std::map<std::string, std::string>& consulta,
+                                    const std::map<std::string, std::string>& evidencia,
+                                    const ConfiguracionGibbs& config = ConfiguracionGibbs()) const;
+    
+    /**
+     * Activa o desactiva la poda de nodos estériles y d-separados
+     * antes de cada inferencia (activa por defecto)
+     */
+    void setPodaRelevancia(bool activa);
+    
+    /**
+     * Indica si la poda de relevancia está activa
+     */
+    bool getPodaRelevancia() const;
+    
+    /**
+     * Elige la heurística con que la eliminación de variables (y las
+     * consultas que se preparen después) ordenan las ocultas
+     * @param heuristica TAMANO_MINIMO por defecto
+     */
+    void setHeuristicaOrden(HeuristicaOrden heuristica);
+    
+    /**
+     * Heurística de orden de eliminación en uso
+     */
+    HeuristicaOrden getHeuristicaOrden() const;
+    
+    /**
+     * Nodos que la poda descarta para una consulta
+     * @param variablesConsulta Nombres de las variables de consulta
+     * @param evidencia Mapa variable -> valor observado
+     * @param esteriles Recibe los nodos estériles (no son ancestros)
+     * @param separados Recibe los nodos d-separados de la consulta
+     * @return false si alguna variable o valor no existe
+     */
+    bool nodosPodados(const std::vector<std::string>& variablesConsulta,
+                      const std::map<std::string, std::string>& evidencia,
+                      std::vector<std::string>& esteriles,
+                      std::vector<std::string>& separados) const;
+    
+    /**
+     * Define el límite de memoria de la caché de consultas
+     * @param bytes Capacidad en bytes (0 = desactivada; 1 MiB por defecto)
+     */
+    void setCapacidadCache(size_t bytes);
+    
+    /**
+     * Aciertos, fallos, desalojos y ocupación de la caché de consultas
+     */
+    EstadisticasCache getEstadisticasCache() const;
+    
+    /**
+     * Vacía la caché de consultas
+     */
+    void limpiarCache();
+    
+    /**
+     * Contadores y tiempo por fase de la inferencia más reciente
+     * (asignaciones de ocultas, lecturas de tablas, reservas de memoria)
+     * Todo queda en cero si no se compiló con RB_ESTADISTICAS
+     */
+    EstadisticasInferencia getEstadisticasUltimaInferencia() const;
+    
+    /**
+     * Contadores y tiempos acumulados de todas las inferencias medidas
+     */
+    EstadisticasInferencia getEstadisticasInferencia() const;
+    
+    /**
+     * Descarta los contadores y tiempos acumulados
+     */
+    void reiniciarEstadisticasInferencia();
+    
+    /**
+     * Define el número de hilos de los motores paralelos
+     * @param numHilos Número de hilos (0 = núcleos disponibles)
+     */
+    void setNumeroHilos(size_t numHilos);
+    
+    /**
+     * Obtiene el número de hilos de los motores paralelos
+     */
+    size_t getNumeroHilos() const;
+    
+    /**
+     * Compila la red en un árbol de cliques para calcular todas las
+     * marginales con una sola propagación. Debe repetirse si se vuelve
+     * a cargar la estructura o las probabilidades
+     */
+    void compilar();
+    
+    /**
+     * Verifica si la red tiene un árbol de cliques compilado
+     */
+    bool estaCompilada() const;
+    
+    /**
+     * Calcula la marginal posterior de todos los nodos dada la evidencia
+     * Usa el árbol compilado; si no existe, compila uno temporal
+     * @param evidencia Mapa variable -> valor observado
+     * @return Mapa nombre de nodo -> P(nodo | evidencia) en el orden de su dominio
+     */
+    std::map<std::string, std::vector<double>> marginales(
+        const std::map<std::string, std::string>& evidencia) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,390 @@
+#include "ServidorInferencia.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+namespace {
+
+// Una línea más larga que esto cierra la conexión
+const size_t LONGITUD_MAXIMA_LINEA = 1 << 20;
+
+// Segundos que un envío puede esperar a que el cliente lea; pasado ese
+// tiempo se cierra la conexión para no retener al trabajador
+const time_t ESPERA_MAXIMA_ENVIO = 5;
+
+/**
+ * Las consultas ya se reparten entre conexiones: el procesador no
+ * necesita un grupo de hilos propio
+ */
+OpcionesConsulta sinGrupoPropio(OpcionesConsulta opciones) {
+    opciones.numHilos = 1;
+    return opciones;
+}
+
+/**
+ * Envía todo el texto (send puede escribir solo una parte)
+ * @return false si el cliente cerró o no leyó a tiempo (SO_SNDTIMEO)
+ */
+bool enviarTodo(int descriptor, const std::string& texto) {
+    size_t enviado = 0;
+    while (enviado < texto.size()) {
+        ssize_t n = send(descriptor, texto.data() + enviado, texto.size() - enviado, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        enviado += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}
+
+std::atomic<bool> ServidorInferencia::detencionSolicitada(false);
+std::atomic<bool> ServidorInferencia::recargaSolicitada(false);
+
+/**
+ * Constructor
+ */
+ServidorInferencia::ServidorInferencia(ContenedorRed& contenedorRed, const OpcionesConsulta& opciones,
+                                       size_t trabajadores)
+    : contenedor(contenedorRed), procesador(contenedorRed, sinGrupoPropio(opciones)),
+      numTrabajadores(trabajadores), descriptor(-1), cerrando(false), inicio(Reloj::now()),
+      consultas(0), errores(0), conexiones(0) {
+    if (numTrabajadores == 0) {
+        numTrabajadores = std::max(1u, std::thread::hardware_concurrency());
+    }
+    aviso[0] = aviso[1] = -1;
+    for (auto& cubeta : histograma) cubeta.store(0);
+    for (size_t s = 0; s < VENTANA_SEGUNDOS; s++) {
+        segundoVentana[s].store(-1);
+        conteoVentana[s].store(0);
+    }
+}
+
+/**
+ * Destructor: detiene los trabajadores y libera el socket
+ */
+ServidorInferencia::~ServidorInferencia() {
+    {
+        std::lock_guard<std::mutex> bloqueo(mutexConexiones);
+        cerrando = true;
+    }
+    hayConexion.notify_all();
+    for (auto& hilo : trabajadores) hilo.join();
+
+    for (const auto& conexion : listas) close(conexion->descriptor);
+    for (const auto& conexion : devueltas) close(conexion->descriptor);
+    if (aviso[0] >= 0) close(aviso[0]);
+    if (aviso[1] >= 0) close(aviso[1]);
+    if (descriptor >= 0) {
+        close(descriptor);
+        unlink(ruta.c_str());
+    }
+}
+
+/**
+ * Crea el socket, la tubería de aviso y los trabajadores
+ */
+bool ServidorInferencia::escuchar(const std::string& rutaSocket) {
+    sockaddr_un direccion;
+    std::memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    if (rutaSocket.size() >= sizeof(direccion.sun_path)) {
+        std::cerr << "Error: Ruta de socket demasiado larga: " << rutaSocket << "\n";
+        return false;
+    }
+    std::memcpy(direccion.sun_path, rutaSocket.c_str(), rutaSocket.size() + 1);
+
+    descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor < 0) {
+        std::cerr << "Error: No se pudo crear el socket: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    unlink(rutaSocket.c_str());
+    if (bind(descriptor, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0 ||
+        listen(descriptor, 128) != 0) {
+        std::cerr << "Error: No se pudo escuchar en " << rutaSocket << ": " << std::strerror(errno) << "\n";
+        close(descriptor);
+        descriptor = -1;
+        return false;
+    }
+    ruta = rutaSocket;
+
+    if (pipe2(aviso, O_CLOEXEC | O_NONBLOCK) != 0) {
+        std::cerr << "Error: No se pudo crear la tubería de aviso: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    for (size_t t = 0; t < numTrabajadores; t++) {
+        trabajadores.emplace_back(&ServidorInferencia::bucleTrabajador, this);
+    }
+    return true;
+}
+
+/**
+ * Ciclo principal: acepta clientes y entrega a los trabajadores las
+ * conexiones que tienen datos; las atendidas vuelven por la tubería
+ */
+void ServidorInferencia::ejecutar() {
+    std::vector<std::unique_ptr<Conexion>> enEspera;
+    std::vector<pollfd> vigilados;
+
+    while (!detencionSolicitada.load()) {
+        if (recargaSolicitada.exchange(false)) iniciarRecarga();
+
+        vigilados.clear();
+        vigilados.push_back({descriptor, POLLIN, 0});
+        vigilados.push_back({aviso[0], POLLIN, 0});
+        for (const auto& conexion : enEspera) {
+            vigilados.push_back({conexion->descriptor, POLLIN, 0});
+        }
+
+        // Tiempo límite para revisar periódicamente si se pidió detener
+        int listos = poll(vigilados.data(), vigilados.size(), 250);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: poll: " << std::strerror(errno) << "\n";
+            break;
+        }
+
+        // Conexiones con datos (o cerradas por el cliente) pasan a los trabajadores
+        std::vector<std::unique_ptr<Conexion>> siguen;
+        {
+            std::lock_guard<std::mutex> bloqueo(mutexConexiones);
+            for (size_t k = 0; k < enEspera.size(); k++) {
+                if (vigilados[k + 2].revents != 0) {
+                    listas.push_back(std::move(enEspera[k]));
+                } else {
+                    siguen.push_back(std::move(enEspera[k]));
+                }
+            }
+        }
+        if (siguen.size() != enEspera.size()) hayConexion.notify_all();
+        enEspera.swap(siguen);
+
+        if (vigilados[1].revents & POLLIN) {
+            char descarte[256];
+            while (read(aviso[0], descarte, sizeof(descarte)) > 0) {}
+            std::lock_guard<std::mutex> bloqueo(mutexConexiones);
+            for (auto& conexion : devueltas) enEspera.push_back(std::move(conexion));
+            devueltas.clear();
+        }
+
+        if (vigilados[0].revents & POLLIN) {
+            int cliente = accept4(descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+            if (cliente >= 0) {
+                // Un cliente que no lee sus respuestas no bloquea para siempre a un trabajador
+                timeval espera = {ESPERA_MAXIMA_ENVIO, 0};
+                setsockopt(cliente, SOL_SOCKET, SO_SNDTIMEO, &espera, sizeof(espera));
+                conexiones++;
+                std::unique_ptr<Conexion> conexion(new Conexion());
+                conexion->descriptor = cliente;
+                conexion->numeroLinea = 0;
+                enEspera.push_back(std::move(conexion));
+            }
+        }
+    }
+
+    for (const auto& conexion : enEspera) close(conexion->descriptor);
+}
+
+/**
+ * Constructor de las recargas
+ */
+void ServidorInferencia::setConstructorRecarga(ContenedorRed::Constructor construir) {
+    constructorRecarga = construir;
+}
+
+/**
+ * Solo modifica un atómico sin bloqueo: es seguro en un manejador de señales
+ */
+void ServidorInferencia::solicitarDetencion() {
+    detencionSolicitada.store(true);
+}
+
+/**
+ * Igual que solicitarDetencion(); poll() despierta con EINTR y atiende el pedido
+ */
+void ServidorInferencia::solicitarRecarga() {
+    recargaSolicitada.store(true);
+}
+
+/**
+ * El resultado se informa en cerr cuando la recarga termina
+ */
+std::string ServidorInferencia::iniciarRecarga() {
+    if (!constructorRecarga) {
+        return "{\"recarga\":\"no disponible\"}";
+    }
+    bool iniciada = contenedor.recargarEnSegundoPlano(constructorRecarga, [](bool publicada) {
+        if (publicada) {
+            std::cerr << "✓ Red recargada\n";
+        } else {
+            std::cerr << "❌ Error al recargar la red; se mantiene la versión anterior\n";
+        }
+    });
+    return iniciada ? "{\"recarga\":\"iniciada\"}" : "{\"recarga\":\"en curso\"}";
+}
+
+/**
+ * Atiende conexiones listas; las que siguen abiertas vuelven a poll()
+ */
+void ServidorInferencia::bucleTrabajador() {
+    while (true) {
+        std::unique_ptr<Conexion> conexion;
+        {
+            std::unique_lock<std::mutex> bloqueo(mutexConexiones);
+            hayConexion.wait(bloqueo, [this] { return cerrando || !listas.empty(); });
+            if (cerrando) return;
+            conexion = std::move(listas.front());
+            listas.pop_front();
+        }
+
+        if (!atender(*conexion)) {
+            close(conexion->descriptor);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> bloqueo(mutexConexiones);
+            devueltas.push_back(std::move(conexion));
+        }
+        char despertar = 1;
+        ssize_t escrito = write(aviso[1], &despertar, 1);
+        (void)escrito;   // Si la tubería está llena, poll() ya tiene un aviso pendiente
+    }
+}
+
+/**
+ * Una sola lectura (poll() indicó que hay datos, así que no bloquea);
+ * todas las respuestas de lo leído se envían juntas
+ */
+bool ServidorInferencia::atender(Conexion& conexion) {
+    char bufer[65536];
+    ssize_t leidos = recv(conexion.descriptor, bufer, sizeof(bufer), 0);
+    if (leidos < 0 && (errno == EINTR || errno == EAGAIN)) return true;
+    if (leidos <= 0) return false;
+    conexion.pendiente.append(bufer, static_cast<size_t>(leidos));
+
+    std::string respuestas;
+    size_t inicioLinea = 0;
+    size_t salto;
+    while ((salto = conexion.pendiente.find('\n', inicioLinea)) != std::string::npos) {
+        std::string_view linea(conexion.pendiente.data() + inicioLinea, salto - inicioLinea);
+        inicioLinea = salto + 1;
+        conexion.numeroLinea++;
+
+        std::string_view orden = LectorTexto::recortar(linea);
+        if (orden == "METRICAS" || orden == "RECARGAR") {
+            respuestas += orden == "METRICAS" ? metricasJson() : iniciarRecarga();
+            respuestas += '\n';
+            continue;
+        }
+
+        Reloj::time_point antes = Reloj::now();
+        std::string respuesta = procesador.responder(linea, conexion.numeroLinea);
+        if (respuesta.empty()) continue;
+        registrar(std::chrono::duration<double, std::micro>(Reloj::now() - antes).count(),
+                  respuesta.find(",\"error\":") != std::string::npos);
+        respuestas += respuesta;
+        respuestas += '\n';
+    }
+    conexion.pendiente.erase(0, inicioLinea);
+
+    if (!respuestas.empty() && !enviarTodo(conexion.descriptor, respuestas)) return false;
+    if (conexion.pendiente.size() > LONGITUD_MAXIMA_LINEA) {
+        enviarTodo(conexion.descriptor, "{\"error\":\"Línea demasiado larga\"}\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Cubeta logarítmica del histograma y contador del segundo actual
+ */
+void ServidorInferencia::registrar(double micros, bool error) {
+    consultas++;
+    if (error) errores++;
+
+    size_t cubeta = 0;
+    if (micros >= 1.0) {
+        cubeta = static_cast<size_t>(std::floor(std::log2(micros))) + 1;
+        if (cubeta >= NUM_CUBETAS) cubeta = NUM_CUBETAS - 1;
+    }
+    histograma[cubeta]++;
+
+    long long segundo = std::chrono::duration_cast<std::chrono::seconds>(Reloj::now() - inicio).count();
+    size_t casilla = static_cast<size_t>(segundo % VENTANA_SEGUNDOS);
+    long long visto = segundoVentana[casilla].load();
+    if (visto != segundo && segundoVentana[casilla].compare_exchange_strong(visto, segundo)) {
+        conteoVentana[casilla].store(0);
+    }
+    conteoVentana[casilla]++;
+}
+
+/**
+ * Los percentiles se estiman con el límite superior de su cubeta
+ */
+std::string ServidorInferencia::metricasJson() const {
+    double activo = std::chrono::duration<double>(Reloj::now() - inicio).count();
+    long long segundo = static_cast<long long>(activo);
+    unsigned long long total = consultas.load();
+
+    // Consultas por segundo en los últimos segundos completos
+    unsigned long long recientes = 0;
+    long long segundosCompletos = std::min<long long>(segundo, VENTANA_SEGUNDOS - 1);
+    for (size_t s = 0; s < VENTANA_SEGUNDOS; s++) {
+        long long marca = segundoVentana[s].load();
+        if (marca >= segundo - segundosCompletos && marca < segundo) recientes += conteoVentana[s].load();
+    }
+
+    std::array<unsigned long long, NUM_CUBETAS> cuentas;
+    unsigned long long enHistograma = 0;
+    for (size_t k = 0; k < NUM_CUBETAS; k++) {
+        cuentas[k] = histograma[k].load();
+        enHistograma += cuentas[k];
+    }
+    auto percentil = [&](double p) {
+        unsigned long long objetivo = static_cast<unsigned long long>(std::ceil(p / 100.0 * enHistograma));
+        unsigned long long acumulado = 0;
+        for (size_t k = 0; k < NUM_CUBETAS; k++) {
+            acumulado += cuentas[k];
+            if (acumulado >= objetivo && acumulado > 0) return static_cast<double>(1ULL << k);
+        }
+        return 0.0;
+    };
+
+    char numero[64];
+    std::string texto = "{\"consultas\":" + std::to_string(total) +
+                        ",\"errores\":" + std::to_string(errores.load()) +
+                        ",\"conexiones\":" + std::to_string(conexiones.load()) +
+                        ",\"version_red\":" + std::to_string(contenedor.getVersion());
+    std::snprintf(numero, sizeof(numero), ",\"segundos_activo\":%.3f", activo);
+    texto += numero;
+    std::snprintf(numero, sizeof(numero), ",\"qps\":%.1f", activo > 0 ? total / activo : 0.0);
+    texto += numero;
+    std::snprintf(numero, sizeof(numero), ",\"qps_reciente\":%.1f",
+                  segundosCompletos > 0 ? static_cast<double>(recientes) / segundosCompletos
+                                        : (activo > 0 ? total / activo : 0.0));
+    texto += numero;
+    std::snprintf(numero, sizeof(numero), ",\"latencia_us\":{\"p50\":%.0f,\"p90\":%.0f,\"p99\":%.0f}",
+                  percentil(50), percentil(90), percentil(99));
+    texto += numero;
+
+    // Límite superior de cada cubeta (en microsegundos) -> consultas
+    texto += ",\"histograma_us\":{";
+    bool primera = true;
+    for (size_t k = 0; k < NUM_CUBETAS; k++) {
+        if (cuentas[k] == 0) continue;
+        if (!primera) texto += ",";
+        texto += "\"" + std::to_string(1ULL << k) + "\":" + std::to_string(cuentas[k]);
+        primera = false;
+    }
+    texto += "}}";
+    return texto;
+}
@@ -0,0 +1,156 @@
+#ifndef SERVIDOR_INFERENCIA_H
+#define SERVIDOR_INFERENCIA_H
+
+#include "ProcesadorConsultas.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * Servidor de inferencia sobre un socket Unix
+ *
+ * Carga la red una sola vez y atiende clientes concurrentes. El hilo que
+ * llama a ejecutar() espera con poll() a que alguna conexión tenga datos y
+ * la entrega a un grupo fijo de hilos trabajadores, que responden las
+ * líneas completas recibidas y la devuelven a la espera. Así un cliente
+ * inactivo no ocupa un trabajador. Un cliente que no lee sus respuestas
+ * tampoco: si un envío espera más de unos segundos, se cierra su conexión.
+ *
+ * El protocolo es por líneas: cada línea es una consulta con el formato de
+ * ProcesadorConsultas y recibe una línea JSON de respuesta, en el mismo
+ * orden (las líneas vacías y los comentarios no se responden). Un cliente
+ * puede enviar varias consultas seguidas sin esperar las respuestas. La
+ * línea "METRICAS" responde con las consultas atendidas, las consultas por
+ * segundo (total y de los últimos segundos) y un histograma de latencias.
+ *
+ * Cada consulta usa la versión de la red publicada al comenzar. La línea
+ * "RECARGAR" o la señal SIGHUP construyen una versión nueva en segundo
+ * plano y la publican sin detener las consultas en curso.
+ */
+class ServidorInferencia {
+private:
+    typedef std::chrono::steady_clock Reloj;
+
+    // Cubeta k del histograma: latencias en [2^(k-1), 2^k) microsegundos
+    static const size_t NUM_CUBETAS = 32;
+    // Segundos recientes para calcular las consultas por segundo actuales
+    static const size_t VENTANA_SEGUNDOS = 10;
+
+    static std::atomic<bool> detencionSolicitada;
+    static std::atomic<bool> recargaSolicitada;
+
+    /**
+     * Un cliente conectado y lo que envió sin completar una línea
+     */
+    struct Conexion {
+        int descriptor;
+        std::string pendiente;
+        unsigned long long numeroLinea;
+    };
+
+    ContenedorRed& contenedor;
+    ContenedorRed::Constructor constructorRecarga;
+    ProcesadorConsultas procesador;
+    size_t numTrabajadores;
+    int descriptor;
+    int aviso[2];           // Tubería con la que los trabajadores despiertan a poll()
+    std::string ruta;
+
+    // Conexiones con datos esperando trabajador y atendidas que vuelven a poll()
+    std::mutex mutexConexiones;
+    std::condition_variable hayConexion;
+    std::deque<std::unique_ptr<Conexion>> listas;
+    std::vector<std::unique_ptr<Conexion>> devueltas;
+    bool cerrando;
+    std::vector<std::thread> trabajadores;
+
+    // Métricas
+    Reloj::time_point inicio;
+    std::atomic<unsigned long long> consultas;
+    std::atomic<unsigned long long> errores;
+    std::atomic<unsigned long long> conexiones;
+    std::array<std::atomic<unsigned long long>, NUM_CUBETAS> histograma;
+    std::array<std::atomic<long long>, VENTANA_SEGUNDOS> segundoVentana;
+    std::array<std::atomic<unsigned long long>, VENTANA_SEGUNDOS> conteoVentana;
+
+    /**
+     * Toma conexiones listas hasta que el servidor se cierra
+     */
+    void bucleTrabajador();
+
+    /**
+     * Lee lo disponible de una conexión y responde las líneas completas
+     * @return false si el cliente cerró la conexión o hubo un error
+     */
+    bool atender(Conexion& conexion);
+
+    /**
+     * Comienza una recarga en segundo plano
+     * @return Respuesta JSON con el estado de la recarga
+     */
+    std::string iniciarRecarga();
+
+    /**
+     * Suma una consulta al histograma y a la ventana de consultas por segundo
+     */
+    void registrar(double micros, bool error);
+
+public:
+    /**
+     * Constructor
+     * @param contenedor Versiones de la red que se consultan
+     * @param opciones Motor, muestras y semilla de las consultas
+     * @param numTrabajadores Hilos que responden consultas (0 = núcleos disponibles)
+     */
+    ServidorInferencia(ContenedorRed& contenedor, const OpcionesConsulta& opciones,
+                       size_t numTrabajadores);
+
+    /**
+     * Destructor: cierra el socket y espera a los trabajadores
+     */
+    ~ServidorInferencia();
+
+    ServidorInferencia(const ServidorInferencia&) = delete;
+    ServidorInferencia& operator=(const ServidorInferencia&) = delete;
+
+    /**
+     * Crea el socket y comienza a escuchar (reemplaza un socket viejo
+     * en la misma ruta)
+     * @return false si no se pudo (se informa en cerr)
+     */
+    bool escuchar(const std::string& rutaSocket);
+
+    /**
+     * Acepta conexiones hasta que se llame a solicitarDetencion()
+     */
+    void ejecutar();
+
+    /**
+     * Define cómo construir la red en cada recarga (sin él, no se recarga)
+     */
+    void setConstructorRecarga(ContenedorRed::Constructor construir);
+
+    /**
+     * Pide que ejecutar() termine; se puede llamar desde un manejador de señales
+     */
+    static void solicitarDetencion();
+
+    /**
+     * Pide una recarga de la red; se puede llamar desde un manejador de señales
+     */
+    static void solicitarRecarga();
+
+    /**
+     * Métricas actuales como una línea JSON
+     */
+    std::string metricasJson() const;
+};
+
+#endif
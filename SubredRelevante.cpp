@@ -0,0 +1,120 @@
+#include "SubredRelevante.h"
+
+/**
+ * Constructor
+ * 1. Ancestros de la consulta y la evidencia (recorrido hacia los padres)
+ * 2. Grafo moral de los ancestros sin los nodos de evidencia
+ * 3. Componente conexa de las variables de consulta
+ */
+SubredRelevante::SubredRelevante(const GrafoCompilado& grafo,
+                                 const std::vector<int>& consulta,
+                                 const std::map<int, int>& evidencia,
+                                 bool podar) {
+    size_t n = grafo.getNumeroNodos();
+    std::vector<bool> observado(n, false);
+    for (const auto& obs : evidencia) observado[obs.first] = true;
+
+    if (!podar) {
+        for (size_t i = 0; i < n; i++) {
+            if (!observado[i]) variables.push_back(static_cast<int>(i));
+            factores.push_back(static_cast<int>(i));
+        }
+        return;
+    }
+
+    // Conjunto ancestral
+    std::vector<bool> ancestro(n, false);
+    std::vector<int> pendientes(consulta);
+    for (const auto& obs : evidencia) pendientes.push_back(obs.first);
+    while (!pendientes.empty()) {
+        int v = pendientes.back();
+        pendientes.pop_back();
+        if (ancestro[v]) continue;
+        ancestro[v] = true;
+        for (int p : grafo.getPadres(static_cast<int>(v))) {
+            if (!ancestro[p]) pendientes.push_back(p);
+        }
+    }
+
+    // Grafo moral de los ancestros: cada nodo con sus padres y los padres entre sí
+    std::vector<std::vector<int>> vecinos(n);
+    for (size_t v = 0; v < n; v++) {
+        if (!ancestro[v]) continue;
+        GrafoCompilado::Rango padres = grafo.getPadres(static_cast<int>(v));
+        for (size_t a = 0; a < padres.size(); a++) {
+            vecinos[v].push_back(padres[a]);
+            vecinos[padres[a]].push_back(static_cast<int>(v));
+            for (size_t b = a + 1; b < padres.size(); b++) {
+                vecinos[padres[a]].push_back(padres[b]);
+                vecinos[padres[b]].push_back(padres[a]);
+            }
+        }
+    }
+
+    // Componente de la consulta sin atravesar la evidencia
+    std::vector<bool> conectado(n, false);
+    for (int q : consulta) {
+        if (!observado[q]) pendientes.push_back(q);
+    }
+    while (!pendientes.empty()) {
+        int v = pendientes.back();
+        pendientes.pop_back();
+        if (conectado[v]) continue;
+        conectado[v] = true;
+        for (int u : vecinos[v]) {
+            if (!conectado[u] && !observado[u]) pendientes.push_back(u);
+        }
+    }
+
+    for (size_t v = 0; v < n; v++) {
+        int i = static_cast<int>(v);
+        if (conectado[v]) {
+            variables.push_back(i);
+            factores.push_back(i);
+            continue;
+        }
+        if (observado[v]) {
+            // La tabla de la evidencia importa si algún padre está conectado
+            for (int p : grafo.getPadres(static_cast<int>(v))) {
+                if (conectado[p]) {
+                    factores.push_back(i);
+                    break;
+                }
+            }
+            continue;
+        }
+        if (ancestro[v]) {
+            separados.push_back(i);
+        } else {
+            esteriles.push_back(i);
+        }
+    }
+}
+
+/**
+ * Retorna los nodos sin evidencia de la subred
+ */
+const std::vector<int>& SubredRelevante::getVariables() const {
+    return variables;
+}
+
+/**
+ * Retorna los nodos cuya tabla se conserva
+ */
+const std::vector<int>& SubredRelevante::getFactores() const {
+    return factores;
+}
+
+/**
+ * Retorna los nodos estériles
+ */
+const std::vector<int>& SubredRelevante::getEsteriles() const {
+    return esteriles;
+}
+
+/**
+ * Retorna los nodos d-separados
+ */
+const std::vector<int>& SubredRelevante::getSeparados() const {
+    return separados;
+}
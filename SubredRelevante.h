@@ -0,0 +1,64 @@
+#ifndef SUBRED_RELEVANTE_H
+#define SUBRED_RELEVANTE_H
+
+#include "GrafoCompilado.h"
+#include <vector>
+#include <map>
+#include <cstddef>
+
+/**
+ * Parte de la red que influye en una consulta dada la evidencia
+ *
+ * 1. Nodos estériles: los que no son ancestros de la consulta ni de la
+ *    evidencia. Su tabla suma 1 al marginalizarlos, así que se descartan.
+ * 2. Nodos d-separados: en el grafo moral de los ancestros, sin los nodos
+ *    de evidencia, los que no quedan conectados con la consulta. Sus tablas
+ *    solo aportan una constante que se cancela al normalizar.
+ *
+ * Se conservan las tablas de los nodos conectados con la consulta y las de
+ * los nodos de evidencia con algún padre conectado. La posterior sobre la
+ * subred es la misma que sobre la red completa; sin evidencia solo se
+ * descartan nodos estériles y las sumas sin normalizar también coinciden.
+ */
+class SubredRelevante {
+private:
+    std::vector<int> variables;     // Nodos sin evidencia conectados con la consulta
+    std::vector<int> factores;      // Nodos cuya tabla se conserva
+    std::vector<int> esteriles;     // Podados por no ser ancestros
+    std::vector<int> separados;     // Podados por estar d-separados de la consulta
+
+public:
+    /**
+     * Constructor: calcula la subred
+     * @param grafo Topología de la red por índices
+     * @param consulta Índices de las variables de consulta
+     * @param evidencia Índice de nodo -> índice de valor observado
+     * @param podar Si es false la subred es la red completa
+     */
+    SubredRelevante(const GrafoCompilado& grafo,
+                    const std::vector<int>& consulta,
+                    const std::map<int, int>& evidencia,
+                    bool podar = true);
+
+    /**
+     * Nodos sin evidencia de la subred (consulta y ocultas), ordenados
+     */
+    const std::vector<int>& getVariables() const;
+
+    /**
+     * Nodos cuya tabla participa en la inferencia, ordenados
+     */
+    const std::vector<int>& getFactores() const;
+
+    /**
+     * Nodos podados por estériles, ordenados
+     */
+    const std::vector<int>& getEsteriles() const;
+
+    /**
+     * Nodos podados por d-separación, ordenados
+     */
+    const std::vector<int>& getSeparados() const;
+};
+
+#endif
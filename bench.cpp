@@ -0,0 +1,684 @@
+#include "RedBayesiana.h"
+#include "GeneradorRed.h"
+#include "NucleosFactor.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <atomic>
+#include <new>
+#include <sys/stat.h>
+
+/**
+ * Pruebas de rendimiento sobre redes sintéticas
+ *
+ * Genera una red aleatoria (estructura.txt + probabilidades.txt), mide la
+ * carga y cada motor de inferencia sobre un conjunto fijo de consultas, y
+ * escribe una línea JSON por prueba en la salida estándar:
+ *   {"prueba":"inferencia","metodo":"eliminacion","consultas":100,
+ *    "p50_us":..., "p90_us":..., "p99_us":..., "max_us":...,
+ *    "media_us":..., "consultas_por_s":..., "suma":...}
+ * "suma" acumula los resultados, para detectar cambios de exactitud.
+ *
+ * Uso: ./bench_red_bayesiana [--nodos N] [--grado K] [--ventana W]
+ *        [--dominio D] [--evidencia R] [--consultas Q] [--semilla S]
+ *        [--muestras M] [--hilos H] [--casos C] [--directorio DIR] [--metodos lista]
+ *      ./bench_red_bayesiana --ayuda | --help | -h
+ * Métodos: enumeracion, paralela, recursiva, eliminacion, preparada, lote,
+ *          cliques, ponderacion, gibbs, cache, orden, arena, nucleos (por defecto todos los exactos solo en redes pequeñas)
+ */
+
+namespace {
+
+using Reloj = std::chrono::steady_clock;
+
+double segundosDesde(Reloj::time_point inicio) {
+    return std::chrono::duration<double>(Reloj::now() - inicio).count();
+}
+
+/**
+ * Arma una línea JSON con campos en el orden en que se agregan
+ */
+class LineaJson {
+private:
+    std::string texto;
+
+    void nombre(const char* clave) {
+        texto += texto.empty() ? "{" : ",";
+        texto += "\"";
+        texto += clave;
+        texto += "\":";
+    }
+
+public:
+    LineaJson& campo(const char* clave, const std::string& valor) {
+        nombre(clave);
+        texto += "\"" + valor + "\"";
+        return *this;
+    }
+
+    LineaJson& campo(const char* clave, double valor) {
+        char numero[32];
+        std::snprintf(numero, sizeof(numero), "%.6g", valor);
+        nombre(clave);
+        texto += numero;
+        return *this;
+    }
+
+    LineaJson& campo(const char* clave, size_t valor) {
+        nombre(clave);
+        texto += std::to_string(valor);
+        return *this;
+    }
+
+    std::string terminar() const {
+        return texto + "}";
+    }
+};
+
+/**
+ * Percentil por rango más cercano sobre latencias ordenadas
+ */
+double percentil(const std::vector<double>& ordenadas, double p) {
+    if (ordenadas.empty()) return 0.0;
+    size_t rango = static_cast<size_t>(p / 100.0 * ordenadas.size() + 0.999999);
+    rango = std::min(std::max<size_t>(rango, 1), ordenadas.size());
+    return ordenadas[rango - 1];
+}
+
+/**
+ * Agrega a la línea los percentiles, la media y el rendimiento
+ */
+void agregarLatencias(LineaJson& linea, std::vector<double> micros, double totalSegundos) {
+    std::sort(micros.begin(), micros.end());
+    double suma = 0.0;
+    for (double m : micros) suma += m;
+    linea.campo("consultas", micros.size())
+         .campo("p50_us", percentil(micros, 50))
+         .campo("p90_us", percentil(micros, 90))
+         .campo("p99_us", percentil(micros, 99))
+         .campo("max_us", micros.empty() ? 0.0 : micros.back())
+         .campo("media_us", micros.empty() ? 0.0 : suma / micros.size())
+         .campo("consultas_por_s", totalSegundos > 0 ? micros.size() / totalSegundos : 0.0);
+}
+
+/**
+ * Tamaño de un archivo en bytes (0 si no existe)
+ */
+size_t tamanoArchivo(const std::string& archivo) {
+    struct stat info;
+    return stat(archivo.c_str(), &info) == 0 ? static_cast<size_t>(info.st_size) : 0;
+}
+
+/**
+ * Opciones del programa y sus valores por defecto
+ */
+void mostrarUso() {
+    std::cerr << "Uso: bench_red_bayesiana [--nodos N] [--grado K] [--ventana W]\n";
+    std::cerr << "         [--dominio D] [--evidencia R] [--consultas Q] [--semilla S]\n";
+    std::cerr << "         [--muestras M] [--hilos H] [--casos C] [--directorio DIR] [--metodos lista]\n";
+    std::cerr << "     bench_red_bayesiana --ayuda | --help | -h\n\n";
+    std::cerr << "  --nodos       número de nodos (por defecto: 50)\n";
+    std::cerr << "  --grado       máximo de padres por nodo (por defecto: 3)\n";
+    std::cerr << "  --ventana     los padres se eligen entre los W nodos anteriores (0 = todos; por defecto: 8)\n";
+    std::cerr << "  --dominio     máximo de valores por nodo, mínimo 2 (por defecto: 3)\n";
+    std::cerr << "  --evidencia   fracción de nodos observados por consulta (por defecto: 0.1)\n";
+    std::cerr << "  --consultas   consultas por motor (por defecto: 100)\n";
+    std::cerr << "  --semilla     semilla de la red y las consultas (por defecto: 42)\n";
+    std::cerr << "  --muestras    muestras de los métodos aproximados (por defecto: 20000)\n";
+    std::cerr << "  --hilos       hilos del grupo (0 = automático)\n";
+    std::cerr << "  --casos       filas de evidencia de la prueba lote (por defecto: 1024)\n";
+    std::cerr << "  --directorio  dónde se escribe la red generada (por defecto: bench_datos)\n";
+    std::cerr << "  --metodos     lista separada por comas: enumeracion, paralela, recursiva, eliminacion,\n";
+    std::cerr << "                preparada, lote, cliques, ponderacion, gibbs, cache, orden, arena, nucleos\n";
+    std::cerr << "                (por defecto, los exactos por enumeración solo con 12 nodos o menos)\n";
+}
+
+// Llamadas a malloc hechas por operator new en todo el programa
+std::atomic<unsigned long long> reservasMalloc(0);
+
+}
+
+/**
+ * operator new global que cuenta las reservas (la prueba "arena" verifica
+ * que una consulta preparada no pida memoria al sistema)
+ */
+void* operator new(size_t bytes) {
+    reservasMalloc.fetch_add(1, std::memory_order_relaxed);
+    void* puntero = std::malloc(bytes == 0 ? 1 : bytes);
+    if (puntero == nullptr) throw std::bad_alloc();
+    return puntero;
+}
+
+void operator delete(void* puntero) noexcept {
+    std::free(puntero);
+}
+
+void operator delete(void* puntero, size_t) noexcept {
+    std::free(puntero);
+}
+
+int main(int argc, char* argv[]) {
+    ConfiguracionGenerador config;
+    double proporcionEvidencia = 0.1;
+    size_t numConsultas = 100;
+    unsigned long long muestras = 20000;
+    size_t numHilos = 0;
+    size_t numCasos = 1024;
+    std::string directorio = "bench_datos";
+    std::string metodos;
+
+    for (int i = 1; i < argc; i++) {
+        std::string opcion = argv[i];
+        // La ayuda es la única opción sin valor
+        if (opcion == "--ayuda" || opcion == "--help" || opcion == "-h") {
+            mostrarUso();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de " << opcion << "\n";
+            return 1;
+        }
+        std::string valor = argv[++i];
+        if (opcion == "--nodos") config.numNodos = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--grado") config.gradoMaximo = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--ventana") config.ventana = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--dominio") config.dominioMaximo = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--evidencia") proporcionEvidencia = std::strtod(valor.c_str(), nullptr);
+        else if (opcion == "--consultas") numConsultas = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--semilla") config.semilla = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--muestras") muestras = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--hilos") numHilos = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--casos") numCasos = std::strtoull(valor.c_str(), nullptr, 10);
+        else if (opcion == "--directorio") directorio = valor;
+        else if (opcion == "--metodos") metodos = valor;
+        else {
+            std::cerr << "Error: Opción desconocida " << opcion << "\n\n";
+            mostrarUso();
+            return 1;
+        }
+    }
+    if (config.numNodos < 2) {
+        std::cerr << "Error: Se necesitan al menos 2 nodos\n";
+        return 1;
+    }
+    if (metodos.empty()) {
+        metodos = config.numNodos <= 12 ? "enumeracion,paralela,recursiva,eliminacion,preparada,lote,cliques,ponderacion,gibbs,cache,orden,arena,nucleos"
+                                        : "eliminacion,preparada,lote,cliques,ponderacion,gibbs,cache,orden,arena,nucleos";
+    }
+    auto incluye = [&](const std::string& metodo) {
+        return ("," + metodos + ",").find("," + metodo + ",") != std::string::npos;
+    };
+
+    // Los resultados van a la salida original; los mensajes de la biblioteca se descartan
+    std::ostream salida(std::cout.rdbuf());
+    std::streambuf* original = std::cout.rdbuf(nullptr);
+
+    if (mkdir(directorio.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::cerr << "Error: No se puede crear " << directorio << "\n";
+        return 1;
+    }
+    std::string archivoEstructura = directorio + "/estructura.txt";
+    std::string archivoProbabilidades = directorio + "/probabilidades.txt";
+    std::string archivoImagen = directorio + "/red.rbi";
+
+    // Generación
+    Reloj::time_point inicio = Reloj::now();
+    GeneradorRed generador(config);
+    if (!generador.escribir(archivoEstructura, archivoProbabilidades)) return 1;
+    std::vector<ConsultaGenerada> consultas =
+        generador.generarConsultas(numConsultas, proporcionEvidencia, config.semilla + 1);
+    salida << LineaJson().campo("prueba", std::string("generacion"))
+                         .campo("nodos", config.numNodos)
+                         .campo("arcos", generador.getNumeroArcos())
+                         .campo("probabilidades", generador.getNumeroProbabilidades())
+                         .campo("grado", config.gradoMaximo)
+                         .campo("ventana", config.ventana)
+                         .campo("dominio", config.dominioMaximo)
+                         .campo("evidencia", proporcionEvidencia)
+                         .campo("semilla", static_cast<size_t>(config.semilla))
+                         .campo("segundos", segundosDesde(inicio)).terminar() << std::endl;
+
+    // Carga de texto
+    RedBayesiana red;
+    if (numHilos > 0) red.setNumeroHilos(numHilos);
+    inicio = Reloj::now();
+    if (!red.cargarEstructura(archivoEstructura) || !red.cargarProbabilidades(archivoProbabilidades)) {
+        std::cerr << "Error: No se pudo cargar la red generada\n";
+        return 1;
+    }
+    double segundos = segundosDesde(inicio);
+    size_t bytes = tamanoArchivo(archivoEstructura) + tamanoArchivo(archivoProbabilidades);
+    salida << LineaJson().campo("prueba", std::string("carga"))
+                         .campo("formato", std::string("texto"))
+                         .campo("bytes", bytes)
+                         .campo("segundos", segundos)
+                         .campo("mb_por_s", segundos > 0 ? bytes / segundos / 1e6 : 0.0).terminar() << std::endl;
+
+    // Imagen binaria
+    inicio = Reloj::now();
+    red.exportarImagen(archivoImagen);
+    double segundosExportar = segundosDesde(inicio);
+    RedBayesiana desdeImagen;
+    inicio = Reloj::now();
+    desdeImagen.cargarImagen(archivoImagen);
+    salida << LineaJson().campo("prueba", std::string("carga"))
+                         .campo("formato", std::string("imagen"))
+                         .campo("bytes", tamanoArchivo(archivoImagen))
+                         .campo("segundos", segundosDesde(inicio))
+                         .campo("segundos_exportar", segundosExportar).terminar() << std::endl;
+
+    salida << LineaJson().campo("prueba", std::string("sistema"))
+                         .campo("hilos", red.getNumeroHilos()).terminar() << std::endl;
+
+    // Motores exactos y aproximados sin caché
+    red.setCapacidadCache(0);
+    struct Motor {
+        const char* nombre;
+        std::function<double(const ConsultaGenerada&)> ejecutar;
+    };
+    ConfiguracionGibbs configGibbs;
+    configGibbs.muestras = std::max<unsigned long long>(muestras / configGibbs.numCadenas, 1);
+    configGibbs.burnIn = std::max<unsigned long long>(configGibbs.muestras / 10, 1);
+    std::vector<Motor> motores = {
+        {"enumeracion", [&](const ConsultaGenerada& c) {
+            return red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ENUMERACION); }},
+        {"paralela", [&](const ConsultaGenerada& c) {
+            return red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ENUMERACION_PARALELA); }},
+        {"recursiva", [&](const ConsultaGenerada& c) {
+            return red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ENUMERACION_RECURSIVA); }},
+        {"eliminacion", [&](const ConsultaGenerada& c) {
+            return red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ELIMINACION_VARIABLES); }},
+        {"ponderacion", [&](const ConsultaGenerada& c) {
+            return red.inferenciaAproximada(c.consulta, c.evidencia, muestras).probabilidad; }},
+        {"gibbs", [&](const ConsultaGenerada& c) {
+            return red.inferenciaGibbs(c.consulta, c.evidencia, configGibbs).probabilidad; }},
+    };
+
+    for (const auto& motor : motores) {
+        if (!incluye(motor.nombre)) continue;
+        std::vector<double> micros;
+        double suma = 0.0;
+        Reloj::time_point inicioTotal = Reloj::now();
+        for (const auto& c : consultas) {
+            Reloj::time_point inicioConsulta = Reloj::now();
+            suma += motor.ejecutar(c);
+            micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+        }
+        LineaJson linea;
+        linea.campo("prueba", std::string("inferencia")).campo("metodo", std::string(motor.nombre));
+        agregarLatencias(linea, micros, segundosDesde(inicioTotal));
+        salida << linea.campo("suma", suma).terminar() << std::endl;
+    }
+
+    // Consultas preparadas: la preparación se mide aparte y cada consulta
+    // solo paga la ejecución con sus valores observados
+    if (incluye("preparada")) {
+        std::vector<ConsultaPreparada> preparadas;
+        std::vector<std::vector<int>> valores(consultas.size());
+        std::vector<size_t> casillas;
+        inicio = Reloj::now();
+        for (size_t k = 0; k < consultas.size(); k++) {
+            const ConsultaGenerada& c = consultas[k];
+            std::vector<std::string> variablesConsulta, variablesEvidencia, valoresEvidencia;
+            size_t casilla = 0;
+            for (const auto& par : c.consulta) {
+                variablesConsulta.push_back(par.first);
+                std::shared_ptr<const Nodo> nodo = red.obtenerNodo(par.first);
+                casilla = casilla * nodo->getCardinalidad() + nodo->indiceValor(par.second);
+            }
+            for (const auto& par : c.evidencia) {
+                variablesEvidencia.push_back(par.first);
+                valoresEvidencia.push_back(par.second);
+            }
+            preparadas.push_back(red.preparar(variablesConsulta, variablesEvidencia));
+            red.indicesEvidencia(preparadas.back(), valoresEvidencia, valores[k]);
+            casillas.push_back(casilla);
+        }
+        double segundosPreparar = segundosDesde(inicio);
+
+        std::vector<double> micros;
+        double suma = 0.0;
+        Reloj::time_point inicioTotal = Reloj::now();
+        for (size_t k = 0; k < consultas.size(); k++) {
+            Reloj::time_point inicioConsulta = Reloj::now();
+            std::vector<double> distribucion = red.ejecutar(preparadas[k], valores[k]);
+            micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+            if (casillas[k] < distribucion.size()) suma += distribucion[casillas[k]];
+        }
+        LineaJson linea;
+        linea.campo("prueba", std::string("inferencia")).campo("metodo", std::string("preparada"));
+        agregarLatencias(linea, micros, segundosDesde(inicioTotal));
+        salida << linea.campo("suma", suma)
+                       .campo("segundos_preparar", segundosPreparar).terminar() << std::endl;
+    }
+
+    // Lote: una forma de consulta con valores observados aleatorios para
+    // muchos casos, con inferencia, ejecución preparada caso por caso y lote
+    if (incluye("lote") && !consultas.empty()) {
+        const ConsultaGenerada* forma = &consultas.front();
+        for (const auto& c : consultas) {
+            if (!c.evidencia.empty()) {
+                forma = &c;
+                break;
+            }
+        }
+        std::vector<std::string> variablesConsulta, variablesEvidencia;
+        for (const auto& par : forma->consulta) variablesConsulta.push_back(par.first);
+        for (const auto& par : forma->evidencia) variablesEvidencia.push_back(par.first);
+        ConsultaPreparada preparada = red.preparar(variablesConsulta, variablesEvidencia);
+
+        std::mt19937 aleatorio(static_cast<unsigned>(config.semilla + 2));
+        std::vector<std::vector<int>> columnas;
+        for (const auto& nombre : variablesEvidencia) {
+            int cardinalidad = static_cast<int>(red.obtenerNodo(nombre)->getCardinalidad());
+            std::uniform_int_distribution<int> valor(0, cardinalidad - 1);
+            std::vector<int> columna(numCasos);
+            for (int& v : columna) v = valor(aleatorio);
+            columnas.push_back(columna);
+        }
+
+        inicio = Reloj::now();
+        for (size_t caso = 0; caso < numCasos; caso++) {
+            std::map<std::string, std::string> evidencia;
+            for (size_t k = 0; k < variablesEvidencia.size(); k++) {
+                evidencia[variablesEvidencia[k]] =
+                    red.obtenerNodo(variablesEvidencia[k])->getDominio()[columnas[k][caso]];
+            }
+            red.inferencia(forma->consulta, evidencia, MetodoInferencia::ELIMINACION_VARIABLES);
+        }
+        double segundosInferencia = segundosDesde(inicio);
+
+        double sumaIndividual = 0.0;
+        std::vector<int> valores(variablesEvidencia.size());
+        inicio = Reloj::now();
+        for (size_t caso = 0; caso < numCasos; caso++) {
+            for (size_t k = 0; k < valores.size(); k++) valores[k] = columnas[k][caso];
+            sumaIndividual += red.ejecutar(preparada, valores)[0];
+        }
+        double segundosIndividual = segundosDesde(inicio);
+
+        inicio = Reloj::now();
+        std::vector<double> lote = red.ejecutarLote(preparada, columnas, numCasos);
+        double segundosLote = segundosDesde(inicio);
+        double sumaLote = 0.0;
+        for (size_t caso = 0; caso < numCasos; caso++) {
+            sumaLote += lote[caso * preparada.getNumeroCasillas()];
+        }
+
+        double casos = numCasos > 0 ? static_cast<double>(numCasos) : 1.0;
+        salida << LineaJson().campo("prueba", std::string("lote"))
+                             .campo("casos", numCasos)
+                             .campo("variables_evidencia", variablesEvidencia.size())
+                             .campo("inferencia_us_por_caso", segundosInferencia / casos * 1e6)
+                             .campo("preparada_us_por_caso", segundosIndividual / casos * 1e6)
+                             .campo("lote_us_por_caso", segundosLote / casos * 1e6)
+                             .campo("suma_preparada", sumaIndividual)
+                             .campo("suma_lote", sumaLote).terminar() << std::endl;
+    }
+
+    // Árbol de cliques: compilación y todas las marginales por consulta
+    if (incluye("cliques")) {
+        inicio = Reloj::now();
+        red.compilar();
+        salida << LineaJson().campo("prueba", std::string("compilacion"))
+                             .campo("segundos", segundosDesde(inicio)).terminar() << std::endl;
+
+        std::vector<double> micros;
+        double suma = 0.0;
+        Reloj::time_point inicioTotal = Reloj::now();
+        for (const auto& c : consultas) {
+            Reloj::time_point inicioConsulta = Reloj::now();
+            auto marginales = red.marginales(c.evidencia);
+            micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+            const auto& par = *c.consulta.begin();
+            auto it = marginales.find(par.first);
+            if (it != marginales.end()) {
+                auto dominio = red.obtenerNodo(par.first)->getDominio();
+                size_t v = std::find(dominio.begin(), dominio.end(), par.second) - dominio.begin();
+                if (v < it->second.size()) suma += it->second[v];
+            }
+        }
+        LineaJson linea;
+        linea.campo("prueba", std::string("inferencia")).campo("metodo", std::string("cliques"));
+        agregarLatencias(linea, micros, segundosDesde(inicioTotal));
+        salida << linea.campo("suma", suma).terminar() << std::endl;
+    }
+
+    // Caché: una pasada para llenarla y otra medida, solo con aciertos
+    if (incluye("cache")) {
+        red.setCapacidadCache(64 << 20);
+        for (const auto& c : consultas) {
+            red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ELIMINACION_VARIABLES);
+        }
+        std::vector<double> micros;
+        double suma = 0.0;
+        Reloj::time_point inicioTotal = Reloj::now();
+        for (const auto& c : consultas) {
+            Reloj::time_point inicioConsulta = Reloj::now();
+            suma += red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ELIMINACION_VARIABLES);
+            micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+        }
+        LineaJson linea;
+        linea.campo("prueba", std::string("inferencia")).campo("metodo", std::string("cache"));
+        agregarLatencias(linea, micros, segundosDesde(inicioTotal));
+        salida << linea.campo("suma", suma)
+                       .campo("aciertos", static_cast<size_t>(red.getEstadisticasCache().aciertos)).terminar() << std::endl;
+    }
+
+    // Heurísticas de orden de eliminación: costo estimado (ancho inducido y
+    // factor más grande) y latencia de la eliminación de variables con cada una
+    if (incluye("orden")) {
+        struct Heuristica {
+            const char* nombre;
+            HeuristicaOrden heuristica;
+        };
+        std::vector<Heuristica> heuristicas = {
+            {"tamano_minimo", HeuristicaOrden::TAMANO_MINIMO},
+            {"grado_minimo", HeuristicaOrden::GRADO_MINIMO},
+            {"relleno_minimo", HeuristicaOrden::RELLENO_MINIMO},
+            {"relleno_ponderado", HeuristicaOrden::RELLENO_PONDERADO},
+        };
+        for (const auto& h : heuristicas) {
+            size_t anchoMaximo = 0;
+            double anchoMedio = 0.0, bytesMaximos = 0.0;
+            inicio = Reloj::now();
+            for (const auto& c : consultas) {
+                std::vector<std::string> variablesConsulta, variablesEvidencia;
+                for (const auto& par : c.consulta) variablesConsulta.push_back(par.first);
+                for (const auto& par : c.evidencia) variablesEvidencia.push_back(par.first);
+                CostoEliminacion costo;
+                red.estimarCosto(variablesConsulta, variablesEvidencia, h.heuristica, costo);
+                anchoMaximo = std::max(anchoMaximo, costo.anchoInducido);
+                anchoMedio += costo.anchoInducido;
+                bytesMaximos = std::max(bytesMaximos, costo.bytesMaximos);
+            }
+            double segundosEstimar = segundosDesde(inicio);
+
+            red.setHeuristicaOrden(h.heuristica);
+            std::vector<double> micros;
+            double suma = 0.0;
+            Reloj::time_point inicioTotal = Reloj::now();
+            for (const auto& c : consultas) {
+                Reloj::time_point inicioConsulta = Reloj::now();
+                suma += red.inferencia(c.consulta, c.evidencia, MetodoInferencia::ELIMINACION_VARIABLES);
+                micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+            }
+            LineaJson linea;
+            linea.campo("prueba", std::string("orden")).campo("heuristica", std::string(h.nombre));
+            agregarLatencias(linea, micros, segundosDesde(inicioTotal));
+            salida << linea.campo("suma", suma)
+                           .campo("ancho_maximo", anchoMaximo)
+                           .campo("ancho_medio", consultas.empty() ? 0.0 : anchoMedio / consultas.size())
+                           .campo("bytes_maximos", bytesMaximos)
+                           .campo("us_estimar", consultas.empty() ? 0.0 : segundosEstimar * 1e6 / consultas.size())
+                           .terminar() << std::endl;
+        }
+        red.setHeuristicaOrden(HeuristicaOrden::TAMANO_MINIMO);
+    }
+
+    // Arena por consulta: consultas preparadas ejecutadas sobre un vector de
+    // resultado reutilizado. Tras una pasada de calentamiento, que deja la
+    // arena con la capacidad necesaria, la pasada medida no debería llamar
+    // a malloc (la enumeración solo en redes pequeñas)
+    if (incluye("arena")) {
+        struct Metodo {
+            const char* nombre;
+            MetodoInferencia metodo;
+        };
+        std::vector<Metodo> metodosArena = {{"eliminacion", MetodoInferencia::ELIMINACION_VARIABLES}};
+        if (config.numNodos <= 12) {
+            metodosArena.push_back({"enumeracion", MetodoInferencia::ENUMERACION});
+            metodosArena.push_back({"recursiva", MetodoInferencia::ENUMERACION_RECURSIVA});
+        }
+        for (const auto& m : metodosArena) {
+            std::vector<ConsultaPreparada> preparadas;
+            std::vector<std::vector<int>> valores(consultas.size());
+            std::vector<size_t> casillas;
+            for (size_t k = 0; k < consultas.size(); k++) {
+                const ConsultaGenerada& c = consultas[k];
+                std::vector<std::string> variablesConsulta, variablesEvidencia, valoresEvidencia;
+                size_t casilla = 0;
+                for (const auto& par : c.consulta) {
+                    variablesConsulta.push_back(par.first);
+                    std::shared_ptr<const Nodo> nodo = red.obtenerNodo(par.first);
+                    casilla = casilla * nodo->getCardinalidad() + nodo->indiceValor(par.second);
+                }
+                for (const auto& par : c.evidencia) {
+                    variablesEvidencia.push_back(par.first);
+                    valoresEvidencia.push_back(par.second);
+                }
+                preparadas.push_back(red.preparar(variablesConsulta, variablesEvidencia, m.metodo));
+                red.indicesEvidencia(preparadas.back(), valoresEvidencia, valores[k]);
+                casillas.push_back(casilla);
+            }
+
+            std::vector<double> distribucion;
+            for (size_t k = 0; k < preparadas.size(); k++) {
+                red.ejecutar(preparadas[k], valores[k], distribucion);
+            }
+
+            ArenaConsulta& arena = ArenaConsulta::delHilo();
+            arena.reiniciarEstadisticas();
+            std::vector<double> micros;
+            micros.reserve(preparadas.size());
+            double suma = 0.0;
+            unsigned long long reservasAntes = reservasMalloc.load();
+            Reloj::time_point inicioTotal = Reloj::now();
+            for (size_t k = 0; k < preparadas.size(); k++) {
+                Reloj::time_point inicioConsulta = Reloj::now();
+                red.ejecutar(preparadas[k], valores[k], distribucion);
+                micros.push_back(segundosDesde(inicioConsulta) * 1e6);
+                if (casillas[k] < distribucion.size()) suma += distribucion[casillas[k]];
+            }
+            double segundosTotal = segundosDesde(inicioTotal);
+            unsigned long long reservas = reservasMalloc.load() - reservasAntes;
+            EstadisticasArena estadisticasArena = arena.getEstadisticas();
+
+            LineaJson linea;
+            linea.campo("prueba", std::string("arena")).campo("metodo", std::string(m.nombre));
+            agregarLatencias(linea, micros, segundosTotal);
+            double porConsulta = preparadas.empty() ? 0.0 : 1.0 / preparadas.size();
+            salida << linea.campo("suma", suma)
+                           .campo("malloc_por_consulta", reservas * porConsulta)
+                           .campo("reservas_arena_por_consulta", estadisticasArena.reservas * porConsulta)
+                           .campo("reservas_sistema", static_cast<size_t>(estadisticasArena.reservasSistema))
+                           .campo("bytes_maximos", estadisticasArena.bytesMaximos)
+                           .campo("capacidad", estadisticasArena.capacidad)
+                           .terminar() << std::endl;
+        }
+    }
+
+    // Núcleos de factores: cada operación con la implementación escalar y
+    // con AVX2 (si la CPU la soporta); "suma" debe coincidir entre ambas
+    if (incluye("nucleos")) {
+        std::vector<const NucleosFactor::Tabla*> tablas(1, &NucleosFactor::escalares());
+        if (NucleosFactor::avx2()) tablas.push_back(NucleosFactor::avx2());
+
+        const size_t elementos = 1 << 14;
+        const size_t repeticiones = 2000;
+        std::mt19937 aleatorio(static_cast<unsigned>(config.semilla + 3));
+        std::uniform_real_distribution<double> uniforme(0.5, 1.0);
+        std::vector<double> a(elementos), b(elementos);
+        for (size_t i = 0; i < elementos; i++) {
+            a[i] = uniforme(aleatorio);
+            b[i] = uniforme(aleatorio);
+        }
+
+        // Factores con alcances distintos: el producto combina tramos
+        // contiguos y repetidos, y las sumas recorren pasos grandes y pequeños
+        std::vector<int> varsA, varsB, cardsA, cardsB;
+        for (int v = 0; v < 8; v++) { varsA.push_back(v); cardsA.push_back(4); }
+        for (int v = 4; v < 10; v++) { varsB.push_back(v); cardsB.push_back(4); }
+        Factor factorA(varsA, cardsA), factorB(varsB, cardsB);
+        for (size_t i = 0; i < factorA.tamano(); i++) factorA[i] = uniforme(aleatorio);
+        for (size_t i = 0; i < factorB.tamano(); i++) factorB[i] = uniforme(aleatorio);
+
+        struct Operacion {
+            const char* nombre;
+            size_t elementos;
+            size_t repeticiones;
+            std::function<double()> ejecutar;
+        };
+        for (const NucleosFactor::Tabla* tabla : tablas) {
+            NucleosFactor::seleccionar(tabla != &NucleosFactor::escalares());
+            std::vector<double> destino(elementos);
+            Factor producto = factorA.producto(factorB);
+            std::vector<Operacion> operaciones = {
+                {"multiplicar", elementos, repeticiones, [&]() {
+                    tabla->multiplicar(destino.data(), a.data(), b.data(), elementos);
+                    return destino[elementos - 1]; }},
+                {"multiplicar_escalar", elementos, repeticiones, [&]() {
+                    tabla->multiplicarEscalar(destino.data(), a.data(), b[0], elementos);
+                    return destino[elementos - 1]; }},
+                {"acumular", elementos, repeticiones, [&]() {
+                    destino.assign(elementos, 0.0);
+                    tabla->acumular(destino.data(), a.data(), elementos);
+                    return destino[elementos - 1]; }},
+                {"sumar", elementos, repeticiones, [&]() {
+                    return tabla->sumar(a.data(), elementos); }},
+                {"dividir", elementos, repeticiones, [&]() {
+                    destino = a;
+                    tabla->dividir(destino.data(), b[0], elementos);
+                    return destino[elementos - 1]; }},
+                {"factor_producto", producto.tamano(), 20, [&]() {
+                    Factor f = factorA.producto(factorB);
+                    return f[f.tamano() - 1]; }},
+                {"factor_sumar_ultima", producto.tamano(), 20, [&]() {
+                    Factor f = producto.sumarVariable(9);
+                    return f[f.tamano() - 1]; }},
+                {"factor_sumar_primera", producto.tamano(), 20, [&]() {
+                    Factor f = producto.sumarVariable(0);
+                    return f[f.tamano() - 1]; }},
+                {"factor_normalizar", producto.tamano(), 20, [&]() {
+                    Factor f(producto);
+                    f.normalizar();
+                    return f[f.tamano() - 1]; }},
+            };
+            for (const auto& operacion : operaciones) {
+                double suma = 0.0;
+                inicio = Reloj::now();
+                for (size_t r = 0; r < operacion.repeticiones; r++) {
+                    suma += operacion.ejecutar();
+                }
+                double segundosOperacion = segundosDesde(inicio);
+                salida << LineaJson().campo("prueba", std::string("nucleo"))
+                                     .campo("operacion", std::string(operacion.nombre))
+                                     .campo("implementacion", std::string(tabla->nombre))
+                                     .campo("elementos", operacion.elementos)
+                                     .campo("ns_por_elemento", segundosOperacion * 1e9 /
+                                            (operacion.repeticiones * operacion.elementos))
+                                     .campo("suma", suma).terminar() << std::endl;
+            }
+        }
+        NucleosFactor::seleccionar(true);
+    }
+
+    std::cout.rdbuf(original);
+    return 0;
+}
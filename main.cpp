@@ -1,8 +1,14 @@
 #include "RedBayesiana.h"
+#include "ProcesadorConsultas.h"
+#include "ServidorInferencia.h"
+#include "ContenedorRed.h"
 #include <iostream>
 #include <map>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
+#include <cstdlib>
+#include <csignal>
 
 /**
  * Programa principal para Red Bayesiana Genérica
@@ -35,11 +41,14 @@ void mostrarMenu() {
     std::cout << "5. Inferencia rápida (sin traza detallada)\n";
     std::cout << "6. Cargar otra red (cambiar archivos)\n";
     std::cout << "7. Ayuda\n";
-    std::cout << "8. Salir\n";
+    std::cout << "8. Marginales de todos los nodos (árbol de cliques)\n";
+    std::cout << "9. Exportar imagen binaria compilada\n";
+    std::cout << "10. Estadísticas de inferencia\n";
+    std::cout << "11. Salir\n";
     std::cout << "\nSeleccione una opción: ";
 }
 
-void mostrarInformacionVariables(RedBayesiana& red) {
+void mostrarInformacionVariables(const RedBayesiana& red) {
     std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
     std::cout << "║        INFORMACIÓN DE VARIABLES DE LA RED         ║\n";
     std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
@@ -56,7 +65,7 @@ void mostrarInformacionVariables(RedBayesiana& red) {
             
             // Mostrar dominio
             std::cout << "Dominio: {";
-            auto dominio = nodo->getDominio();
+            const auto& dominio = nodo->getDominio();
             for (size_t i = 0; i < dominio.size(); i++) {
                 std::cout << dominio[i];
                 if (i < dominio.size() - 1) std::cout << ", ";
@@ -64,7 +73,7 @@ void mostrarInformacionVariables(RedBayesiana& red) {
             std::cout << "}\n";
             
             // Mostrar padres
-            auto padres = nodo->getPadres();
+            const auto& padres = nodo->getPadres();
             std::cout << "Padres: ";
             if (padres.empty()) {
                 std::cout << "Ninguno (es raíz)";
@@ -118,11 +127,42 @@ void mostrarAyuda() {
     
     std::cout << "5. INFERENCIA RÁPIDA:\n";
     std::cout << "   Igual que la opción 3, pero sin mostrar todos\n";
-    std::cout << "   los pasos intermedios. Más rápido para redes grandes.\n\n";
+    std::cout << "   los pasos intermedios. Más rápido para redes grandes.\n";
+    std::cout << "   Permite elegir eliminación de variables, cuyo costo\n";
+    std::cout << "   depende del ancho de árbol de la red y no de su tamaño,\n";
+    std::cout << "   o enumeración paralela, que reparte las combinaciones\n";
+    std::cout << "   entre todos los núcleos disponibles.\n";
+    std::cout << "   La enumeración recursiva recorre los nodos en orden\n";
+    std::cout << "   topológico y calcula una sola vez los productos que\n";
+    std::cout << "   comparten las combinaciones (mucho menos multiplicaciones).\n";
+    std::cout << "   La ponderación por verosimilitud da una estimación\n";
+    std::cout << "   aproximada con su error estándar; más muestras = más precisión.\n";
+    std::cout << "   El muestreo de Gibbs corre varias cadenas en paralelo y\n";
+    std::cout << "   reporta R-hat (cercano a 1 indica convergencia); conviene\n";
+    std::cout << "   cuando la evidencia es poco probable.\n";
+    std::cout << "   Antes de inferir se descartan los nodos estériles y los\n";
+    std::cout << "   d-separados de la consulta, que no cambian el resultado.\n\n";
     
     std::cout << "6. CARGAR OTRA RED:\n";
     std::cout << "   Te permite cambiar a otra red bayesiana sin\n";
-    std::cout << "   reiniciar el programa.\n\n";
+    std::cout << "   reiniciar el programa. Como archivo de estructura\n";
+    std::cout << "   también se acepta una red completa en formato\n";
+    std::cout << "   BIF (.bif), UAI (.uai) o una imagen compilada (.rbi).\n\n";
+    
+    std::cout << "8. MARGINALES DE TODOS LOS NODOS:\n";
+    std::cout << "   Compila la red en un árbol de cliques y muestra\n";
+    std::cout << "   P(nodo | evidencia) de cada nodo con una sola propagación.\n\n";
+    
+    std::cout << "9. EXPORTAR IMAGEN BINARIA:\n";
+    std::cout << "   Guarda la red compilada en un archivo .rbi. Al indicar ese\n";
+    std::cout << "   archivo como estructura (opción 6 o al iniciar), la red se\n";
+    std::cout << "   carga al instante sin leer los archivos de texto.\n\n";
+    
+    std::cout << "10. ESTADÍSTICAS DE INFERENCIA:\n";
+    std::cout << "   Muestra cuántas combinaciones de ocultas se recorrieron,\n";
+    std::cout << "   cuántas lecturas de tablas y reservas de memoria hubo y\n";
+    std::cout << "   el tiempo de cada fase, para la última consulta y en total.\n";
+    std::cout << "   Requiere compilar con: make clean && make ESTADISTICAS=1\n\n";
     
     std::cout << "FORMATO DE INFERENCIA:\n";
     std::cout << "- Consulta: La(s) variable(s) cuya probabilidad quieres calcular\n";
@@ -136,7 +176,78 @@ void mostrarAyuda() {
     std::cout << "• La evidencia es opcional (puedes no poner ninguna)\n\n";
 }
 
-void inferenciaPersonalizada(RedBayesiana& red, bool conTraza = true) {
+/**
+ * Pide al usuario las variables observadas y sus valores
+ * @param consulta Variables de consulta (no pueden ser evidencia)
+ * @return false si el número de variables es inválido
+ */
+bool leerEvidencia(const RedBayesiana& red,
+                   const std::map<std::string, std::string>& consulta,
+                   std::map<std::string, std::string>& evidencia) {
+    auto nombresNodos = red.obtenerNombresNodos();
+    
+    std::cout << "¿Qué variables ha observado (evidencia)?\n";
+    std::cout << "(Presione 0 si no tiene evidencia)\n\n";
+    std::cout << "¿Cuántas variables de evidencia? ";
+    int numEvidencia;
+    std::cin >> numEvidencia;
+    
+    if (numEvidencia < 0 || numEvidencia >= (int)nombresNodos.size()) {
+        std::cout << "\n❌ Número inválido de variables.\n";
+        return false;
+    }
+    
+    for (int i = 0; i < numEvidencia; i++) {
+        std::cout << "\n--- Variable de evidencia " << (i+1) << " ---\n";
+        std::cout << "Nombre de la variable: ";
+        std::string variable;
+        std::cin >> variable;
+        
+        // No puede ser una variable de consulta
+        if (consulta.find(variable) != consulta.end()) {
+            std::cout << "❌ Error: '" << variable << "' ya está en la consulta.\n";
+            i--;
+            continue;
+        }
+        
+        auto nodo = red.obtenerNodo(variable);
+        if (!nodo) {
+            std::cout << "❌ Error: Variable '" << variable << "' no encontrada.\n";
+            i--;
+            continue;
+        }
+        
+        std::cout << "Dominio de " << variable << ": {";
+        const auto& dominio = nodo->getDominio();
+        for (size_t j = 0; j < dominio.size(); j++) {
+            std::cout << dominio[j];
+            if (j < dominio.size() - 1) std::cout << ", ";
+        }
+        std::cout << "}\n";
+        
+        std::cout << "Valor observado: ";
+        std::string valor;
+        std::cin >> valor;
+        
+        // Validar que el valor esté en el dominio
+        if (std::find(dominio.begin(), dominio.end(), valor) == dominio.end()) {
+            std::cout << "⚠️  Advertencia: '" << valor << "' no está en el dominio.\n";
+            std::cout << "¿Continuar de todas formas? (s/n): ";
+            char resp;
+            std::cin >> resp;
+            if (resp != 's' && resp != 'S') {
+                i--;
+                continue;
+            }
+        }
+        
+        evidencia[variable] = valor;
+    }
+    
+    return true;
+}
+
+void inferenciaPersonalizada(const RedBayesiana& red, bool conTraza = true) {
     std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
     std::cout << "║              INFERENCIA PERSONALIZADA             ║\n";
     std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
@@ -150,7 +261,7 @@ void inferenciaPersonalizada(RedBayesiana& red, bool conTraza = true) {
         auto nodo = red.obtenerNodo(nombre);
         if (nodo) {
             std::cout << "• " << nombre << " ∈ {";
-            auto dominio = nodo->getDominio();
+            const auto& dominio = nodo->getDominio();
             for (size_t i = 0; i < dominio.size(); i++) {
                 std::cout << dominio[i];
                 if (i < dominio.size() - 1) std::cout << ", ";
@@ -194,7 +305,7 @@ void inferenciaPersonalizada(RedBayesiana& red, bool conTraza = true) {
         }
         
         std::cout << "Dominio de " << variable << ": {";
-        auto dominio = nodo->getDominio();
+        const auto& dominio = nodo->getDominio();
         for (size_t j = 0; j < dominio.size(); j++) {
             std::cout << dominio[j];
             if (j < dominio.size() - 1) std::cout << ", ";
@@ -222,64 +333,10 @@ void inferenciaPersonalizada(RedBayesiana& red, bool conTraza = true) {
     
     // ========== EVIDENCIA ==========
     std::cout << "\n╔══════════════ PASO 2: EVIDENCIA ══════════════╗\n";
-    std::cout << "¿Qué variables ha observado (evidencia)?\n";
-    std::cout << "(Presione 0 si no tiene evidencia)\n\n";
-    std::cout << "¿Cuántas variables de evidencia? ";
-    int numEvidencia;
-    std::cin >> numEvidencia;
-    
-    if (numEvidencia < 0 || numEvidencia >= (int)nombresNodos.size()) {
-        std::cout << "\n❌ Número inválido de variables.\n";
+    if (!leerEvidencia(red, consulta, evidencia)) {
         return;
     }
     
-    for (int i = 0; i < numEvidencia; i++) {
-        std::cout << "\n--- Variable de evidencia " << (i+1) << " ---\n";
-        std::cout << "Nombre de la variable: ";
-        std::string variable;
-        std::cin >> variable;
-        
-        // No puede ser una variable de consulta
-        if (consulta.find(variable) != consulta.end()) {
-            std::cout << "❌ Error: '" << variable << "' ya está en la consulta.\n";
-            i--;
-            continue;
-        }
-        
-        auto nodo = red.obtenerNodo(variable);
-        if (!nodo) {
-            std::cout << "❌ Error: Variable '" << variable << "' no encontrada.\n";
-            i--;
-            continue;
-        }
-        
-        std::cout << "Dominio de " << variable << ": {";
-        auto dominio = nodo->getDominio();
-        for (size_t j = 0; j < dominio.size(); j++) {
-            std::cout << dominio[j];
-            if (j < dominio.size() - 1) std::cout << ", ";
-        }
-        std::cout << "}\n";
-        
-        std::cout << "Valor observado: ";
-        std::string valor;
-        std::cin >> valor;
-        
-        // Validar que el valor esté en el dominio
-        if (std::find(dominio.begin(), dominio.end(), valor) == dominio.end()) {
-            std::cout << "⚠️  Advertencia: '" << valor << "' no está en el dominio.\n";
-            std::cout << "¿Continuar de todas formas? (s/n): ";
-            char resp;
-            std::cin >> resp;
-            if (resp != 's' && resp != 'S') {
-                i--;
-                continue;
-            }
-        }
-        
-        evidencia[variable] = valor;
-    }
-    
     // ========== CONFIRMAR ==========
     std::cout << "\n╔═══════════════ CONFIRMACIÓN ══════════════════╗\n";
     std::cout << "Consulta: P(";
@@ -312,19 +369,164 @@ void inferenciaPersonalizada(RedBayesiana& red, bool conTraza = true) {
         if (conTraza) {
             red.inferenciaConTraza(consulta, evidencia);
         } else {
-            double resultado = red.inferencia(consulta, evidencia);
+            std::cout << "Método de inferencia:\n";
+            std::cout << "  1. Enumeración\n";
+            std::cout << "  2. Eliminación de variables\n";
+            std::cout << "  3. Enumeración paralela (" << red.getNumeroHilos() << " hilos)\n";
+            std::cout << "  4. Ponderación por verosimilitud (aproximada)\n";
+            std::cout << "  5. Muestreo de Gibbs (aproximada, MCMC)\n";
+            std::cout << "  6. Enumeración recursiva (comparte prefijos)\n";
+            std::cout << "Seleccione [1]: ";
+            int opcionMetodo;
+            std::cin >> opcionMetodo;
+            
+            if (opcionMetodo == 4) {
+                std::cout << "Número de muestras: ";
+                unsigned long long numMuestras;
+                std::cin >> numMuestras;
+                
+                EstimacionAproximada estimacion = red.inferenciaAproximada(consulta, evidencia, numMuestras);
+                std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
+                std::cout << "║              RESULTADO (APROXIMADO)               ║\n";
+                std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+                std::cout << "Probabilidad     ≈ " << std::fixed << std::setprecision(6) << estimacion.probabilidad << "\n";
+                std::cout << "Error estándar   = " << std::fixed << std::setprecision(6) << estimacion.errorEstandar << "\n";
+                std::cout << "Tamaño efectivo  = " << std::fixed << std::setprecision(1) << estimacion.tamanoEfectivo
+                          << " de " << estimacion.muestras << " muestras\n\n";
+                return;
+            }
+            
+            if (opcionMetodo == 5) {
+                ConfiguracionGibbs config;
+                std::cout << "Número de cadenas: ";
+                std::cin >> config.numCadenas;
+                std::cout << "Muestras por cadena: ";
+                std::cin >> config.muestras;
+                std::cout << "Barridos de calentamiento (burn-in): ";
+                std::cin >> config.burnIn;
+                
+                EstimacionGibbs estimacion = red.inferenciaGibbs(consulta, evidencia, config);
+                std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
+                std::cout << "║              RESULTADO (APROXIMADO)               ║\n";
+                std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+                std::cout << "Probabilidad     ≈ " << std::fixed << std::setprecision(6) << estimacion.probabilidad << "\n";
+                std::cout << "Error estándar   = " << std::fixed << std::setprecision(6) << estimacion.errorEstandar << "\n";
+                if (std::isnan(estimacion.rHat)) {
+                    std::cout << "R-hat            = (requiere al menos 2 cadenas)\n";
+                } else {
+                    std::cout << "R-hat            = " << std::fixed << std::setprecision(4) << estimacion.rHat;
+                    if (estimacion.rHat > 1.1) std::cout << "  ⚠️  las cadenas no han convergido";
+                    std::cout << "\n";
+                }
+                std::cout << "Muestras         = " << estimacion.muestras << "\n\n";
+                return;
+            }
+            
+            MetodoInferencia metodo = MetodoInferencia::ENUMERACION;
+            if (opcionMetodo == 2) {
+                metodo = MetodoInferencia::ELIMINACION_VARIABLES;
+            } else if (opcionMetodo == 3) {
+                metodo = MetodoInferencia::ENUMERACION_PARALELA;
+            } else if (opcionMetodo == 6) {
+                metodo = MetodoInferencia::ENUMERACION_RECURSIVA;
+            }
+            
+            double resultado = red.inferencia(consulta, evidencia, metodo);
             std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
             std::cout << "║                    RESULTADO                      ║\n";
             std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
             std::cout << "Probabilidad = " << std::fixed << std::setprecision(6) << resultado << "\n";
             std::cout << "             = " << std::fixed << std::setprecision(2) << (resultado * 100) << "%\n\n";
+            
+            std::vector<std::string> variablesConsulta;
+            for (const auto& par : consulta) variablesConsulta.push_back(par.first);
+            std::vector<std::string> esteriles, separados;
+            if (red.getPodaRelevancia() &&
+                red.nodosPodados(variablesConsulta, evidencia, esteriles, separados)) {
+                std::cout << "Nodos podados: " << esteriles.size() << " estériles, "
+                          << separados.size() << " d-separados\n\n";
+            }
+            
+            EstadisticasCache estadisticas = red.getEstadisticasCache();
+            std::cout << "Caché de consultas: " << estadisticas.aciertos << " aciertos, "
+                      << estadisticas.fallos << " fallos, " << estadisticas.desalojos
+                      << " desalojos, " << estadisticas.entradas << " entradas\n\n";
         }
     } else {
         std::cout << "\n❌ Inferencia cancelada.\n";
     }
 }
 
-bool cargarRed(RedBayesiana& red, std::string& nombreEstructura, std::string& nombreProbabilidades) {
+void mostrarMarginales(ContenedorRed& contenedor) {
+    std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
+    std::cout << "║        MARGINALES DE TODOS LOS NODOS              ║\n";
+    std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+    
+    // Las versiones publicadas no cambian: se compila una copia (con nodos
+    // propios) y se publica, salvo que mientras tanto se haya cargado otra red
+    std::shared_ptr<const RedBayesiana> version = contenedor.actual();
+    if (!version->estaCompilada()) {
+        std::shared_ptr<RedBayesiana> compilada = std::make_shared<RedBayesiana>(*version);
+        compilada->compilar();
+        contenedor.reemplazar(version, compilada);
+        version = compilada;
+    }
+    const RedBayesiana& red = *version;
+    
+    std::map<std::string, std::string> evidencia;
+    if (!leerEvidencia(red, std::map<std::string, std::string>(), evidencia)) {
+        return;
+    }
+    
+    auto marginales = red.marginales(evidencia);
+    
+    std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    for (const auto& par : marginales) {
+        auto dominio = red.obtenerNodo(par.first)->getDominio();
+        std::cout << par.first << (evidencia.count(par.first) ? " (observado)" : "") << "\n";
+        for (size_t i = 0; i < par.second.size(); i++) {
+            std::cout << "   " << std::setw(12) << dominio[i] << " : "
+                      << std::fixed << std::setprecision(4) << par.second[i] << "\n";
+        }
+    }
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+}
+
+void mostrarEstadisticas(const RedBayesiana& red) {
+    std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
+    std::cout << "║          ESTADÍSTICAS DE INFERENCIA               ║\n";
+    std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
+    
+    if (!RegistroInferencia::habilitado()) {
+        std::cout << "Las estadísticas no están compiladas en este programa.\n";
+        std::cout << "Compile con: make clean && make ESTADISTICAS=1\n";
+        return;
+    }
+    
+    auto mostrar = [](const char* titulo, const EstadisticasInferencia& e) {
+        std::cout << titulo << " (" << e.consultas << " consultas)\n";
+        std::cout << "  Asignaciones de ocultas : " << e.asignacionesOcultas << "\n";
+        std::cout << "  Lecturas de tablas      : " << e.consultasTabla << "\n";
+        std::cout << "  Reservas en la arena    : " << e.reservasArena << "\n";
+        std::cout << "  Reservas al sistema     : " << e.reservasSistema << "\n";
+        double total = e.segundosTotales();
+        std::cout << "  Tiempo por fase:\n";
+        for (size_t f = 0; f < NUM_FASES_INFERENCIA; f++) {
+            std::cout << "    " << std::fixed << std::setprecision(3) << std::setw(10)
+                      << e.segundosFase[f] * 1000.0 << " ms  " << std::setprecision(1) << std::setw(5)
+                      << (total > 0.0 ? 100.0 * e.segundosFase[f] / total : 0.0) << "%  "
+                      << EstadisticasInferencia::nombreFase(f) << "\n";
+        }
+        std::cout << "    " << std::fixed << std::setprecision(3) << std::setw(10)
+                  << total * 1000.0 << " ms  Total\n\n";
+    };
+    
+    mostrar("ÚLTIMA INFERENCIA", red.getEstadisticasUltimaInferencia());
+    mostrar("ACUMULADO", red.getEstadisticasInferencia());
+    std::cout << "(Los aciertos de la caché de consultas no se miden)\n";
+}
+
+void pedirArchivos(std::string& nombreEstructura, std::string& nombreProbabilidades) {
     std::cout << "\n╔═══════════════════════════════════════════════════╗\n";
     std::cout << "║              CARGAR RED BAYESIANA                 ║\n";
     std::cout << "╚═══════════════════════════════════════════════════╝\n\n";
@@ -336,41 +538,212 @@ bool cargarRed(RedBayesiana& red, std::string& nombreEstructura, std::string& no
         nombreEstructura = nuevaEstructura;
     }
     
+    // Una imagen binaria compilada o una red BIF o UAI ya contienen las probabilidades
+    if (ImagenRed::esImagen(nombreEstructura) || ImportadorRed::esImportable(nombreEstructura)) {
+        return;
+    }
+    
     std::cout << "Nombre del archivo de probabilidades [" << nombreProbabilidades << "]: ";
     std::string nuevasProbabilidades;
     std::getline(std::cin, nuevasProbabilidades);
     if (!nuevasProbabilidades.empty()) {
         nombreProbabilidades = nuevasProbabilidades;
     }
+}
+
+/**
+ * Carga una red nueva (texto, imagen .rbi, BIF o UAI)
+ * @return La red cargada, o nulo si hubo un error (se informa en cerr)
+ */
+std::shared_ptr<RedBayesiana> construirRed(const std::string& nombreEstructura,
+                                           const std::string& nombreProbabilidades) {
+    std::shared_ptr<RedBayesiana> red = std::make_shared<RedBayesiana>();
+    
+    if (ImagenRed::esImagen(nombreEstructura)) {
+        std::cout << "\nCargando imagen " << nombreEstructura << "...\n";
+        if (!red->cargarImagen(nombreEstructura)) {
+            std::cerr << "\n❌ Error al cargar la imagen.\n";
+            return nullptr;
+        }
+    } else if (ImportadorRed::esImportable(nombreEstructura)) {
+        std::cout << "\nImportando " << nombreEstructura << "...\n";
+        if (!red->importarRed(nombreEstructura)) {
+            std::cerr << "\n❌ Error al importar la red.\n";
+            return nullptr;
+        }
+    } else {
+        std::cout << "\nCargando " << nombreEstructura << "...\n";
+        if (!red->cargarEstructura(nombreEstructura)) {
+            std::cerr << "\n❌ Error al cargar estructura.\n";
+            return nullptr;
+        }
+        
+        std::cout << "Cargando " << nombreProbabilidades << "...\n";
+        if (!red->cargarProbabilidades(nombreProbabilidades)) {
+            std::cerr << "\n❌ Error al cargar probabilidades.\n";
+            return nullptr;
+        }
+    }
     
-    std::cout << "\nCargando " << nombreEstructura << "...\n";
-    if (!red.cargarEstructura(nombreEstructura)) {
-        std::cerr << "\n❌ Error al cargar estructura.\n";
-        return false;
+    std::cout << "\n✓ Red cargada exitosamente!\n";
+    return red;
+}
+
+void mostrarUsoLote() {
+    std::cerr << "Uso por lotes:\n";
+    std::cerr << "  red_bayesiana --estructura ARCHIVO [--probabilidades ARCHIVO]\n";
+    std::cerr << "                [--consultas ARCHIVO|-] [--metodo NOMBRE]\n";
+    std::cerr << "                [--muestras N] [--semilla N] [--hilos N]\n";
+    std::cerr << "  red_bayesiana --estructura ARCHIVO [--probabilidades ARCHIVO]\n";
+    std::cerr << "                --servidor RUTA_SOCKET [--metodo NOMBRE] [--hilos N]\n";
+    std::cerr << "  red_bayesiana --ayuda | --help | -h\n\n";
+    std::cerr << "  --estructura      estructura.txt, o una red completa .bif, .uai o .rbi\n";
+    std::cerr << "  --probabilidades  probabilidades.txt (por defecto: probabilidades.txt)\n";
+    std::cerr << "  --consultas       una consulta por línea; '-' lee la entrada estándar (por defecto)\n";
+    std::cerr << "  --metodo          enumeracion, eliminacion, paralela, recursiva, ponderacion o gibbs\n";
+    std::cerr << "  --muestras        muestras de los métodos aproximados (Gibbs: por cadena)\n";
+    std::cerr << "  --hilos           hilos para repartir consultas (0 = todos los núcleos)\n";
+    std::cerr << "  --servidor        atiende consultas en un socket Unix hasta recibir SIGINT o SIGTERM;\n";
+    std::cerr << "                    la línea METRICAS devuelve consultas por segundo y latencias;\n";
+    std::cerr << "                    la línea RECARGAR o SIGHUP vuelven a cargar los archivos sin detenerse\n\n";
+    std::cerr << "Formato de consulta:  Train=delayed | Rain=heavy Maintenance=yes\n";
+    std::cerr << "Cada respuesta es una línea JSON: {\"linea\":1,\"probabilidad\":0.32}\n";
+}
+
+void manejarSenal(int senal) {
+    if (senal == SIGHUP) {
+        ServidorInferencia::solicitarRecarga();
+    } else {
+        ServidorInferencia::solicitarDetencion();
+    }
+}
+
+/**
+ * Modo por lotes: carga la red y responde consultas sin menú ni traza
+ * Los mensajes de la biblioteca se descartan; solo las respuestas JSON
+ * van a la salida estándar y los errores de carga a la de errores
+ */
+int ejecutarLote(int argc, char* argv[]) {
+    std::string archivoEstructura;
+    std::string archivoProbabilidades = "probabilidades.txt";
+    std::string archivoConsultas = "-";
+    std::string rutaSocket;
+    OpcionesConsulta opciones;
+    
+    // Todas las opciones salvo la ayuda llevan un valor
+    const std::vector<std::string> opcionesConValor = {
+        "--estructura", "--probabilidades", "--consultas", "--servidor",
+        "--metodo", "--muestras", "--semilla", "--hilos"
+    };
+    
+    for (int i = 1; i < argc; i++) {
+        std::string opcion = argv[i];
+        if (opcion == "--ayuda" || opcion == "--help" || opcion == "-h") {
+            mostrarUsoLote();
+            return 0;
+        }
+        if (std::find(opcionesConValor.begin(), opcionesConValor.end(), opcion) == opcionesConValor.end()) {
+            std::cerr << "Error: Opción desconocida " << opcion << "\n\n";
+            mostrarUsoLote();
+            return 1;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Error: Falta el valor de " << opcion << "\n";
+            return 1;
+        }
+        std::string valor = argv[++i];
+        if (opcion == "--estructura") {
+            archivoEstructura = valor;
+        } else if (opcion == "--probabilidades") {
+            archivoProbabilidades = valor;
+        } else if (opcion == "--consultas") {
+            archivoConsultas = valor;
+        } else if (opcion == "--servidor") {
+            rutaSocket = valor;
+        } else if (opcion == "--metodo") {
+            if (!ProcesadorConsultas::motorDesdeNombre(valor, opciones.motor)) {
+                std::cerr << "Error: Método desconocido " << valor << "\n";
+                return 1;
+            }
+        } else if (opcion == "--muestras") {
+            opciones.muestras = std::strtoull(valor.c_str(), nullptr, 10);
+        } else if (opcion == "--semilla") {
+            opciones.semilla = std::strtoull(valor.c_str(), nullptr, 10);
+        } else if (opcion == "--hilos") {
+            opciones.numHilos = std::strtoull(valor.c_str(), nullptr, 10);
+        }
+    }
+    if (archivoEstructura.empty()) {
+        std::cerr << "Error: Falta --estructura\n\n";
+        mostrarUsoLote();
+        return 1;
     }
     
-    std::cout << "Cargando " << nombreProbabilidades << "...\n";
-    if (!red.cargarProbabilidades(nombreProbabilidades)) {
-        std::cerr << "\n❌ Error al cargar probabilidades.\n";
-        return false;
+    std::ios::sync_with_stdio(false);
+    std::ostream salida(std::cout.rdbuf());
+    std::streambuf* original = std::cout.rdbuf(nullptr);
+    
+    size_t numHilos = opciones.numHilos;
+    ContenedorRed::Constructor construir = [archivoEstructura, archivoProbabilidades, numHilos]() {
+        std::shared_ptr<RedBayesiana> red = construirRed(archivoEstructura, archivoProbabilidades);
+        if (red && numHilos > 0) red->setNumeroHilos(numHilos);
+        return red;
+    };
+    std::shared_ptr<RedBayesiana> inicial = construir();
+    if (!inicial) {
+        std::cout.rdbuf(original);
+        std::cerr << "Error: No se pudo cargar la red\n";
+        return 1;
+    }
+    ContenedorRed contenedor(inicial);
+    
+    if (!rutaSocket.empty()) {
+        ServidorInferencia servidor(contenedor, opciones, opciones.numHilos);
+        servidor.setConstructorRecarga(construir);
+        if (!servidor.escuchar(rutaSocket)) {
+            std::cout.rdbuf(original);
+            return 1;
+        }
+        std::signal(SIGINT, manejarSenal);
+        std::signal(SIGTERM, manejarSenal);
+        std::signal(SIGHUP, manejarSenal);
+        std::cerr << "Escuchando en " << rutaSocket << "\n";
+        servidor.ejecutar();
+        salida << servidor.metricasJson() << std::endl;
+        std::cout.rdbuf(original);
+        return 0;
     }
     
-    std::cout << "\n✓ Red cargada exitosamente!\n";
-    return true;
+    ProcesadorConsultas procesador(contenedor, opciones);
+    int codigo = 0;
+    if (archivoConsultas == "-") {
+        procesador.procesar(std::cin, salida);
+    } else if (procesador.procesarArchivo(archivoConsultas, salida) < 0) {
+        std::cerr << "Error: No se puede abrir " << archivoConsultas << "\n";
+        codigo = 1;
+    }
+    std::cout.rdbuf(original);
+    return codigo;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Con argumentos se trabaja por lotes, sin menú
+    if (argc > 1) {
+        return ejecutarLote(argc, argv);
+    }
+    
     std::cout << "╔════════════════════════════════════════════════════════╗\n";
     std::cout << "║   SISTEMA DE INFERENCIA CON REDES BAYESIANAS          ║\n";
     std::cout << "║   Versión Genérica - Compatible con cualquier red     ║\n";
     std::cout << "╚════════════════════════════════════════════════════════╝\n\n";
     
-    RedBayesiana red;
     std::string archivoEstructura = "estructura.txt";
     std::string archivoProbabilidades = "probabilidades.txt";
     
     // Cargar red inicial
-    if (!cargarRed(red, archivoEstructura, archivoProbabilidades)) {
+    pedirArchivos(archivoEstructura, archivoProbabilidades);
+    std::shared_ptr<RedBayesiana> inicial = construirRed(archivoEstructura, archivoProbabilidades);
+    if (!inicial) {
         std::cerr << "\n❌ No se pudo cargar la red inicial.\n";
         std::cerr << "Asegúrese de tener los archivos:\n";
         std::cerr << "  - estructura.txt\n";
@@ -378,11 +751,15 @@ int main() {
         return 1;
     }
     
+    ContenedorRed contenedor(inicial);
     pausar();
     
     // Menú interactivo
     int opcion;
     do {
+        // Cada opción trabaja con la versión publicada al elegirla
+        std::shared_ptr<const RedBayesiana> red = contenedor.actual();
+        
         limpiarPantalla();
         mostrarMenu();
         std::cin >> opcion;
@@ -390,35 +767,40 @@ int main() {
         
         switch(opcion) {
             case 1:
-                red.mostrarEstructura();
+                red->mostrarEstructura();
                 pausar();
                 break;
                 
             case 2:
-                red.mostrarTodasLasTablas();
+                red->mostrarTodasLasTablas();
                 pausar();
                 break;
                 
             case 3:
-                inferenciaPersonalizada(red, true);
+                inferenciaPersonalizada(*red, true);
                 pausar();
                 break;
                 
             case 4:
-                mostrarInformacionVariables(red);
+                mostrarInformacionVariables(*red);
                 pausar();
                 break;
                 
             case 5:
-                inferenciaPersonalizada(red, false);
+                inferenciaPersonalizada(*red, false);
                 pausar();
                 break;
                 
             case 6: {
-                RedBayesiana nuevaRed;
-                if (cargarRed(nuevaRed, archivoEstructura, archivoProbabilidades)) {
-                    red = nuevaRed;
-                }
+                pedirArchivos(archivoEstructura, archivoProbabilidades);
+                std::string estructura = archivoEstructura;
+                std::string probabilidades = archivoProbabilidades;
+                // La red nueva se construye aparte y se publica al terminar;
+                // el menú espera solo para que los mensajes de carga salgan en orden
+                contenedor.recargarEnSegundoPlano([estructura, probabilidades]() {
+                    return construirRed(estructura, probabilidades);
+                });
+                contenedor.esperarRecarga();
                 pausar();
                 break;
             }
@@ -429,6 +811,26 @@ int main() {
                 break;
                 
             case 8:
+                mostrarMarginales(contenedor);
+                pausar();
+                break;
+                
+            case 9: {
+                std::cout << "\nNombre del archivo de imagen [red.rbi]: ";
+                std::string archivoImagen;
+                std::getline(std::cin, archivoImagen);
+                if (archivoImagen.empty()) archivoImagen = "red.rbi";
+                red->exportarImagen(archivoImagen);
+                pausar();
+                break;
+            }
+                
+            case 10:
+                mostrarEstadisticas(*red);
+                pausar();
+                break;
+                
+            case 11:
                 std::cout << "\n╔════════════════════════════════════════════════════════╗\n";
                 std::cout << "║         ¡Gracias por usar el sistema!                  ║\n";
                 std::cout << "║         Red Bayesiana - Inferencia por Enumeración     ║\n";
@@ -436,11 +838,11 @@ int main() {
                 break;
                 
             default:
-                std::cout << "\n❌ Opción inválida. Por favor, seleccione 1-8.\n";
+                std::cout << "\n❌ Opción inválida. Por favor, seleccione 1-11.\n";
                 pausar();
         }
         
-    } while (opcion != 8);
+    } while (opcion != 11);
     
     return 0;
 }
\ No newline at end of file